@@ -27,8 +27,7 @@ App::App(std::string engine_directory)
 	  engine_settings(),
 	  project(this),
 	  state(engine_settings),
-	  audio_sample(nullptr),
-	  audio_state(SS_STOPPED),
+	  audio_preview(),
 	  is_running(true),
 	  engine_directory(std::move(engine_directory)) {
 //	SDL_AddTimer(docker_check_interval_error, &docker_check_callback, this);
@@ -99,12 +98,18 @@ bool App::OpenProject(const std::string &path) {
 		CloseProject();
 	}
 
-	return project.Open(path.c_str(), this);
+	if (!project.Open(path.c_str(), this))
+		return false;
+
+	asset_watcher.Start(project.project_settings.project_directory);
+
+	return true;
 }
 
 void App::CloseProject() {
 	console.AddLog("Closing Project...");
 
+	asset_watcher.Stop();
 	project.Close(this);
 	state = ProjectState(engine_settings);
 
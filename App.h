@@ -1,14 +1,18 @@
 #pragma once
 
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_mixer.h>
 
+#include "AssetWatcher.h"
+#include "CodeSizeReport.h"
+#include "EditorStats.h"
+#include "FrameProfiler.h"
 #include "ProjectState.h"
+#include "RomSizeReport.h"
+#include "TextureResidency.h"
 #include "settings/EngineSettings.h"
 #include "settings/Project.h"
 #include "GUIImage.h"
-
-enum SoundState { SS_STOPPED, SS_PLAYING, SS_PAUSED };
+#include "audio/AudioPreview.h"
 
 struct EngineVersion {
 	int major;
@@ -36,9 +40,7 @@ class App {
 	ProjectState state;
 	SDL_Texture *app_texture;
 
-	// audio
-	Mix_Chunk *audio_sample;
-	SoundState audio_state;
+	AudioPreview audio_preview;
 
 	const char *default_title = "NGine - N64 Engine Powered by Libdragon";
 
@@ -46,6 +48,13 @@ class App {
 
 	SDL_TimerID docker_check_timer;
 
+	AssetWatcher asset_watcher;
+	EditorStats stats;
+	RomSizeReport rom_report;
+	CodeSizeReport code_report;
+	FrameProfiler profiler;
+	TextureResidency textures;
+
 	explicit App(std::string engine_directory);
 
 	bool LoadAssets();
@@ -2,7 +2,10 @@
 
 #include <cmath>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
 
 #include "imgui.h"
 #include "imgui_custom.h"
@@ -17,7 +20,11 @@
 #include "LibdragonLDtkMap.h"
 #include "ProjectBuilder.h"
 #include "ScriptBuilder.h"
+#include "Sdl.h"
+#include "SpriteTmem.h"
 #include "ThreadCommand.h"
+#include "audio/SoundProcessor.h"
+#include "generated/generated.h"
 
 static int window_width, window_height;
 static bool is_output_open = true;
@@ -32,6 +39,7 @@ enum AssetsDisplayType { ADT_LIST, ADT_GRID };
 static AssetsDisplayType asset_display_type = ADT_LIST;
 
 static bool help_window_unfloader_active = false;
+static bool tmem_report_active = false;
 
 void AppGui::Update(App &app) {
 	SDL_GetWindowSize(app.window, &window_width, &window_height);
@@ -45,6 +53,11 @@ void AppGui::Update(App &app) {
 
 	console.Draw("Output", app.window, is_output_open);
 
+	app.stats.Draw(app);
+	app.rom_report.Draw(app);
+	app.code_report.Draw(app);
+	app.profiler.Draw(app);
+
 	if (app.project.project_settings.IsOpen()) {
 		RenderContentBrowser(app);
 		RenderSceneWindow(app);
@@ -199,6 +212,8 @@ void AppGui::ProcessImportFile(App &app, std::string file_path) {
 
 		int w, h;
 		SDL_QueryTexture(dropped_image.image_data, nullptr, nullptr, &w, &h);
+		dropped_image.image_width = w;
+		dropped_image.image_height = h;
 
 		const float max_size = 300.f;
 		if (w > h) {
@@ -214,10 +229,6 @@ void AppGui::ProcessImportFile(App &app, std::string file_path) {
 		dropped_image.w = w;
 		dropped_image.h = h;
 
-		dropped_image.image_data_overlay = SDL_CreateTexture(
-			app.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w * 2, h * 2);
-		SDL_SetTextureBlendMode(dropped_image.image_data_overlay, SDL_BLENDMODE_BLEND);
-
 		app.state.dropped_image_files.push_back(dropped_image);
 
 		ImGui::SetWindowFocus("Import Assets");
@@ -349,8 +360,91 @@ void render_help_window_unfloader() {
 	ImGui::End();
 }
 
+void render_tmem_report(App &app) {
+	if (!tmem_report_active || !app.project.project_settings.IsOpen())
+		return;
+
+	static bool only_multiple_loads = true;
+
+	ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("TMEM Report", &tmem_report_active)) {
+		const int default_bits =
+			app.project.project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32;
+
+		struct SpriteTmemRow {
+			const LibdragonImage *image;
+			TmemUsage usage;
+		};
+		std::vector<SpriteTmemRow> rows;
+		int multiple_loads_count = 0;
+		for (auto &image : app.project.images) {
+			TmemUsage usage = get_sprite_tmem_usage(
+				image->width, image->height, image->h_slices, image->v_slices,
+				get_libdragon_sprite_format_bits(image->format, default_bits),
+				is_libdragon_sprite_format_indexed(image->format));
+			if (!usage.Fits())
+				++multiple_loads_count;
+			if (usage.Fits() && only_multiple_loads)
+				continue;
+
+			rows.push_back({image.get(), usage});
+		}
+		std::sort(rows.begin(), rows.end(), [](const SpriteTmemRow &a, const SpriteTmemRow &b) {
+			return a.usage.loads > b.usage.loads;
+		});
+
+		ImGui::Text("%d of %d sprites need more than one TMEM load per frame.",
+					multiple_loads_count, (int)app.project.images.size());
+		ImGui::Checkbox("Only sprites that need more than one load", &only_multiple_loads);
+
+		if (ImGui::BeginTable("TmemReport", 6,
+							  ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+								  ImGuiTableFlags_ScrollY)) {
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Sprite");
+			ImGui::TableSetupColumn("Frame");
+			ImGui::TableSetupColumn("Bits");
+			ImGui::TableSetupColumn("Bytes");
+			ImGui::TableSetupColumn("Loads");
+			ImGui::TableSetupColumn("Suggested Slices");
+			ImGui::TableHeadersRow();
+
+			for (auto &row : rows) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(row.image->name.c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%dx%d", row.usage.frame_width, row.usage.frame_height);
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", row.usage.bits);
+				ImGui::TableNextColumn();
+				ImGui::Text("%d / %d", row.usage.bytes, row.usage.limit);
+				ImGui::TableNextColumn();
+				if (row.usage.Fits())
+					ImGui::Text("%d", row.usage.loads);
+				else
+					ImGui::TextColored(color_invalid_input, "%d", row.usage.loads);
+				ImGui::TableNextColumn();
+				if (!row.usage.Fits()) {
+					std::string suggestions_text;
+					for (auto &suggestion : suggest_tmem_slices(
+							 row.image->width, row.image->height, row.usage.bits,
+							 is_libdragon_sprite_format_indexed(row.image->format))) {
+						suggestions_text += std::to_string(suggestion.h_slices) + "x" +
+											std::to_string(suggestion.v_slices) + " ";
+					}
+					ImGui::TextUnformatted(suggestions_text.c_str());
+				}
+			}
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
+}
+
 void AppGui::RenderMenuBar(App &app) {
 	render_help_window_unfloader();
+	render_tmem_report(app);
 
 	if (ImGui::BeginMainMenuBar()) {
 		if (ImGui::BeginMenu("File")) {
@@ -448,6 +542,18 @@ void AppGui::RenderMenuBar(App &app) {
 
 			ImGui::EndMenu();
 		}
+		if (ImGui::BeginMenu("View")) {
+			ImGui::MenuItem("Performance Stats", nullptr, &app.stats.is_open);
+			ImGui::MenuItem("TMEM Report", nullptr, &tmem_report_active,
+							app.project.project_settings.IsOpen());
+			ImGui::MenuItem("ROM Size Report", nullptr, &app.rom_report.is_open,
+							app.project.project_settings.IsOpen());
+			ImGui::MenuItem("Code Size Report", nullptr, &app.code_report.is_open,
+							app.project.project_settings.IsOpen());
+			ImGui::MenuItem("Frame Profiler", nullptr, &app.profiler.is_open,
+							app.project.project_settings.IsOpen());
+			ImGui::EndMenu();
+		}
 		if (ImGui::BeginMenu("About")) {
 			ImGui::MenuItem(app.engine_version.version_string.c_str(), nullptr, false, false);
 			if (ImGui::MenuItem(app.engine_settings.GetLibdragonVersion().c_str(), nullptr, false,
@@ -620,6 +726,7 @@ void set_up_popup_windows(App &app) {
 			}
 		}
 		if (app.state.asset_selected.Type() == TILED_MAP) {
+			(*app.state.asset_selected.Ref().tiled)->EnsureLayersLoaded();
 			for (auto &layer : (*app.state.asset_selected.Ref().tiled)->layers) {
 				ImGui::PushID(layer.name.c_str());
 				std::string dfs_label = "Copy '" + layer.name + "' DFS Path";
@@ -652,6 +759,7 @@ void set_up_popup_windows(App &app) {
 			}
 		}
 		if (app.state.asset_selected.Type() == LDTK_MAP) {
+			(*app.state.asset_selected.Ref().ldtk)->EnsureLayersLoaded();
 			for (auto &layer : (*app.state.asset_selected.Ref().ldtk)->layers) {
 				ImGui::PushID(layer.name.c_str());
 				std::string dfs_label = "Copy '" + layer.name + "' DFS Path";
@@ -993,7 +1101,7 @@ void render_asset_folder_grid(App &app, Asset *folder) {
 						}
 						if (ImGui::ImageButton(
 								(ImTextureID)(intptr_t)((*asset.GetAssetReference().image)
-															->loaded_image),
+															->thumbnail),
 								ImVec2(80, 80))) {
 							app.state.asset_selected.Ref(IMAGE, asset.GetAssetReference());
 							app.state.asset_editing = app.state.asset_selected;
@@ -1219,7 +1327,7 @@ void render_asset_folder_grid(App &app, Asset *folder) {
 						}
 						if (ImGui::ImageButton(
 								(ImTextureID)(intptr_t)((*asset.GetAssetReference().font)
-															->loaded_image),
+															->thumbnail),
 								ImVec2(80, 80))) {
 							app.state.asset_selected.Ref(FONT, asset.GetAssetReference());
 							app.state.asset_editing = app.state.asset_selected;
@@ -1372,7 +1480,115 @@ void render_asset_folder_grid(App &app, Asset *folder) {
 	}
 }
 
+// the sprite being edited converted to its format, rebuilt when the format changes
+static SDL_Texture *sprite_format_preview = nullptr;
+
+// quantizing is too slow for the UI thread, the surface is converted on a thread and only the
+// one of the latest refresh is kept
+static std::mutex sprite_format_preview_mutex;
+static int sprite_format_preview_generation = 0;
+static SDL_Surface *sprite_format_preview_surface = nullptr;
+
+static void refresh_sprite_format_preview(App &app, const LibdragonImage &image) {
+	if (sprite_format_preview) {
+		SDL_DestroyTexture(sprite_format_preview);
+		sprite_format_preview = nullptr;
+	}
+
+	const int default_bits = app.project.project_settings.display.bit_depth == DEPTH_16_BPP ? 16
+																							 : 32;
+	std::string project_directory = app.project.project_settings.project_directory;
+	SpriteFormatSource source = image.GetFormatSource(app.project.images);
+
+	int generation;
+	{
+		std::lock_guard<std::mutex> lock(sprite_format_preview_mutex);
+		generation = ++sprite_format_preview_generation;
+		if (sprite_format_preview_surface) {
+			SDL_FreeSurface(sprite_format_preview_surface);
+			sprite_format_preview_surface = nullptr;
+		}
+	}
+
+	std::thread([project_directory, source, default_bits, generation]() {
+		SDL_Surface *surface = load_format_surface(project_directory, source, default_bits);
+
+		std::lock_guard<std::mutex> lock(sprite_format_preview_mutex);
+		if (generation != sprite_format_preview_generation) {
+			SDL_FreeSurface(surface);
+			return;
+		}
+		sprite_format_preview_surface = surface;
+		Sdl::WakeUp();
+	}).detach();
+}
+
+// uploads the surface converted by 'refresh_sprite_format_preview' once it is ready
+static void update_sprite_format_preview(App &app) {
+	std::lock_guard<std::mutex> lock(sprite_format_preview_mutex);
+	if (!sprite_format_preview_surface)
+		return;
+
+	if (sprite_format_preview)
+		SDL_DestroyTexture(sprite_format_preview);
+	sprite_format_preview =
+		SDL_CreateTextureFromSurface(app.renderer, sprite_format_preview_surface);
+	SDL_FreeSurface(sprite_format_preview_surface);
+	sprite_format_preview_surface = nullptr;
+}
+
+static void combo_bit_depth(const char *label, int &bit_depth) {
+	const char *bit_depth_items[] = {"8 bits", "16 bits"};
+	int bit_depth_current = bit_depth == 8 ? 0 : 1;
+	if (ImGui::Combo(label, &bit_depth_current, bit_depth_items, 2)) {
+		bit_depth = bit_depth_current == 0 ? 8 : 16;
+	}
+}
+
+// rom size of the wave sounds before and after processing, the headers are only read on 'refresh'
+static void get_sounds_size(App &app, bool refresh, Sint64 &source_size, Sint64 &built_size) {
+	static std::vector<WavInfo> infos;
+	if (refresh || infos.size() != app.project.sounds.size()) {
+		infos.assign(app.project.sounds.size(), WavInfo());
+		for (size_t i = 0; i < app.project.sounds.size(); ++i) {
+			if (app.project.sounds[i]->type == SOUND_WAV) {
+				read_wav_info(app.project.project_settings.project_directory + "/" +
+								  app.project.sounds[i]->sound_path,
+							  infos[i]);
+			}
+		}
+	}
+
+	source_size = 0;
+	built_size = 0;
+	for (size_t i = 0; i < infos.size(); ++i) {
+		SoundProcessOptions options =
+			app.project.sounds[i]->GetProcessOptions(app.project.project_settings.audio);
+		source_size += get_sound_size(infos[i], get_source_format(infos[i]));
+		built_size += get_sound_size(infos[i], get_processed_format(infos[i], options));
+	}
+}
+
+static std::string get_converted_sound_path(const App &app, const LibdragonSound &sound) {
+	return app.project.project_settings.project_directory + "/build/filesystem" +
+		   sound.dfs_folder + sound.name + sound.GetLibdragonExtension();
+}
+
+static void open_sound_preview(App &app, const LibdragonSound &sound, bool converted) {
+	if (converted) {
+		app.audio_preview.OpenWav64(get_converted_sound_path(app, sound));
+	} else {
+		app.audio_preview.Open(
+			app.project.project_settings.project_directory + "/" + sound.sound_path, sound.type);
+	}
+}
+
 void render_asset_details_window(App &app) {
+	// sounds keep their file open while previewed
+	if (app.state.asset_editing.Type() != SOUND && app.audio_preview.IsOpen()) {
+		app.audio_preview.Close();
+	}
+
 	ImVec2 position = ImGui::GetWindowPos();
 	ImVec2 size = ImGui::GetWindowSize();
 
@@ -1468,6 +1684,12 @@ void render_asset_details_window(App &app) {
 			static char image_edit_dfs_folder[100];
 			static int image_edit_h_slices = 0;
 			static int image_edit_v_slices = 0;
+			static char image_edit_palette_group[50];
+			static char image_edit_atlas_group[50];
+			static SpriteTrim image_edit_trim;
+			// slices 'image_edit_trim' was computed with, -1 when it has to be computed again
+			static int image_edit_trim_h_slices = -1;
+			static int image_edit_trim_v_slices = -1;
 			if (app.state.reload_asset_edit) {
 				app.state.reload_asset_edit = false;
 
@@ -1475,45 +1697,121 @@ void render_asset_details_window(App &app) {
 				strcpy(image_edit_dfs_folder, (*image)->dfs_folder.c_str());
 				image_edit_h_slices = (*image)->h_slices;
 				image_edit_v_slices = (*image)->v_slices;
+				strcpy(image_edit_palette_group, (*image)->palette_group.c_str());
+				strcpy(image_edit_atlas_group, (*image)->atlas_group.c_str());
+				image_edit_trim_h_slices = -1;
+				image_edit_trim_v_slices = -1;
 
-				(*image)->RecreateOverlay(app.renderer, image_edit_h_slices, image_edit_v_slices);
+				refresh_sprite_format_preview(app, **image);
 			}
+			update_sprite_format_preview(app);
 			if (ImGui::Begin("Details", nullptr,
 							 ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse)) {
 				if (ImGui::BeginTable("Assets", 2)) {
 					ImGui::TableNextRow();
 
 					ImGui::TableNextColumn();
-					ImGui::Image((ImTextureID)(intptr_t)((*image)->loaded_image),
+					ImGui::Image((ImTextureID)(intptr_t)((*image)->thumbnail),
 								 ImVec2((*image)->display_width, (*image)->display_height));
+					render_slices_overlay(image_edit_h_slices, image_edit_v_slices);
 					if (ImGui::IsItemHovered()) {
 						ImGui::BeginTooltip();
-						ImGui::Image((ImTextureID)(intptr_t)((*image)->loaded_image),
-									 ImVec2((*image)->width, (*image)->height));
-						ImGui::SamePlace(8);
-						ImGui::Image((ImTextureID)(intptr_t)(*image)->loaded_image_overlay,
+						ImGui::Image((ImTextureID)(intptr_t)(*image)->GetFullImage(),
 									 ImVec2((*image)->width, (*image)->height));
+						render_slices_overlay(image_edit_h_slices, image_edit_v_slices);
 						ImGui::EndTooltip();
 					}
-					ImGui::SamePlace(8);
-					ImGui::Image((ImTextureID)(intptr_t)(*image)->loaded_image_overlay,
-								 ImVec2((*image)->display_width, (*image)->display_height));
+
+					if (sprite_format_preview) {
+						ImGui::TextUnformatted("On the console:");
+						ImGui::Image((ImTextureID)(intptr_t)sprite_format_preview,
+									 ImVec2((*image)->display_width, (*image)->display_height));
+						if (ImGui::IsItemHovered()) {
+							ImGui::BeginTooltip();
+							ImGui::Image((ImTextureID)(intptr_t)sprite_format_preview,
+										 ImVec2((*image)->width, (*image)->height));
+							ImGui::EndTooltip();
+						}
+					}
 
 					ImGui::TableNextColumn();
 					ImGui::InputText("Name", image_edit_name, 50,
 									 ImGuiInputTextFlags_CharsFileName);
 					bool dfs_valid = input_text_dfs_folder(image_edit_dfs_folder, 100);
 
-					bool recreate_grid = false;
-					if (ImGui::InputInt("H Slices", &image_edit_h_slices)) {
-						recreate_grid = true;
+					ImGui::InputInt("H Slices", &image_edit_h_slices);
+					ImGui::InputInt("V Slices", &image_edit_v_slices);
+
+					ImGui::InputText("Atlas Group", image_edit_atlas_group, 50,
+									 ImGuiInputTextFlags_CharsFileName);
+					if (ImGui::IsItemHovered()) {
+						ImGui::SetTooltip(
+							"Sprites with the same group are packed on '/atlases/<group>.sprite' "
+							"and listed on 'atlas_sprites' (game.gen.h). The format is the one "
+							"of the display.");
+					}
+
+					if ((*image)->atlas_group.empty()) {
+						ImGui::Checkbox("Trim Transparent Borders", &(*image)->trim);
+						if (ImGui::IsItemHovered()) {
+							ImGui::SetTooltip(
+								"Crops every frame to its opaque pixels. The offsets are listed on "
+								"'sprite_<name>_trim' (game.gen.h).");
+						}
+					}
+
+					const char *format_items[] = {"Default", "RGBA16", "RGBA32", "CI8",
+												  "CI4",	 "IA8",	   "I4"};
+					int format_current = (*image)->format;
+					bool format_changed = false;
+					if (ImGui::Combo("Format", &format_current, format_items, 7)) {
+						(*image)->format = (LibdragonSpriteFormat)format_current;
+						format_changed = true;
+					}
+					if (is_libdragon_sprite_format_indexed((*image)->format)) {
+						ImGui::InputText("Palette Group", image_edit_palette_group, 50);
+						if (ImGui::IsItemDeactivatedAfterEdit()) {
+							(*image)->palette_group = image_edit_palette_group;
+							format_changed = true;
+						}
+						if (ImGui::IsItemHovered()) {
+							ImGui::SetTooltip(
+								"Sprites with the same group share one palette. Leave empty to "
+								"use a palette for this sprite only.");
+						}
+						format_changed |= ImGui::Checkbox("Dither", &(*image)->dither);
 					}
-					if (ImGui::InputInt("V Slices", &image_edit_v_slices)) {
-						recreate_grid = true;
+					if (format_changed) {
+						refresh_sprite_format_preview(app, **image);
 					}
-					if (recreate_grid) {
-						(*image)->RecreateOverlay(app.renderer, image_edit_h_slices,
-												  image_edit_v_slices);
+
+					const int default_bits =
+						app.project.project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32;
+					size_t rgba32_bytes = (size_t)(*image)->width * (*image)->height * 4;
+					render_sprite_tmem_fit(
+						(*image)->width, (*image)->height, image_edit_h_slices, image_edit_v_slices,
+						get_libdragon_sprite_format_bits((*image)->format, default_bits),
+						is_libdragon_sprite_format_indexed((*image)->format));
+					ImGui::Text("Size: %.1f KB (RGBA32: %.1f KB)",
+								(float)(*image)->GetSpriteBytes(default_bits) / 1024.f,
+								(float)rgba32_bytes / 1024.f);
+					if ((*image)->trim && (*image)->atlas_group.empty()) {
+						if (image_edit_trim_h_slices != image_edit_h_slices ||
+							image_edit_trim_v_slices != image_edit_v_slices) {
+							image_edit_trim_h_slices = image_edit_h_slices;
+							image_edit_trim_v_slices = image_edit_v_slices;
+							image_edit_trim = (*image)->LoadTrim(
+								app.project.project_settings.project_directory,
+								image_edit_h_slices, image_edit_v_slices);
+						}
+
+						size_t saved_bytes = (size_t)image_edit_trim.GetSavedTexels() *
+											 get_libdragon_sprite_format_bits((*image)->format,
+																			  default_bits) /
+											 8;
+						ImGui::Text("Trimmed: %dx%d frames, %.1f KB saved",
+									image_edit_trim.cell_width, image_edit_trim.cell_height,
+									(float)saved_bytes / 1024.f);
 					}
 
 					ImGui::Separator();
@@ -1556,6 +1854,7 @@ void render_asset_details_window(App &app) {
 							(*image)->dfs_folder = image_edit_dfs_folder;
 							(*image)->h_slices = image_edit_h_slices;
 							(*image)->v_slices = image_edit_v_slices;
+							(*image)->atlas_group = image_edit_atlas_group;
 							(*image)->image_path = "assets/sprites/" + (*image)->name + extension;
 
 							(*image)->SaveToDisk(app.project.project_settings.project_directory);
@@ -1578,6 +1877,9 @@ void render_asset_details_window(App &app) {
 		case SOUND: {
 			static char sound_edit_name[50];
 			static char sound_edit_dfs_folder[100];
+			static bool preview_converted;
+			static WavInfo sound_edit_info;
+			static bool sound_edit_info_valid;
 			if (app.state.reload_asset_edit) {
 				app.state.reload_asset_edit = false;
 
@@ -1585,79 +1887,76 @@ void render_asset_details_window(App &app) {
 				strcpy(sound_edit_dfs_folder,
 					   (*app.state.asset_editing.Ref().sound)->dfs_folder.c_str());
 
-				if ((*app.state.asset_editing.Ref().sound)->type == SOUND_WAV) {
-					std::string sound_path = app.project.project_settings.project_directory + "/" +
-											 (*app.state.asset_editing.Ref().sound)->sound_path;
+				preview_converted = false;
+				open_sound_preview(app, **app.state.asset_editing.Ref().sound, preview_converted);
 
-					if (app.audio_state == SS_PLAYING || app.audio_state == SS_PAUSED) {
-						Mix_HaltChannel(-1);
-						app.audio_state = SS_STOPPED;
-					}
-					if (app.audio_sample) {
-						Mix_FreeChunk(app.audio_sample);
-					}
-
-					app.audio_sample = Mix_LoadWAV(sound_path.c_str());
-					if (!app.audio_sample) {
-						console.AddLog("[error] Unable to load wave file: %s\n",
-									   sound_path.c_str());
-					}
-				}
+				sound_edit_info_valid = read_wav_info(
+					app.project.project_settings.project_directory + "/" +
+						(*app.state.asset_editing.Ref().sound)->sound_path,
+					sound_edit_info);
 			}
 			if (ImGui::Begin("Details", nullptr,
 							 ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse)) {
 				// audio preview
 				if (app.state.asset_editing.Ref().sound) {
-					if ((*app.state.asset_editing.Ref().sound)->type == SOUND_WAV) {
-						if (ImGui::Button(app.audio_state == SS_STOPPED ? "Play" : "Restart")) {
-							switch (app.audio_state) {
-								case SS_STOPPED:
-									Mix_PlayChannel(0, app.audio_sample, 0);
-									break;
-								case SS_PAUSED:
-								case SS_PLAYING:
-									Mix_HaltChannel(0);
-									Mix_PlayChannel(0, app.audio_sample, 0);
-									break;
-							}
-							app.audio_state = SS_PLAYING;
-						}
-						ImGui::SameLine();
-						ImGui::BeginDisabled(app.audio_state == SS_STOPPED);
-						if (ImGui::Button(app.audio_state == SS_PAUSED ? "Resume" : "Pause")) {
-							if (app.audio_state == SS_PAUSED) {
-								Mix_Resume(0);
-								app.audio_state = SS_PLAYING;
-							} else {
-								Mix_Pause(0);
-								app.audio_state = SS_PAUSED;
-							}
-						}
-						ImGui::EndDisabled();
+					LibdragonSound &sound = **app.state.asset_editing.Ref().sound;
+					SoundState audio_state = app.audio_preview.GetState();
 
-						ImGui::SameLine();
-						ImGui::BeginDisabled(app.audio_state == SS_STOPPED);
-						if (ImGui::Button("Stop")) {
-							Mix_HaltChannel(0);
-							app.audio_state = SS_STOPPED;
-						}
-						ImGui::EndDisabled();
+					ImGui::BeginDisabled(!app.audio_preview.IsOpen());
+					if (ImGui::Button(audio_state == SS_STOPPED ? "Play" : "Restart")) {
+						app.audio_preview.Play();
+					}
+					ImGui::SameLine();
+					ImGui::BeginDisabled(audio_state == SS_STOPPED);
+					if (ImGui::Button(audio_state == SS_PAUSED ? "Resume" : "Pause")) {
+						if (audio_state == SS_PAUSED)
+							app.audio_preview.Resume();
+						else
+							app.audio_preview.Pause();
+					}
+					ImGui::SameLine();
+					if (ImGui::Button("Stop")) {
+						app.audio_preview.Stop();
+					}
+					ImGui::EndDisabled();
 
-						ImGui::SameLine();
-						static int volume = MIX_MAX_VOLUME;
-						ImGui::SetNextItemWidth(100);
-						if (ImGui::SliderInt("Volume", &volume, 0, MIX_MAX_VOLUME)) {
-							Mix_Volume(0, volume);
-						}
-					} else {
-						ImGui::TextWrapped("Preview is not supported for this audio type.");
+					ImGui::SameLine();
+					static int volume = MIX_MAX_VOLUME;
+					ImGui::SetNextItemWidth(100);
+					if (ImGui::SliderInt("Volume", &volume, 0, MIX_MAX_VOLUME)) {
+						app.audio_preview.SetVolume(volume);
+					}
+
+					// dragging the slider seeks, it is kept up to date while playing
+					float duration = (float)app.audio_preview.GetDuration();
+					float position = (float)app.audio_preview.GetPosition();
+					int position_seconds = (int)position;
+					int duration_seconds = (int)duration;
+					char position_text[30];
+					snprintf(position_text, 30, "%d:%02d / %d:%02d", position_seconds / 60,
+							 position_seconds % 60, duration_seconds / 60, duration_seconds % 60);
+					ImGui::SetNextItemWidth(300);
+					if (ImGui::SliderFloat("Position", &position, 0, std::max(duration, 0.01f),
+										   position_text, ImGuiSliderFlags_NoInput)) {
+						app.audio_preview.Seek(position);
+					}
+					ImGui::EndDisabled();
+
+					std::string converted_path = get_converted_sound_path(app, sound);
+					ImGui::SameLine();
+					ImGui::BeginDisabled(sound.type != SOUND_WAV ||
+										 !std::filesystem::exists(converted_path));
+					if (ImGui::Checkbox("Converted", &preview_converted)) {
+						open_sound_preview(app, sound, preview_converted);
+					}
+					ImGui::EndDisabled();
+					if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+						ImGui::SetTooltip("Plays the .wav64 file from the last build.");
 					}
 
 					ImGui::Spacing();
 					ImGui::Separator();
 					ImGui::Spacing();
-				} else if (app.audio_state != SS_STOPPED) {
-					Mix_HaltChannel(0);
 				}
 
 				ImGui::InputText("Name", sound_edit_name, 50, ImGuiInputTextFlags_CharsFileName);
@@ -1671,6 +1970,34 @@ void render_asset_details_window(App &app) {
 						ImGui::InputInt("Offset",
 										&(*app.state.asset_editing.Ref().sound)->wav_loop_offset);
 					}
+
+					LibdragonSound &sound = **app.state.asset_editing.Ref().sound;
+					ImGui::Checkbox("Custom Processing", &sound.wav_override_processing);
+					ImGui::BeginDisabled(!sound.wav_override_processing);
+					ImGui::SameLine();
+					ImGui::Checkbox("Resample", &sound.wav_resample);
+					ImGui::SameLine();
+					ImGui::Checkbox("Mono", &sound.wav_mono);
+					ImGui::SameLine();
+					ImGui::SetNextItemWidth(100);
+					combo_bit_depth("Bit Depth", sound.wav_bit_depth);
+					ImGui::EndDisabled();
+
+					if (sound_edit_info_valid) {
+						const AudioSettings &audio = app.project.project_settings.audio;
+						SoundFormat source = get_source_format(sound_edit_info);
+						SoundFormat built =
+							get_processed_format(sound_edit_info, sound.GetProcessOptions(audio));
+						Sint64 source_size = get_sound_size(sound_edit_info, source);
+						Sint64 built_size = get_sound_size(sound_edit_info, built);
+
+						ImGui::Text("Source: %d Hz, %d channel(s), %d bits - %.1f KB", source.rate,
+									source.channels, source.bits, (float)source_size / 1024.f);
+						ImGui::Text(
+							"Built: %d Hz, %d channel(s), %d bits - %.1f KB (%.1f KB saved)",
+							built.rate, built.channels, built.bits, (float)built_size / 1024.f,
+							(float)(source_size - built_size) / 1024.f);
+					}
 				} else if ((*app.state.asset_editing.Ref().sound)->type == SOUND_YM) {
 					ImGui::Checkbox("Compress",
 									&(*app.state.asset_editing.Ref().sound)->ym_compress);
@@ -1695,6 +2022,7 @@ void render_asset_details_window(App &app) {
 								"different name.");
 							will_save = false;
 						} else {
+							app.audio_preview.Close();
 							std::filesystem::copy_file(
 								app.project.project_settings.project_directory + "/" +
 									(*app.state.asset_editing.Ref().sound)->sound_path,
@@ -2175,17 +2503,13 @@ void AppGui::RenderContentBrowser(App &app) {
 				for (size_t i = 0; i < app.project.images.size(); ++i) {
 					if (app.project.images[i]->image_path ==
 						(*app.state.asset_selected.Ref().image)->image_path) {
-						if ((*app.state.asset_selected.Ref().image)->loaded_image) {
-							SDL_DestroyTexture(
-								(*app.state.asset_selected.Ref().image)->loaded_image);
-						}
-
 						app.project.images.erase(app.project.images.begin() + (int)i);
 						break;
 					}
 				}
 			} break;
 			case SOUND: {
+				app.audio_preview.Close();
 				(*app.state.asset_selected.Ref().sound)
 					->DeleteFromDisk(app.project.project_settings.project_directory);
 
@@ -2217,11 +2541,6 @@ void AppGui::RenderContentBrowser(App &app) {
 				for (size_t i = 0; i < app.project.fonts.size(); ++i) {
 					if (app.project.fonts[i]->font_path ==
 						(*app.state.asset_selected.Ref().font)->font_path) {
-						if ((*app.state.asset_selected.Ref().font)->loaded_image) {
-							SDL_DestroyTexture(
-								(*app.state.asset_selected.Ref().font)->loaded_image);
-						}
-
 						app.project.fonts.erase(app.project.fonts.begin() + (int)i);
 						break;
 					}
@@ -2261,6 +2580,130 @@ void AppGui::RenderContentBrowser(App &app) {
 	}
 }
 
+static void render_scene_preload(App &app, Scene &scene) {
+	ImGui::TextUnformatted("Preloaded Assets (?)");
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip(
+			"Loaded in filesystem order when the scene is created, so they don't hitch on first "
+			"use.\nAvailable on 'scene_assets[ASSET_ID]'.");
+	}
+
+	std::vector<std::string> asset_paths = get_asset_dfs_paths(app.project);
+	if (asset_paths.empty()) {
+		ImGui::TextWrapped("Needs the DFS module and assets on the filesystem.");
+		return;
+	}
+
+	// sizes of the last build, like the built sounds
+	const std::string filesystem_folder = app.project.project_settings.project_directory +
+										  "/build/filesystem";
+	uintmax_t preload_bytes = 0;
+	if (ImGui::BeginChild("##PreloadAssets", ImVec2(0, 150), true)) {
+		for (auto &path : asset_paths) {
+			auto preload = std::find(scene.preload_assets.begin(), scene.preload_assets.end(),
+									 path);
+			bool is_preloaded = preload != scene.preload_assets.end();
+
+			std::error_code error;
+			uintmax_t size = std::filesystem::file_size(filesystem_folder + path, error);
+			if (error)
+				size = 0;
+			if (is_preloaded)
+				preload_bytes += (size + 7) & ~7;
+
+			if (ImGui::Checkbox(path.c_str(), &is_preloaded)) {
+				if (is_preloaded)
+					scene.preload_assets.push_back(path);
+				else
+					scene.preload_assets.erase(preload);
+			}
+			ImGui::SameLine();
+			ImGui::TextDisabled("%.1f KB", (float)size / 1024.f);
+		}
+	}
+	ImGui::EndChild();
+
+	const ProjectSettings &settings = app.project.project_settings;
+	ImGui::Text("%.1f KB preloaded", (float)preload_bytes / 1024.f);
+	if (settings.modules.memory_pool &&
+		preload_bytes > (uintmax_t)settings.scene_mem_alloc_size * 1024) {
+		ImGui::SameLine();
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.6f, 1.0f), "(scene memory pool is %d KB)",
+						   settings.scene_mem_alloc_size);
+	}
+}
+
+static void render_scene_pools(App &app, Scene &scene) {
+	ImGui::TextUnformatted("Object Pools (?)");
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip(
+			"Fixed-size pools of a struct from a script header, created with the scene.\nUse "
+			"'NAME_alloc()' and 'NAME_free(item)' from 'scenes/pools.gen.h'.");
+	}
+
+	if (ImGui::BeginTable("##ScenePools", 5, ImGuiTableFlags_SizingStretchProp)) {
+		ImGui::TableSetupColumn("Name");
+		ImGui::TableSetupColumn("Type");
+		ImGui::TableSetupColumn("Script Header");
+		ImGui::TableSetupColumn("Capacity");
+		ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+		ImGui::TableHeadersRow();
+
+		for (size_t i = 0; i < scene.pools.size(); ++i) {
+			ScenePool &pool = scene.pools[i];
+			ImGui::PushID((int)i);
+			ImGui::TableNextRow();
+
+			char name[50];
+			snprintf(name, 50, "%s", pool.name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::SetNextItemWidth(-1);
+			if (ImGui::InputText("##Name", name, 50, ImGuiInputTextFlags_CharsNoBlank))
+				pool.name = name;
+
+			char type[50];
+			snprintf(type, 50, "%s", pool.type.c_str());
+			ImGui::TableNextColumn();
+			ImGui::SetNextItemWidth(-1);
+			if (ImGui::InputText("##Type", type, 50, ImGuiInputTextFlags_CharsNoBlank))
+				pool.type = type;
+
+			ImGui::TableNextColumn();
+			ImGui::SetNextItemWidth(-1);
+			if (ImGui::BeginCombo("##Script", pool.script_name.c_str())) {
+				for (auto &script : app.project.script_files) {
+					if (ImGui::Selectable(script->name.c_str(),
+										  script->name == pool.script_name)) {
+						pool.script_name = script->name;
+					}
+				}
+				ImGui::EndCombo();
+			}
+
+			ImGui::TableNextColumn();
+			ImGui::SetNextItemWidth(-1);
+			ImGui::InputInt("##Capacity", &pool.capacity, 1, 16);
+			pool.capacity = std::clamp(pool.capacity, 1, 65535);
+
+			bool remove = false;
+			ImGui::TableNextColumn();
+			if (ImGui::SmallButton("Remove"))
+				remove = true;
+
+			ImGui::PopID();
+			if (remove) {
+				scene.pools.erase(scene.pools.begin() + (int)i);
+				break;
+			}
+		}
+		ImGui::EndTable();
+	}
+
+	if (ImGui::SmallButton("Add Pool")) {
+		scene.pools.push_back({"pool_" + std::to_string(scene.pools.size()), "", "", 32});
+	}
+}
+
 void AppGui::RenderSceneWindow(App &app) {
 	const float prop_y_size = is_output_open ? 219 : 38;
 	ImGui::SetNextWindowSize(ImVec2(300, (float)window_height - prop_y_size));
@@ -2323,6 +2766,20 @@ void AppGui::RenderSceneWindow(App &app) {
 					ImGui::SetTooltip("Build [F6]");
 				}
 
+				ImGui::SameLine();
+				ImGui::BeginDisabled(!app.asset_watcher.IsRunning());
+				if (ImGui::Checkbox("Watch", &app.state.watch_build) && app.state.watch_build) {
+					console.AddLog("Building Project...");
+
+					ProjectBuilder::Build(&app);
+				}
+				ImGui::EndDisabled();
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip(app.asset_watcher.IsRunning()
+										  ? "Rebuild changed files automatically"
+										  : "Watching files is not supported on this platform");
+				}
+
 				ImGui::SameLine();
 				ImGui::PushID(3);
 				app.GetImagePosition("Clean_Build.png", button_uv0, button_uv1);
@@ -2509,9 +2966,19 @@ void AppGui::RenderSceneWindow(App &app) {
 													 ImGuiInputTextFlags_CharsFileName);
 
 									ImGui::Spacing();
+									ImGui::Checkbox("Clear Screen",
+													&app.state.current_scene->clear_screen);
+									if (ImGui::IsItemHovered()) {
+										ImGui::SetTooltip(
+											"Fills the screen before drawing the scene (with the "
+											"RDP when its module is on).\nScenes that draw over "
+											"the whole screen can turn it off.");
+									}
+									ImGui::BeginDisabled(!app.state.current_scene->clear_screen);
 									ImGui::ColorEdit3("Background Fill Color",
 													  app.state.current_scene->fill_color,
 													  ImGuiColorEditFlags_NoInputs);
+									ImGui::EndDisabled();
 
 									ImGui::Spacing();
 									ImGui::Separator();
@@ -2539,6 +3006,16 @@ void AppGui::RenderSceneWindow(App &app) {
 									}
 									ImGui::Spacing();
 
+									ImGui::Separator();
+									ImGui::Spacing();
+									render_scene_preload(app, *app.state.current_scene);
+									ImGui::Spacing();
+
+									ImGui::Separator();
+									ImGui::Spacing();
+									render_scene_pools(app, *app.state.current_scene);
+									ImGui::Spacing();
+
 									ImGui::Separator();
 									ImGui::Spacing();
 									if (ImGui::Button("Save")) {
@@ -2813,12 +3290,17 @@ void AppGui::RenderSettingsWindow(App &app) {
 
 						if (ImGui::Checkbox("Display",
 											&app.project.project_settings.modules.display)) {
-							if (!app.project.project_settings.modules.display)
+							if (!app.project.project_settings.modules.display) {
 								app.project.project_settings.modules.rdp = false;
+								app.project.project_settings.modules.sprite_batch = false;
+							}
 						}
 
 						ImGui::BeginDisabled(!app.project.project_settings.modules.display);
-						ImGui::Checkbox("RDP", &app.project.project_settings.modules.rdp);
+						if (ImGui::Checkbox("RDP", &app.project.project_settings.modules.rdp)) {
+							if (!app.project.project_settings.modules.rdp)
+								app.project.project_settings.modules.sprite_batch = false;
+						}
 						ImGui::EndDisabled();
 
 						ImGui::Checkbox("Console", &app.project.project_settings.modules.console);
@@ -2828,7 +3310,12 @@ void AppGui::RenderSettingsWindow(App &app) {
 										&app.project.project_settings.modules.debug_is_viewer);
 						ImGui::Checkbox("Debug USB",
 										&app.project.project_settings.modules.debug_usb);
-						ImGui::Checkbox("DFS", &app.project.project_settings.modules.dfs);
+						if (ImGui::Checkbox("DFS", &app.project.project_settings.modules.dfs)) {
+							if (!app.project.project_settings.modules.dfs) {
+								app.project.project_settings.modules.asset_cache = false;
+								app.project.project_settings.modules.asset_stream = false;
+							}
+						}
 
 						if (ImGui::Checkbox("Timer", &app.project.project_settings.modules.timer)) {
 							if (!app.project.project_settings.modules.timer)
@@ -2852,6 +3339,59 @@ void AppGui::RenderSettingsWindow(App &app) {
 						ImGui::Checkbox("Scene Manager",
 										&app.project.project_settings.modules.scene_manager);
 
+						ImGui::Spacing();
+						ImGui::BeginDisabled();
+						ImGui::TextWrapped("NGine");
+						ImGui::EndDisabled();
+						ImGui::Separator();
+
+						ImGui::BeginDisabled(!app.project.project_settings.modules.dfs);
+						ImGui::Checkbox("Asset Cache",
+										&app.project.project_settings.modules.asset_cache);
+						if (ImGui::IsItemHovered()) {
+							ImGui::SetTooltip(
+								"Generates 'asset_cache_acquire/release' to share loaded sprites "
+								"and sounds\nbetween scripts, keyed by 'AssetId'.");
+						}
+						ImGui::Checkbox("Asset Streaming",
+										&app.project.project_settings.modules.asset_stream);
+						if (ImGui::IsItemHovered()) {
+							ImGui::SetTooltip(
+								"Generates 'asset_stream_read' to read assets in the background "
+								"over a few frames,\nwith a callback once they are done.");
+						}
+						ImGui::EndDisabled();
+
+						bool is_16_bpp =
+							app.project.project_settings.display.bit_depth == DEPTH_16_BPP;
+						ImGui::BeginDisabled(!app.project.project_settings.modules.rdp ||
+											 !is_16_bpp);
+						ImGui::Checkbox("Sprite Batch",
+										&app.project.project_settings.modules.sprite_batch);
+						ImGui::EndDisabled();
+						if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+							if (is_16_bpp)
+								ImGui::SetTooltip(
+									"Generates 'sprite_batch_draw' to queue sprites, drawn with "
+									"the RDP sorted by texture\nright before 'display_show'.");
+							else
+								ImGui::SetTooltip(
+									"Needs a 16 bit display, the RDP can't copy sprites to 32 bit "
+									"framebuffers.");
+						}
+
+						ImGui::BeginDisabled(
+							!app.project.project_settings.modules.debug_is_viewer &&
+							!app.project.project_settings.modules.debug_usb);
+						ImGui::Checkbox("Profiler", &app.project.project_settings.modules.profiler);
+						if (ImGui::IsItemHovered()) {
+							ImGui::SetTooltip(
+								"Times tick, display and the scripts of each scene, reported "
+								"through the debug output\nonce a second to the 'Frame Profiler' "
+								"window while running on the emulator.");
+						}
+						ImGui::EndDisabled();
+
 						ImGui::EndTabItem();
 					}
 
@@ -2870,6 +3410,7 @@ void AppGui::RenderSettingsWindow(App &app) {
 													  "RESOLUTION_256x240", "RESOLUTION_512x480",
 													  "RESOLUTION_512x240", "RESOLUTION_640x240"};
 
+					static bool refresh_sounds_size = true;
 					if (ImGui::BeginTabItem("Module Settings")) {
 						{
 							ImGui::BeginDisabled(!app.project.project_settings.modules.display);
@@ -2897,6 +3438,25 @@ void AppGui::RenderSettingsWindow(App &app) {
 							ImGui::InputInt("Frequency",
 											&app.project.project_settings.audio.frequency);
 							ImGui::InputInt("Buffers", &app.project.project_settings.audio.buffers);
+
+							AudioSettings &audio = app.project.project_settings.audio;
+							ImGui::TextUnformatted("Wave Sounds");
+							ImGui::Checkbox("Resample", &audio.resample_sounds);
+							if (ImGui::IsItemHovered()) {
+								ImGui::SetTooltip("Lowers the sample rate to the frequency above.");
+							}
+							ImGui::SameLine();
+							ImGui::Checkbox("Mono", &audio.mono_sounds);
+							ImGui::SameLine();
+							ImGui::SetNextItemWidth(100);
+							combo_bit_depth("Bit Depth##Sounds", audio.sound_bit_depth);
+
+							Sint64 source_size, built_size;
+							get_sounds_size(app, refresh_sounds_size, source_size, built_size);
+							refresh_sounds_size = false;
+							ImGui::Text("%.1f KB -> %.1f KB (%.1f KB saved)",
+										(float)source_size / 1024.f, (float)built_size / 1024.f,
+										(float)(source_size - built_size) / 1024.f);
 							ImGui::EndDisabled();
 						}
 						{
@@ -2926,6 +3486,104 @@ void AppGui::RenderSettingsWindow(App &app) {
 							ImGui::InputInt("##LocalMem",
 											&app.project.project_settings.scene_mem_alloc_size, 1,
 											1024);
+							ImGui::TextUnformatted("Frame Memory Reserve (KB) (?)");
+							if (ImGui::IsItemHovered()) {
+								ImGui::SetTooltip(
+									"'frame_memory_pool' is reset at the start of every frame, "
+									"for temporary allocations.\nUse 0 to leave it out.");
+							}
+							ImGui::InputInt("##FrameMem",
+											&app.project.project_settings.frame_mem_alloc_size, 1,
+											64);
+							if (app.project.project_settings.frame_mem_alloc_size < 0)
+								app.project.project_settings.frame_mem_alloc_size = 0;
+							ImGui::EndDisabled();
+						}
+						{
+							TimestepSettings &timestep = app.project.project_settings.timestep;
+							ImGui::BeginDisabled(!app.project.project_settings.modules.timer);
+							ImGui::Separator();
+							ImGui::Spacing();
+							ImGui::TextUnformatted("Fixed Timestep");
+							separator_light();
+
+							ImGui::Checkbox("Fixed Timestep", &timestep.fixed);
+							if (ImGui::IsItemHovered()) {
+								ImGui::SetTooltip(
+									"Runs 'tick' at the same rate no matter how long 'display' "
+									"takes.\nScripts can use 'FIXED_STEP_DT' and "
+									"'fixed_step_alpha' to interpolate.");
+							}
+							ImGui::BeginDisabled(!timestep.fixed);
+							ImGui::InputInt("Logic Hz", &timestep.logic_hz);
+							timestep.logic_hz = std::clamp(timestep.logic_hz, 1, 240);
+							ImGui::InputInt("Max Catch-up Steps", &timestep.max_catch_up_steps);
+							timestep.max_catch_up_steps = std::clamp(timestep.max_catch_up_steps,
+																	 1, 16);
+							ImGui::Checkbox("Skip Display When Behind", &timestep.frame_skip);
+							ImGui::EndDisabled();
+							ImGui::EndDisabled();
+						}
+						{
+							ProjectSettings &settings = app.project.project_settings;
+							ImGui::BeginDisabled(!settings.modules.asset_cache);
+							ImGui::Separator();
+							ImGui::Spacing();
+							ImGui::TextUnformatted("Asset Cache");
+							separator_light();
+
+							ImGui::TextUnformatted("Budget (KB) (?)");
+							if (ImGui::IsItemHovered()) {
+								ImGui::SetTooltip(
+									"Unused assets are evicted, least recently used first, to "
+									"stay under it.\nwav64 sounds stream from the rom, so only "
+									"their handle is counted.");
+							}
+							ImGui::InputInt("##AssetCacheSize", &settings.asset_cache_size, 1,
+											1024);
+							if (settings.asset_cache_size < 1)
+								settings.asset_cache_size = 1;
+							if (settings.modules.memory_pool &&
+								settings.asset_cache_size > settings.scene_mem_alloc_size) {
+								ImGui::TextWrapped(
+									"The cache uses the scene memory pool, which is smaller "
+									"than the budget.");
+							}
+							ImGui::EndDisabled();
+						}
+						{
+							ProjectSettings &settings = app.project.project_settings;
+							ImGui::BeginDisabled(!settings.modules.asset_stream);
+							ImGui::Separator();
+							ImGui::Spacing();
+							ImGui::TextUnformatted("Asset Streaming");
+							separator_light();
+
+							ImGui::TextUnformatted("Read per Frame (KB) (?)");
+							if (ImGui::IsItemHovered()) {
+								ImGui::SetTooltip(
+									"Size of each background read. Other reads (like audio) wait "
+									"for it, so keep it small.\nThe PI moves around 80 KB per "
+									"frame at 60 FPS.");
+							}
+							ImGui::InputInt("##AssetStreamChunkSize",
+											&settings.asset_stream_chunk_size, 1, 8);
+							settings.asset_stream_chunk_size =
+								std::clamp(settings.asset_stream_chunk_size, 1, 256);
+							ImGui::EndDisabled();
+						}
+						{
+							ProjectSettings &settings = app.project.project_settings;
+							ImGui::BeginDisabled(!settings.modules.sprite_batch);
+							ImGui::Separator();
+							ImGui::Spacing();
+							ImGui::TextUnformatted("Sprite Batch");
+							separator_light();
+
+							ImGui::InputInt("Max Draws per Frame", &settings.sprite_batch_size, 1,
+											64);
+							settings.sprite_batch_size =
+								std::clamp(settings.sprite_batch_size, 1, 65535);
 							ImGui::EndDisabled();
 						}
 						{
@@ -2960,6 +3618,8 @@ void AppGui::RenderSettingsWindow(App &app) {
 						}
 
 						ImGui::EndTabItem();
+					} else {
+						refresh_sounds_size = true;
 					}
 
 					ImGui::Separator();
@@ -3029,10 +3689,21 @@ void AppGui::RenderSettingsWindow(App &app) {
 					}
 				}
 
+				ImGui::TextUnformatted("Preview Texture Budget (MB) (?)");
+				if (ImGui::IsItemHovered()) {
+					ImGui::SetTooltip(
+						"Memory used by full resolution sprites and fonts.\nThe least recently "
+						"viewed ones are unloaded when over it, thumbnails are always kept.");
+				}
+				ImGui::InputInt("##TextureBudget", &app.state.texture_budget, 16, 64);
+				if (app.state.texture_budget < 16)
+					app.state.texture_budget = 16;
+
 				ImGui::Spacing();
 				if (ImGui::Button("Save")) {
 					app.engine_settings.SetEmulatorPath(app.state.emulator_path);
 					app.engine_settings.SetEditorLocation(app.state.editor_path);
+					app.engine_settings.SetTextureBudget(app.state.texture_budget);
 					app.engine_settings.SetLibdragonExeLocation(
 						&app, app.state.libdragon_use_bundled, app.state.libdragon_exe_path);
 				}
@@ -0,0 +1,331 @@
+#include "AssetWatcher.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "App.h"
+#include "ConsoleApp.h"
+#include "ProjectBuilder.h"
+#include "ThreadCommand.h"
+
+// editors usually save in bursts (truncate, write, rename), so wait for things to settle
+const Uint32 debounce_time = 250;
+
+template <typename T>
+static std::unique_ptr<T> make_asset() {
+	return std::make_unique<T>();
+}
+
+template <>
+std::unique_ptr<LibdragonSound> make_asset() {
+	return std::make_unique<LibdragonSound>(SOUND_UNKNOWN);
+}
+
+static void reset_references(App *app, AssetType type) {
+	if (app->state.asset_selected.Type() == type)
+		app->state.asset_selected.Reset();
+	if (app->state.asset_editing.Type() == type)
+		app->state.asset_editing.Reset();
+}
+
+// Reloads a single '.ngine/<type>/<name>.<type>.json' file into the matching asset.
+// Returns true when the asset tree needs to be rebuilt.
+template <typename T, typename OnLoad>
+static bool reload_metadata(App *app, std::vector<std::unique_ptr<T>> &assets, AssetType type,
+							const std::string &relative_path, const std::string &suffix,
+							OnLoad on_load) {
+	std::string full_path = app->project.project_settings.project_directory + "/" +
+							relative_path;
+	std::string filename = std::filesystem::path(relative_path).filename().string();
+	std::string name = filename.substr(0, filename.size() - suffix.size());
+
+	auto find_by_name = [&name](const std::unique_ptr<T> &i) { return i->name == name; };
+	auto asset = std::find_if(assets.begin(), assets.end(), find_by_name);
+
+	if (!std::filesystem::exists(full_path)) {
+		if (asset == assets.end())
+			return false;
+
+		console.AddLog("# '%s' was removed from disk.", name.c_str());
+
+		reset_references(app, type);
+		assets.erase(asset);
+		return true;
+	}
+
+	try {
+		if (asset == assets.end()) {
+			auto new_asset = make_asset<T>();
+			new_asset->LoadFromDisk(full_path);
+			on_load(*new_asset);
+
+			console.AddLog("# '%s' was added.", new_asset->name.c_str());
+
+			// pushing may move the vector, so the references are no longer valid
+			reset_references(app, type);
+			assets.push_back(move(new_asset));
+			return true;
+		}
+
+		std::string previous_name = (*asset)->name;
+		std::string previous_dfs_folder = (*asset)->dfs_folder;
+
+		(*asset)->LoadFromDisk(full_path);
+		on_load(**asset);
+
+		console.AddLog("# '%s' was reloaded.", (*asset)->name.c_str());
+
+		return previous_name != (*asset)->name || previous_dfs_folder != (*asset)->dfs_folder;
+	} catch (std::exception &ex) {
+		console.AddLog("[error] Could not reload '%s': %s", relative_path.c_str(), ex.what());
+	}
+
+	return false;
+}
+
+AssetWatcher::AssetWatcher() : inotify_fd(-1) {
+}
+
+AssetWatcher::~AssetWatcher() {
+	Stop();
+}
+
+void AssetWatcher::Start(const std::string &project_directory) {
+	Stop();
+
+#ifdef __linux__
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd < 0) {
+		console.AddLog("[error] Could not start the asset watcher. Use 'Refresh Assets' instead.");
+		return;
+	}
+
+	watched_directory = project_directory;
+
+	// the root is watched only for the project settings and for folders created later
+	int wd = inotify_add_watch(inotify_fd, watched_directory.c_str(),
+							   IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO);
+	if (wd >= 0)
+		watched_folders[wd] = "";
+
+	AddWatch("assets");
+	AddWatch(".ngine");
+	AddWatch("src");
+#else
+	(void)project_directory;
+#endif
+}
+
+void AssetWatcher::Stop() {
+#ifdef __linux__
+	if (inotify_fd >= 0)
+		close(inotify_fd);
+#endif
+
+	inotify_fd = -1;
+	watched_directory.clear();
+	watched_folders.clear();
+	pending_changes.clear();
+	pending_build_changes.clear();
+}
+
+void AssetWatcher::AddWatch(const std::string &relative_folder) {
+#ifdef __linux__
+	std::filesystem::path folder(watched_directory + "/" + relative_folder);
+	if (!std::filesystem::is_directory(folder))
+		return;
+
+	const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+	int wd = inotify_add_watch(inotify_fd, folder.string().c_str(), mask);
+	if (wd >= 0)
+		watched_folders[wd] = relative_folder;
+
+	// inotify is not recursive, so every sub-folder needs its own watch
+	std::filesystem::recursive_directory_iterator dir_iter(folder);
+	for (auto &file_entry : dir_iter) {
+		if (file_entry.is_directory()) {
+			std::string relative = std::filesystem::relative(file_entry.path(), watched_directory)
+									   .string();
+			std::replace(relative.begin(), relative.end(), '\\', '/');
+
+			wd = inotify_add_watch(inotify_fd, file_entry.path().string().c_str(), mask);
+			if (wd >= 0)
+				watched_folders[wd] = relative;
+		}
+	}
+#else
+	(void)relative_folder;
+#endif
+}
+
+void AssetWatcher::ReadEvents() {
+#ifdef __linux__
+	alignas(inotify_event) char buffer[4096];
+
+	while (true) {
+		ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		const inotify_event *event;
+		for (char *ptr = buffer; ptr < buffer + length; ptr += sizeof(inotify_event) + event->len) {
+			event = (const inotify_event *)ptr;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				console.AddLog("[error] Too many file changes at once. Use 'Refresh Assets'.");
+				continue;
+			}
+			if (event->mask & IN_IGNORED) {
+				watched_folders.erase(event->wd);
+				continue;
+			}
+			if (event->len == 0 || !watched_folders.contains(event->wd))
+				continue;
+
+			const std::string &folder = watched_folders[event->wd];
+			std::string name(event->name);
+
+			if (event->mask & IN_ISDIR) {
+				if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+					if (!folder.empty())
+						AddWatch(folder + "/" + name);
+					else if (name == "assets" || name == ".ngine" || name == "src")
+						AddWatch(name);
+				}
+				continue;
+			}
+
+			if (folder.empty()) {
+				if (name == "ngine.project.json")
+					pending_changes[name] = SDL_GetTicks();
+				continue;
+			}
+
+			// written by the build itself
+			if (name.ends_with(".gen.c") || name.ends_with(".gen.h"))
+				continue;
+
+			pending_changes[folder + "/" + name] = SDL_GetTicks();
+		}
+	}
+#endif
+}
+
+void AssetWatcher::Update(App *app) {
+	if (!IsRunning())
+		return;
+
+	ReadEvents();
+
+	if (!pending_changes.empty()) {
+		const Uint32 now = SDL_GetTicks();
+
+		bool rebuild_asset_tree = false;
+		for (auto it = pending_changes.begin(); it != pending_changes.end();) {
+			if (now - it->second < debounce_time) {
+				++it;
+				continue;
+			}
+
+			rebuild_asset_tree |= ApplyChange(app, it->first);
+			if (app->state.watch_build)
+				pending_build_changes.push_back(it->first);
+
+			it = pending_changes.erase(it);
+		}
+
+		if (rebuild_asset_tree)
+			app->project.ReloadAssets();
+	}
+
+	if (!app->state.watch_build) {
+		pending_build_changes.clear();
+		return;
+	}
+
+	// everything that arrives while a build is running is coalesced into the next one
+	if (!pending_build_changes.empty() && !ThreadCommand::IsRunning()) {
+		console.AddLog("Building changes...");
+
+		ProjectBuilder::BuildChanged(app, pending_build_changes);
+		pending_build_changes.clear();
+	}
+}
+
+bool AssetWatcher::ApplyChange(App *app, const std::string &relative_path) {
+	Project &project = app->project;
+	const std::string &project_directory = project.project_settings.project_directory;
+
+	if (relative_path.starts_with(".ngine/")) {
+		if (relative_path.ends_with(".sprite.json")) {
+			return reload_metadata(app, project.images, IMAGE, relative_path, ".sprite.json",
+								   [&](LibdragonImage &image) {
+									   image.LoadImage(project_directory, app->renderer);
+								   });
+		}
+		if (relative_path.ends_with(".font.json")) {
+			return reload_metadata(app, project.fonts, FONT, relative_path, ".font.json",
+								   [&](LibdragonFont &font) {
+									   font.LoadImage(project_directory, app->renderer);
+								   });
+		}
+		if (relative_path.ends_with(".sound.json")) {
+			return reload_metadata(app, project.sounds, SOUND, relative_path, ".sound.json",
+								   [](LibdragonSound &) {});
+		}
+		if (relative_path.ends_with(".general.json")) {
+			return reload_metadata(app, project.general_files, GENERAL, relative_path,
+								   ".general.json", [](LibdragonFile &) {});
+		}
+		// the layer list is validated against the source file on load, nothing else to do
+		if (relative_path.ends_with(".tiled_maps.json")) {
+			return reload_metadata(app, project.tiled_maps, TILED_MAP, relative_path,
+								   ".tiled_maps.json", [](LibdragonTiledMap &) {});
+		}
+		if (relative_path.ends_with(".ldtk_maps.json")) {
+			return reload_metadata(app, project.ldtk_maps, LDTK_MAP, relative_path,
+								   ".ldtk_maps.json", [](LibdragonLDtkMap &) {});
+		}
+
+		return false;
+	}
+
+	if (!std::filesystem::exists(project_directory + "/" + relative_path))
+		return false;
+
+	for (auto &image : project.images) {
+		if (image->image_path == relative_path) {
+			image->LoadImage(project_directory, app->renderer);
+			console.AddLog("# '%s' was reloaded.", image->name.c_str());
+		}
+	}
+	for (auto &font : project.fonts) {
+		if (font->font_path == relative_path) {
+			font->LoadImage(project_directory, app->renderer);
+			console.AddLog("# '%s' was reloaded.", font->name.c_str());
+		}
+	}
+	for (auto &map : project.tiled_maps) {
+		if (map->file_path == relative_path && map->layers_loaded) {
+			map->LoadLayers();
+			map->SaveToDisk(project_directory);
+			console.AddLog("# '%s' was reloaded.", map->name.c_str());
+		}
+	}
+	for (auto &map : project.ldtk_maps) {
+		if (map->file_path == relative_path && map->layers_loaded) {
+			map->LoadLayers();
+			map->SaveToDisk(project_directory);
+			console.AddLog("# '%s' was reloaded.", map->name.c_str());
+		}
+	}
+
+	// sounds and general files are read straight from disk when previewed or built
+	return false;
+}
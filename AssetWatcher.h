@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+
+class App;
+
+// Watches 'assets/' and '.ngine/' for external changes and reloads only the assets that were
+// touched. When watch builds are enabled 'src/' is also tracked and every settled change is
+// rebuilt incrementally. Only available on Linux (inotify), it is a no-op everywhere else.
+class AssetWatcher {
+   public:
+	AssetWatcher();
+	~AssetWatcher();
+
+	void Start(const std::string &project_directory);
+	void Stop();
+
+	// reads pending events and applies the ones that settled for longer than the debounce time
+	void Update(App *app);
+
+	[[nodiscard]] bool IsRunning() const {
+		return inotify_fd >= 0;
+	}
+
+	AssetWatcher(AssetWatcher const &) = delete;
+	AssetWatcher &operator=(AssetWatcher const &) = delete;
+
+   private:
+	int inotify_fd;
+	std::string watched_directory;
+
+	// watch descriptor -> folder relative to the project
+	std::unordered_map<int, std::string> watched_folders;
+	// file relative to the project -> tick of the last event received
+	std::map<std::string, Uint32> pending_changes;
+	// changes waiting for the current build to finish
+	std::vector<std::string> pending_build_changes;
+
+	void AddWatch(const std::string &relative_folder);
+	void ReadEvents();
+	bool ApplyChange(App *app, const std::string &relative_path);
+};
@@ -0,0 +1,341 @@
+#include "CodeSizeReport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#include "imgui.h"
+#include "imgui_custom.h"
+
+#include "App.h"
+#include "ConsoleApp.h"
+#include "ElfFile.h"
+#include "ReportHistory.h"
+#include "json.hpp"
+
+static const char *origin_names[] = {"scripts", "generated", "game", "libdragon-extensions",
+									 "libdragon"};
+static const int origin_count = 5;
+
+static std::string get_elf_path(const Project &project) {
+	return project.project_settings.project_directory + "/build/" +
+		   project.project_settings.rom_name + ".elf";
+}
+
+// symbols move by a few bytes, more precise than the rom size deltas
+static std::string format_code_delta(uintmax_t bytes, uintmax_t previous_bytes) {
+	return format_delta(bytes, previous_bytes, 2);
+}
+
+static std::string get_code_origin(const std::string &source) {
+	if (source.empty())
+		return "libdragon";
+	if (source.starts_with("libs/libdragon-extensions/"))
+		return "libdragon-extensions";
+	if (source.starts_with("src/scripts/"))
+		return "scripts";
+	if (source.find(".gen.") != std::string::npos)
+		return "generated";
+	return "game";
+}
+
+// red when it grew, nothing when it did not change
+static void render_delta(uintmax_t bytes, uintmax_t previous_bytes) {
+	if (bytes > previous_bytes)
+		ImGui::TextColored(color_invalid_input, "%s",
+						   format_code_delta(bytes, previous_bytes).c_str());
+	else if (bytes < previous_bytes)
+		ImGui::TextUnformatted(format_code_delta(bytes, previous_bytes).c_str());
+}
+
+CodeSizeReport::CodeSizeReport()
+	: is_open(false),
+	  code_bytes(0),
+	  data_bytes(0),
+	  bss_bytes(0),
+	  elf_time(0),
+	  has_previous(false),
+	  previous_code_bytes(0),
+	  previous_data_bytes(0),
+	  previous_bss_bytes(0),
+	  origin_filter(-1),
+	  name_filter(),
+	  history("code_size_report.json", "elf_time") {
+}
+
+bool CodeSizeReport::Analyze(const Project &project) {
+	const std::string &project_directory = project.project_settings.project_directory;
+
+	elf_time = get_file_time(get_elf_path(project));
+
+	ElfFile elf;
+	if (!elf.Load(get_elf_path(project))) {
+		console.AddLog("[error] Could not read '%s', please build the project first.",
+					   get_elf_path(project).c_str());
+		return false;
+	}
+
+	// objects are built next to their sources, so they tell where each global comes from
+	std::map<std::string, std::string> global_sources;
+	std::map<std::string, std::string> file_sources;
+	for (const char *folder : {"src", "libs/libdragon-extensions", "build"}) {
+		std::filesystem::path folder_path(project_directory + "/" + folder);
+		if (!std::filesystem::exists(folder_path))
+			continue;
+
+		for (auto &file : std::filesystem::recursive_directory_iterator(folder_path)) {
+			if (!file.is_regular_file() || file.path().extension() != ".o")
+				continue;
+
+			std::string source = std::filesystem::relative(file.path(), project_directory)
+									 .replace_extension(".c")
+									 .generic_string();
+			if (source.starts_with("build/"))
+				source = source.substr(6);
+
+			ElfFile object;
+			if (!object.Load(file.path().string()))
+				continue;
+
+			file_sources[file.path().filename().replace_extension(".c").string()] = source;
+			for (auto &symbol : object.symbols) {
+				if (!symbol.is_local && symbol.section >= 0)
+					global_sources[symbol.name] = source;
+			}
+		}
+	}
+
+	std::vector<CodeSizeSymbol> new_symbols;
+	code_bytes = data_bytes = bss_bytes = 0;
+	for (auto &section : elf.sections) {
+		if (!section.IsAllocated())
+			continue;
+
+		if (section.IsCode())
+			code_bytes += section.size;
+		else if (section.IsNoBits())
+			bss_bytes += section.size;
+		else
+			data_bytes += section.size;
+	}
+	for (auto &symbol : elf.symbols) {
+		if ((symbol.type != ELF_SYMBOL_FUNC && symbol.type != ELF_SYMBOL_OBJECT) ||
+			symbol.size == 0 || symbol.section < 0 || !elf.sections[symbol.section].IsAllocated())
+			continue;
+
+		CodeSizeSymbol code_symbol;
+		code_symbol.name = symbol.name;
+		code_symbol.is_function = symbol.type == ELF_SYMBOL_FUNC;
+		code_symbol.section = elf.sections[symbol.section].name;
+		code_symbol.size = symbol.size;
+		if (symbol.is_local) {
+			// only the file name is on STT_FILE
+			auto file_source = file_sources.find(
+				std::filesystem::path(symbol.file).filename().string());
+			if (file_source != file_sources.end())
+				code_symbol.source = file_source->second;
+		} else {
+			auto global_source = global_sources.find(symbol.name);
+			if (global_source != global_sources.end())
+				code_symbol.source = global_source->second;
+		}
+		code_symbol.origin = get_code_origin(code_symbol.source);
+
+		new_symbols.push_back(code_symbol);
+	}
+	std::sort(new_symbols.begin(), new_symbols.end(),
+			  [](const CodeSizeSymbol &a, const CodeSizeSymbol &b) { return a.size > b.size; });
+	symbols = new_symbols;
+
+	bool is_new_build;
+	nlohmann::json previous = history.LoadPrevious(project_directory, elf_time, is_new_build);
+	has_previous = false;
+	previous_sizes.clear();
+	if (previous.is_object() && previous["symbols"].is_array() &&
+		previous["code_bytes"].is_number_unsigned() &&
+		previous["data_bytes"].is_number_unsigned() && previous["bss_bytes"].is_number_unsigned()) {
+		has_previous = true;
+		previous_code_bytes = previous["code_bytes"].get<uintmax_t>();
+		previous_data_bytes = previous["data_bytes"].get<uintmax_t>();
+		previous_bss_bytes = previous["bss_bytes"].get<uintmax_t>();
+		for (auto &symbol : previous["symbols"]) {
+			if (!symbol.is_object() || !symbol["key"].is_string() ||
+				!symbol["size"].is_number_unsigned())
+				continue;
+
+			previous_sizes[symbol["key"].get<std::string>()] = symbol["size"].get<uintmax_t>();
+		}
+	}
+
+	nlohmann::json json = {
+		{"elf_time", elf_time},
+		{"code_bytes", code_bytes},
+		{"data_bytes", data_bytes},
+		{"bss_bytes", bss_bytes},
+		{"symbols", nlohmann::json::array()},
+	};
+	for (auto &symbol : symbols) {
+		json["symbols"].push_back({{"key", symbol.GetKey()},
+								   {"name", symbol.name},
+								   {"kind", symbol.is_function ? "function" : "data"},
+								   {"section", symbol.section},
+								   {"size", symbol.size},
+								   {"source", symbol.source},
+								   {"origin", symbol.origin}});
+	}
+	if (has_previous) {
+		json["previous"] = {
+			{"elf_time", previous["elf_time"]},
+			{"code_bytes", previous_code_bytes},
+			{"data_bytes", previous_data_bytes},
+			{"bss_bytes", previous_bss_bytes},
+			{"symbols", nlohmann::json::array()},
+		};
+		for (auto &[key, size] : previous_sizes) {
+			json["previous"]["symbols"].push_back({{"key", key}, {"size", size}});
+		}
+	}
+
+	history.Save(project_directory, json);
+
+	if (has_previous && is_new_build) {
+		uintmax_t total = code_bytes + data_bytes + bss_bytes;
+		uintmax_t previous_total = previous_code_bytes + previous_data_bytes + previous_bss_bytes;
+		console.AddLog("Code and data: %s (%s since the previous build).", format_kb(total).c_str(),
+					   format_code_delta(total, previous_total).c_str());
+	}
+
+	return true;
+}
+
+void CodeSizeReport::Draw(App &app) {
+	if (!is_open || !app.project.project_settings.IsOpen())
+		return;
+
+	// analyzes again once a build finishes
+	if (history.HasNewBuild(get_elf_path(app.project), elf_time))
+		Analyze(app.project);
+
+	ImGui::SetNextWindowSize(ImVec2(700, 500), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Code Size Report", &is_open)) {
+		if (ImGui::Button("Analyze"))
+			Analyze(app.project);
+		if (ImGui::IsItemHovered()) {
+			ImGui::SetTooltip("Saved to 'code_size_report.json' on the project folder.");
+		}
+
+		ImGui::SameLine();
+		ImGui::Text("Code: %s  Data: %s  BSS: %s (RDRAM: %s)", format_kb(code_bytes).c_str(),
+					format_kb(data_bytes).c_str(), format_kb(bss_bytes).c_str(),
+					format_kb(code_bytes + data_bytes + bss_bytes).c_str());
+		if (has_previous) {
+			ImGui::SameLine();
+			render_delta(code_bytes + data_bytes + bss_bytes,
+						 previous_code_bytes + previous_data_bytes + previous_bss_bytes);
+		}
+
+		if (!symbols.empty()) {
+			DrawOrigins();
+			DrawSymbols();
+		}
+	}
+	ImGui::End();
+}
+
+void CodeSizeReport::DrawOrigins() {
+	uintmax_t code[origin_count] = {}, data[origin_count] = {}, previous[origin_count] = {};
+	for (auto &symbol : symbols) {
+		int origin = (int)(std::find(origin_names, origin_names + origin_count, symbol.origin) -
+						   origin_names);
+		(symbol.is_function ? code : data)[origin] += symbol.size;
+
+		auto previous_size = previous_sizes.find(symbol.GetKey());
+		previous[origin] += previous_size != previous_sizes.end() ? previous_size->second : 0;
+	}
+
+	if (ImGui::BeginTable("CodeSizeOrigins", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("Origin");
+		ImGui::TableSetupColumn("Functions");
+		ImGui::TableSetupColumn("Data");
+		ImGui::TableSetupColumn("Total");
+		ImGui::TableSetupColumn("Change");
+		ImGui::TableHeadersRow();
+
+		for (int i = 0; i < origin_count; ++i) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			if (ImGui::Selectable(origin_names[i], origin_filter == i,
+								  ImGuiSelectableFlags_SpanAllColumns))
+				origin_filter = origin_filter == i ? -1 : i;
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(format_kb(code[i]).c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(format_kb(data[i]).c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(format_kb(code[i] + data[i]).c_str());
+			ImGui::TableNextColumn();
+			if (has_previous)
+				render_delta(code[i] + data[i], previous[i]);
+		}
+		ImGui::EndTable();
+	}
+}
+
+void CodeSizeReport::DrawSymbols() {
+	ImGui::InputText("Filter", name_filter, 100);
+	if (origin_filter >= 0) {
+		ImGui::SameLine();
+		ImGui::Text("(only %s)", origin_names[origin_filter]);
+	}
+
+	std::vector<const CodeSizeSymbol *> visible_symbols;
+	for (auto &symbol : symbols) {
+		if (origin_filter >= 0 && symbol.origin != origin_names[origin_filter])
+			continue;
+		if (name_filter[0] && symbol.name.find(name_filter) == std::string::npos)
+			continue;
+
+		visible_symbols.push_back(&symbol);
+	}
+
+	if (ImGui::BeginTable("CodeSizeSymbols", 5,
+						  ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+							  ImGuiTableFlags_ScrollY)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Symbol");
+		ImGui::TableSetupColumn("Section");
+		ImGui::TableSetupColumn("Source");
+		ImGui::TableSetupColumn("Size");
+		ImGui::TableSetupColumn("Change");
+		ImGui::TableHeadersRow();
+
+		// libdragon alone has thousands of symbols
+		ImGuiListClipper clipper;
+		clipper.Begin((int)visible_symbols.size());
+		while (clipper.Step()) {
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+				const CodeSizeSymbol *symbol = visible_symbols[i];
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(symbol->name.c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(symbol->section.c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(symbol->source.empty() ? "(libdragon)"
+															  : symbol->source.c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", (int)symbol->size);
+				ImGui::TableNextColumn();
+				if (has_previous) {
+					auto previous_size = previous_sizes.find(symbol->GetKey());
+					if (previous_size == previous_sizes.end())
+						ImGui::TextUnformatted("new");
+					else
+						render_delta(symbol->size, previous_size->second);
+				}
+			}
+		}
+		ImGui::EndTable();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "ReportHistory.h"
+
+class App;
+class Project;
+
+// A function or data object of the rom elf.
+struct CodeSizeSymbol {
+	std::string name;
+	bool is_function;
+	std::string section;
+	uintmax_t size;
+	// source of the object that defines it, empty when it comes from libdragon (or libc)
+	std::string source;
+	// 'scripts', 'generated', 'game', 'libdragon-extensions' or 'libdragon'
+	std::string origin;
+
+	// unique even for static symbols with the same name
+	[[nodiscard]] std::string GetKey() const {
+		return source + ":" + name;
+	}
+};
+
+// Largest functions and data of 'build/<rom>.elf', read straight from its symbol table and
+// attributed to the project objects, shown on the 'Code Size Report' window. Like the rom size
+// report, each analysis is saved to 'code_size_report.json' with the previous build for diffs.
+class CodeSizeReport {
+   public:
+	bool is_open;
+
+	CodeSizeReport();
+
+	bool Analyze(const Project &project);
+
+	void Draw(App &app);
+
+   private:
+	std::vector<CodeSizeSymbol> symbols;
+	uintmax_t code_bytes;
+	uintmax_t data_bytes;
+	uintmax_t bss_bytes;
+	int64_t elf_time;
+
+	bool has_previous;
+	std::map<std::string, uintmax_t> previous_sizes;
+	uintmax_t previous_code_bytes;
+	uintmax_t previous_data_bytes;
+	uintmax_t previous_bss_bytes;
+
+	int origin_filter;
+	char name_filter[100];
+	ReportHistory history;
+
+	void DrawOrigins();
+	void DrawSymbols();
+};
@@ -0,0 +1,273 @@
+#include "ColorQuantizer.h"
+
+#include <algorithm>
+#include <array>
+
+// number of k-means passes after the median cut
+const int refine_passes = 4;
+
+struct QuantizerColor {
+	float channels[3];
+	Uint32 count;
+};
+
+struct QuantizerBox {
+	size_t begin;
+	size_t end;
+	double error;
+	int split_channel;
+};
+
+static int color_key(int r5, int g5, int b5) {
+	return (r5 << 10) | (g5 << 5) | b5;
+}
+
+static float distance_squared(const float *a, const float *b) {
+	float dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+	// weights roughly following the perceived brightness of each channel
+	return dr * dr * 2.f + dg * dg * 4.f + db * db * 3.f;
+}
+
+// finds the channel with the most weighted variance inside the box
+static void measure_box(const std::vector<QuantizerColor> &colors, QuantizerBox &box) {
+	double sum[3] = {}, sum_squared[3] = {}, total = 0;
+	for (size_t i = box.begin; i < box.end; ++i) {
+		for (int c = 0; c < 3; ++c) {
+			sum[c] += (double)colors[i].channels[c] * colors[i].count;
+			sum_squared[c] +=
+				(double)colors[i].channels[c] * colors[i].channels[c] * colors[i].count;
+		}
+		total += colors[i].count;
+	}
+
+	box.error = 0;
+	box.split_channel = 0;
+	if (box.end - box.begin < 2)
+		return;
+
+	double best = -1;
+	for (int c = 0; c < 3; ++c) {
+		double variance = sum_squared[c] - sum[c] * sum[c] / total;
+		box.error += variance;
+		if (variance > best) {
+			best = variance;
+			box.split_channel = c;
+		}
+	}
+}
+
+ColorQuantizer::ColorQuantizer() : histogram(32768, 0), has_transparency(false) {
+}
+
+void ColorQuantizer::AddImage(SDL_Surface *surface) {
+	SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	if (!rgba)
+		return;
+
+	SDL_LockSurface(rgba);
+	for (int y = 0; y < rgba->h; ++y) {
+		const Uint8 *row = (const Uint8 *)rgba->pixels + (size_t)y * rgba->pitch;
+		for (int x = 0; x < rgba->w; ++x) {
+			const Uint8 *pixel = row + x * 4;
+			if (pixel[3] < 128) {
+				has_transparency = true;
+				continue;
+			}
+			histogram[color_key(pixel[0] >> 3, pixel[1] >> 3, pixel[2] >> 3)]++;
+		}
+	}
+	SDL_UnlockSurface(rgba);
+	SDL_FreeSurface(rgba);
+}
+
+void ColorQuantizer::BuildPalette(int max_colors) {
+	palette.clear();
+	nearest_cache.assign(32768, -1);
+
+	if (has_transparency) {
+		palette.push_back({0, 0, 0, 0});
+		--max_colors;
+	}
+
+	std::vector<QuantizerColor> colors;
+	for (int key = 0; key < 32768; ++key) {
+		if (histogram[key] > 0) {
+			colors.push_back({{(float)(key >> 10), (float)((key >> 5) & 31), (float)(key & 31)},
+							  histogram[key]});
+		}
+	}
+	if (colors.empty() || max_colors <= 0)
+		return;
+
+	// median cut, always splitting the box with the largest error
+	std::vector<QuantizerBox> boxes;
+	boxes.push_back({0, colors.size(), 0, 0});
+	measure_box(colors, boxes[0]);
+	while ((int)boxes.size() < max_colors) {
+		auto box = std::max_element(boxes.begin(), boxes.end(),
+									[](const QuantizerBox &a, const QuantizerBox &b) {
+										return a.error < b.error;
+									});
+		if (box->error <= 0)
+			break;
+
+		const int channel = box->split_channel;
+		std::sort(colors.begin() + (long)box->begin, colors.begin() + (long)box->end,
+				  [channel](const QuantizerColor &a, const QuantizerColor &b) {
+					  return a.channels[channel] < b.channels[channel];
+				  });
+
+		Uint64 total = 0;
+		for (size_t i = box->begin; i < box->end; ++i) {
+			total += colors[i].count;
+		}
+		size_t split = box->begin + 1;
+		Uint64 accumulated = colors[box->begin].count;
+		while (split < box->end - 1 && accumulated * 2 < total) {
+			accumulated += colors[split++].count;
+		}
+
+		QuantizerBox upper = {split, box->end, 0, 0};
+		box->end = split;
+		measure_box(colors, *box);
+		measure_box(colors, upper);
+		boxes.push_back(upper);
+	}
+
+	std::vector<std::array<float, 3>> centers;
+	for (auto &box : boxes) {
+		double sum[3] = {}, total = 0;
+		for (size_t i = box.begin; i < box.end; ++i) {
+			for (int c = 0; c < 3; ++c) {
+				sum[c] += (double)colors[i].channels[c] * colors[i].count;
+			}
+			total += colors[i].count;
+		}
+		centers.push_back({(float)(sum[0] / total), (float)(sum[1] / total),
+						   (float)(sum[2] / total)});
+	}
+
+	// k-means refinement, moving each center to the mean of the colors closest to it
+	for (int pass = 0; pass < refine_passes; ++pass) {
+		std::vector<std::array<double, 4>> sums(centers.size(), {0, 0, 0, 0});
+		for (auto &color : colors) {
+			size_t best = 0;
+			float best_distance = distance_squared(color.channels, centers[0].data());
+			for (size_t i = 1; i < centers.size(); ++i) {
+				float distance = distance_squared(color.channels, centers[i].data());
+				if (distance < best_distance) {
+					best_distance = distance;
+					best = i;
+				}
+			}
+			for (int c = 0; c < 3; ++c) {
+				sums[best][c] += (double)color.channels[c] * color.count;
+			}
+			sums[best][3] += color.count;
+		}
+
+		for (size_t i = 0; i < centers.size(); ++i) {
+			if (sums[i][3] > 0) {
+				for (int c = 0; c < 3; ++c) {
+					centers[i][c] = (float)(sums[i][c] / sums[i][3]);
+				}
+			}
+		}
+	}
+
+	for (auto &center : centers) {
+		Uint8 channels[3];
+		for (int c = 0; c < 3; ++c) {
+			int value = std::clamp((int)(center[c] + .5f), 0, 31);
+			channels[c] = (Uint8)((value << 3) | (value >> 2));
+		}
+		palette.push_back({channels[0], channels[1], channels[2], 255});
+	}
+}
+
+int ColorQuantizer::FindNearest(int r5, int g5, int b5) const {
+	int &cached = nearest_cache[color_key(r5, g5, b5)];
+	if (cached >= 0)
+		return cached;
+
+	const float color[3] = {(float)r5, (float)g5, (float)b5};
+	int best = -1;
+	float best_distance = 0;
+	for (size_t i = has_transparency ? 1 : 0; i < palette.size(); ++i) {
+		const float entry[3] = {(float)(palette[i].r >> 3), (float)(palette[i].g >> 3),
+								(float)(palette[i].b >> 3)};
+		float distance = distance_squared(color, entry);
+		if (best < 0 || distance < best_distance) {
+			best_distance = distance;
+			best = (int)i;
+		}
+	}
+
+	cached = std::max(best, 0);
+	return cached;
+}
+
+SDL_Surface *ColorQuantizer::Remap(SDL_Surface *surface, bool dither) const {
+	SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	if (!rgba)
+		return nullptr;
+
+	SDL_Surface *indexed =
+		SDL_CreateRGBSurfaceWithFormat(0, rgba->w, rgba->h, 8, SDL_PIXELFORMAT_INDEX8);
+	if (!indexed) {
+		SDL_FreeSurface(rgba);
+		return nullptr;
+	}
+	if (!palette.empty()) {
+		SDL_SetPaletteColors(indexed->format->palette, palette.data(), 0, (int)palette.size());
+	}
+
+	// error carried to the current and the next row
+	std::vector<float> errors((size_t)(rgba->w + 2) * 3 * 2, 0.f);
+	float *current = errors.data();
+	float *next = errors.data() + (size_t)(rgba->w + 2) * 3;
+
+	SDL_LockSurface(rgba);
+	SDL_LockSurface(indexed);
+	for (int y = 0; y < rgba->h; ++y) {
+		const Uint8 *row = (const Uint8 *)rgba->pixels + (size_t)y * rgba->pitch;
+		Uint8 *indexed_row = (Uint8 *)indexed->pixels + (size_t)y * indexed->pitch;
+		std::fill(next, next + (size_t)(rgba->w + 2) * 3, 0.f);
+
+		for (int x = 0; x < rgba->w; ++x) {
+			const Uint8 *pixel = row + x * 4;
+			if (pixel[3] < 128 && has_transparency) {
+				indexed_row[x] = 0;
+				continue;
+			}
+
+			float wanted[3];
+			int color5[3];
+			for (int c = 0; c < 3; ++c) {
+				wanted[c] = (float)pixel[c] + (dither ? current[(x + 1) * 3 + c] : 0.f);
+				color5[c] = std::clamp((int)(wanted[c] + 4.f) >> 3, 0, 31);
+			}
+
+			int index = palette.empty() ? 0 : FindNearest(color5[0], color5[1], color5[2]);
+			indexed_row[x] = (Uint8)index;
+
+			if (dither && !palette.empty()) {
+				const Uint8 found[3] = {palette[index].r, palette[index].g, palette[index].b};
+				for (int c = 0; c < 3; ++c) {
+					float error = wanted[c] - (float)found[c];
+					current[(x + 2) * 3 + c] += error * 7.f / 16.f;
+					next[x * 3 + c] += error * 3.f / 16.f;
+					next[(x + 1) * 3 + c] += error * 5.f / 16.f;
+					next[(x + 2) * 3 + c] += error * 1.f / 16.f;
+				}
+			}
+		}
+
+		std::swap(current, next);
+	}
+	SDL_UnlockSurface(indexed);
+	SDL_UnlockSurface(rgba);
+	SDL_FreeSurface(rgba);
+
+	return indexed;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+// Builds palettes for color indexed sprites. Colors are reduced to RGBA 5551, the format of the
+// N64 palettes (TLUT), and pixels with alpha below 128 always use index 0.
+//
+// Images are added first (more than one to share a palette), then the palette is built with a
+// variance based median cut refined by a few k-means passes.
+class ColorQuantizer {
+   public:
+	ColorQuantizer();
+
+	void AddImage(SDL_Surface *surface);
+	void BuildPalette(int max_colors);
+
+	[[nodiscard]] const std::vector<SDL_Color> &GetPalette() const {
+		return palette;
+	}
+
+	// returns an 8 bits surface using the palette, with optional Floyd-Steinberg dithering
+	[[nodiscard]] SDL_Surface *Remap(SDL_Surface *surface, bool dither) const;
+
+   private:
+	// pixel count of each RGB 555 color
+	std::vector<Uint32> histogram;
+	bool has_transparency;
+
+	std::vector<SDL_Color> palette;
+	// nearest palette index for each RGB 555 color, filled while remapping
+	mutable std::vector<int> nearest_cache;
+
+	[[nodiscard]] int FindNearest(int r5, int g5, int b5) const;
+};
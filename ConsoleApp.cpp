@@ -1,5 +1,7 @@
 #include "ConsoleApp.h"
 
+#include "Sdl.h"
+
 // Portable helpers
 static char *Strdup(const char *s) {
 	IM_ASSERT(s);
@@ -41,6 +43,8 @@ void ConsoleApp::AddLog(const char *fmt, ...) {
 	buf[IM_ARRAYSIZE(buf) - 1] = 0;
 	va_end(args);
 	Items.push_back(Strdup(buf));
+
+	Sdl::WakeUp();
 }
 
 void ConsoleApp::Draw(const char *title, SDL_Window *window, bool &is_open) {
@@ -10,6 +10,7 @@
 #include "ConsoleApp.h"
 #include "Libdragon.h"
 #include "ThreadCommand.h"
+#include "audio/SoundProcessor.h"
 #include "pugixml/pugixml.hpp"
 
 extern App *g_app;
@@ -23,31 +24,141 @@ void Content::CreateSprites(const EngineSettings &engine_settings,
 	console.AddLog("Building sprite assets...");
 
 	for (auto &image : images) {
-		std::stringstream command;
-		std::string dfs_output_path = "build/filesystem" + image->dfs_folder;
-		std::filesystem::create_directories(project_settings.project_directory + "/" +
-											dfs_output_path);
+		// built with their atlas
+		if (!image->atlas_group.empty())
+			continue;
 
-		// copy to temp folder (build/temp/sprites) as png
-		std::string temp_directory = project_settings.project_directory + "/build/temp/sprites/";
-		std::string temp_filepath = temp_directory + image->name + ".png";
-		std::filesystem::create_directories(temp_directory);
+		CreateSprite(engine_settings, project_settings, *image, images);
+	}
 
-		std::string image_full_path = project_settings.project_directory + "/" + image->image_path;
-		SDL_Surface *image_surface = IMG_Load(image_full_path.c_str());
-		IMG_SavePNG(image_surface, temp_filepath.c_str());
+	CreateAtlases(engine_settings, project_settings, images);
+}
+
+void Content::CreateSprite(const EngineSettings &engine_settings,
+						   const ProjectSettings &project_settings, const LibdragonImage &image,
+						   const std::vector<std::unique_ptr<LibdragonImage>> &images) {
+	std::stringstream command;
+	std::string dfs_output_path = "build/filesystem" + image.dfs_folder;
+	std::filesystem::create_directories(project_settings.project_directory + "/" +
+										dfs_output_path);
+
+	// copy to temp folder (build/temp/sprites) as png
+	std::string temp_directory = project_settings.project_directory + "/build/temp/sprites/";
+	std::string temp_filepath = temp_directory + image.name + ".png";
+	std::filesystem::create_directories(temp_directory);
+
+	const int default_bits = project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32;
+
+	// only the new mksprite ('--format') knows about the formats that are not RGBA
+	bool use_format_flag = image.format != SPRITE_FORMAT_DEFAULT &&
+						   image.format != SPRITE_FORMAT_RGBA16 &&
+						   image.format != SPRITE_FORMAT_RGBA32;
+	if (use_format_flag && project_settings.libdragon_branch == "trunk") {
+		console.AddLog(
+			"[error] Sprite '%s' uses the %s format, which is not supported by libdragon 'trunk'. "
+			"Building it with the display bit depth.",
+			image.name.c_str(), get_libdragon_sprite_format_name(image.format).c_str());
+		use_format_flag = false;
+	}
+
+	// indexed sprites are quantized here, so palettes can be shared between sprites
+	SDL_Surface *image_surface;
+	if (use_format_flag && is_libdragon_sprite_format_indexed(image.format)) {
+		image_surface =
+			image.LoadFormatSurface(project_settings.project_directory, images, default_bits);
+	} else {
+		std::string image_full_path = project_settings.project_directory + "/" + image.image_path;
+		image_surface = IMG_Load(image_full_path.c_str());
+	}
+
+	// the offsets on 'game.gen.h' come from the same trim
+	if (image.trim && image_surface) {
+		SpriteTrim trim = image.LoadTrim(project_settings.project_directory);
+		SDL_Surface *trimmed_surface =
+			create_trimmed_surface(image_surface, trim, image.h_slices, image.v_slices);
 		SDL_FreeSurface(image_surface);
+		image_surface = trimmed_surface;
+	}
 
-		std::string build_temp_image_path = "build/temp/sprites/" + image->name + ".png";
-		command << "/n64_toolchain/bin/mksprite "
-				<< (project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32) << " "
-				<< image->h_slices << " " << image->v_slices << " " << build_temp_image_path << " "
-				<< dfs_output_path + image->name + ".sprite";
+	int tile_width = image.width / std::max(image.h_slices, 1);
+	int tile_height = image.height / std::max(image.v_slices, 1);
+	if (image_surface) {
+		tile_width = image_surface->w / std::max(image.h_slices, 1);
+		tile_height = image_surface->h / std::max(image.v_slices, 1);
+	}
+
+	IMG_SavePNG(image_surface, temp_filepath.c_str());
+	SDL_FreeSurface(image_surface);
+
+	std::string build_temp_image_path = "build/temp/sprites/" + image.name + ".png";
+	if (use_format_flag) {
+		command << "/n64_toolchain/bin/mksprite --format "
+				<< get_libdragon_sprite_format_name(image.format) << " --tiles " << tile_width
+				<< "," << tile_height << " --output " << dfs_output_path << " "
+				<< build_temp_image_path;
+	} else {
+		bool is_rgba = image.format == SPRITE_FORMAT_RGBA16 || image.format == SPRITE_FORMAT_RGBA32;
+		int bits = is_rgba ? get_libdragon_sprite_format_bits(image.format, default_bits)
+						   : default_bits;
+		command << "/n64_toolchain/bin/mksprite " << bits << " "
+				<< image.h_slices << " " << image.v_slices << " " << build_temp_image_path << " "
+				<< dfs_output_path + image.name + ".sprite";
+	}
+
+	Libdragon::Exec(g_app, command.str());
+}
+
+void Content::CreateAtlases(const EngineSettings &engine_settings,
+							const ProjectSettings &project_settings,
+							const std::vector<std::unique_ptr<LibdragonImage>> &images) {
+	// groups that are gone (or got empty) must not leave their sheet on the filesystem
+	std::filesystem::remove_all(project_settings.project_directory + "/build/filesystem/atlases");
 
-		Libdragon::Exec(g_app, command.str());
+	for (auto &atlas : pack_sprite_atlases(images)) {
+		CreateAtlas(engine_settings, project_settings, atlas);
 	}
 }
 
+void Content::CreateAtlas(const EngineSettings &engine_settings,
+						  const ProjectSettings &project_settings, const SpriteAtlas &atlas) {
+	std::stringstream command;
+	std::string dfs_output_path = "build/filesystem/atlases/";
+	std::filesystem::create_directories(project_settings.project_directory + "/" +
+										dfs_output_path);
+
+	std::string temp_directory = project_settings.project_directory + "/build/temp/atlases/";
+	std::string temp_filepath = temp_directory + atlas.name + ".png";
+	std::filesystem::create_directories(temp_directory);
+
+	// new surfaces are cleared, so the padding is transparent
+	SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas.width, atlas.height, 32,
+														SDL_PIXELFORMAT_RGBA32);
+	for (auto &sprite : atlas.sprites) {
+		std::string image_full_path =
+			project_settings.project_directory + "/" + sprite.image->image_path;
+		SDL_Surface *image_surface = IMG_Load(image_full_path.c_str());
+		if (!image_surface) {
+			console.AddLog("[error] Could not load '%s' for atlas '%s'.",
+						   sprite.image->image_path.c_str(), atlas.name.c_str());
+			continue;
+		}
+
+		SDL_SetSurfaceBlendMode(image_surface, SDL_BLENDMODE_NONE);
+		SDL_Rect destination = {sprite.x, sprite.y, image_surface->w, image_surface->h};
+		SDL_BlitSurface(image_surface, nullptr, sheet, &destination);
+		SDL_FreeSurface(image_surface);
+	}
+	IMG_SavePNG(sheet, temp_filepath.c_str());
+	SDL_FreeSurface(sheet);
+
+	std::string build_temp_image_path = "build/temp/atlases/" + atlas.name + ".png";
+	command << "/n64_toolchain/bin/mksprite "
+			<< (project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32) << " 1 1 "
+			<< build_temp_image_path << " " << dfs_output_path + atlas.name + ".sprite";
+
+	Libdragon::Exec(g_app, command.str());
+}
+
 void Content::CreateSounds(const EngineSettings &engine_settings,
 						   const ProjectSettings &project_settings,
 						   const std::vector<std::unique_ptr<LibdragonSound>> &sounds) {
@@ -57,17 +168,40 @@ void Content::CreateSounds(const EngineSettings &engine_settings,
 	console.AddLog("Building sound assets...");
 
 	for (auto &sound : sounds) {
-		std::stringstream command;
-		std::string dfs_output_path = "build/filesystem" + sound->dfs_folder;
-		std::filesystem::create_directories(project_settings.project_directory + "/" +
-											dfs_output_path);
+		CreateSound(engine_settings, project_settings, *sound);
+	}
+}
 
-		command << "/n64_toolchain/bin/audioconv64 " << sound->GetLibdragonGenFlags() << " -o "
-				<< dfs_output_path + sound->name + sound->GetLibdragonExtension() << " "
-				<< sound->sound_path;
+void Content::CreateSound(const EngineSettings &engine_settings,
+						  const ProjectSettings &project_settings, const LibdragonSound &sound) {
+	std::stringstream command;
+	std::string dfs_output_path = "build/filesystem" + sound.dfs_folder;
+	std::filesystem::create_directories(project_settings.project_directory + "/" +
+										dfs_output_path);
+
+	// resample, downmix and reduce the bit depth of waves before converting them
+	LibdragonSound converted_sound = sound;
+	WavInfo info;
+	std::string sound_full_path = project_settings.project_directory + "/" + sound.sound_path;
+	SoundProcessOptions options = sound.GetProcessOptions(project_settings.audio);
+	if (sound.type == SOUND_WAV && read_wav_info(sound_full_path, info) &&
+		needs_processing(info, options)) {
+		std::string temp_directory = project_settings.project_directory + "/build/temp/sounds/";
+		std::filesystem::create_directories(temp_directory);
 
-		Libdragon::Exec(g_app, command.str());
+		if (process_sound(sound_full_path, temp_directory + sound.name + ".wav", options)) {
+			SoundFormat format = get_processed_format(info, options);
+			converted_sound.sound_path = "build/temp/sounds/" + sound.name + ".wav";
+			converted_sound.wav_loop_offset =
+				(int)((Sint64)sound.wav_loop_offset * format.rate / info.rate);
+		}
 	}
+
+	command << "/n64_toolchain/bin/audioconv64 " << converted_sound.GetLibdragonGenFlags()
+			<< " -o " << dfs_output_path + sound.name + sound.GetLibdragonExtension() << " "
+			<< converted_sound.sound_path;
+
+	Libdragon::Exec(g_app, command.str());
 }
 
 void Content::CreateGeneralFiles(const EngineSettings &engine_settings,
@@ -79,17 +213,23 @@ void Content::CreateGeneralFiles(const EngineSettings &engine_settings,
 	console.AddLog("Building general assets...");
 
 	for (auto &file : files) {
-		if (file->copy_to_filesystem) {
-			std::stringstream command;
-			std::string dfs_output_path = "build/filesystem" + file->dfs_folder;
-			std::filesystem::create_directories(project_settings.project_directory + "/" +
-												dfs_output_path);
+		CreateGeneralFile(engine_settings, project_settings, *file);
+	}
+}
 
-			command << "cp \"" << file->file_path << "\" \""
-					<< dfs_output_path + file->GetFilename() << "\"";
+void Content::CreateGeneralFile(const EngineSettings &engine_settings,
+								const ProjectSettings &project_settings,
+								const LibdragonFile &file) {
+	if (file.copy_to_filesystem) {
+		std::stringstream command;
+		std::string dfs_output_path = "build/filesystem" + file.dfs_folder;
+		std::filesystem::create_directories(project_settings.project_directory + "/" +
+											dfs_output_path);
 
-			ThreadCommand::QueueCommand(command.str());
-		}
+		command << "cp \"" << file.file_path << "\" \""
+				<< dfs_output_path + file.GetFilename() << "\"";
+
+		ThreadCommand::QueueCommand(command.str());
 	}
 }
 
@@ -102,31 +242,36 @@ void Content::CreateFonts(const EngineSettings &engine_settings,
 	console.AddLog("Building font assets...");
 
 	for (auto &font : fonts) {
-		std::stringstream command;
-		std::string dfs_output_path = "build/filesystem" + font->dfs_folder;
-		std::filesystem::create_directories(project_settings.project_directory + "/" +
-											dfs_output_path);
-
-		// copy to temp folder (build/temp/sprites) as png
-		std::string temp_directory = project_settings.project_directory + "/build/temp/fonts/";
-		std::string temp_filepath = temp_directory + font->name + ".png";
-		std::filesystem::create_directories(temp_directory);
-
-		std::string image_full_path = project_settings.project_directory + "/" + font->font_path;
-		SDL_Surface *image_surface = LibdragonFont::LoadSurfaceFromFont(
-			image_full_path.c_str(), font->font_size, g_app->renderer);
-		IMG_SavePNG(image_surface, temp_filepath.c_str());
-		SDL_FreeSurface(image_surface);
-
-		std::string build_temp_image_path = "build/temp/fonts/" + font->name + ".png";
-		command << "/n64_toolchain/bin/mksprite "
-				<< (project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32) << " 16 8 "
-				<< build_temp_image_path << " " << dfs_output_path + font->name + ".font";
-
-		Libdragon::Exec(g_app, command.str());
+		CreateFont(engine_settings, project_settings, *font);
 	}
 }
 
+void Content::CreateFont(const EngineSettings &engine_settings,
+						 const ProjectSettings &project_settings, const LibdragonFont &font) {
+	std::stringstream command;
+	std::string dfs_output_path = "build/filesystem" + font.dfs_folder;
+	std::filesystem::create_directories(project_settings.project_directory + "/" +
+										dfs_output_path);
+
+	// copy to temp folder (build/temp/sprites) as png
+	std::string temp_directory = project_settings.project_directory + "/build/temp/fonts/";
+	std::string temp_filepath = temp_directory + font.name + ".png";
+	std::filesystem::create_directories(temp_directory);
+
+	std::string image_full_path = project_settings.project_directory + "/" + font.font_path;
+	SDL_Surface *image_surface = LibdragonFont::LoadSurfaceFromFont(
+		image_full_path.c_str(), font.font_size, g_app->renderer);
+	IMG_SavePNG(image_surface, temp_filepath.c_str());
+	SDL_FreeSurface(image_surface);
+
+	std::string build_temp_image_path = "build/temp/fonts/" + font.name + ".png";
+	command << "/n64_toolchain/bin/mksprite "
+			<< (project_settings.display.bit_depth == DEPTH_16_BPP ? 16 : 32) << " 16 8 "
+			<< build_temp_image_path << " " << dfs_output_path + font.name + ".font";
+
+	Libdragon::Exec(g_app, command.str());
+}
+
 void Content::CreateTiledMaps(const EngineSettings &engine_settings,
 							  const ProjectSettings &project_settings,
 							  const std::vector<std::unique_ptr<LibdragonTiledMap>> &maps) {
@@ -136,54 +281,60 @@ void Content::CreateTiledMaps(const EngineSettings &engine_settings,
 	console.AddLog("Building tile maps assets...");
 
 	for (auto &map : maps) {
-		std::string dfs_output_path = "build/filesystem" + map->dfs_folder + map->name + "/";
-		std::filesystem::create_directories(project_settings.project_directory + "/" +
-											dfs_output_path);
+		CreateTiledMap(engine_settings, project_settings, *map);
+	}
+}
 
-		std::string file_path = project_settings.project_directory + "/" + map->file_path;
+void Content::CreateTiledMap(const EngineSettings &engine_settings,
+							 const ProjectSettings &project_settings,
+							 const LibdragonTiledMap &map) {
+	std::string dfs_output_path = "build/filesystem" + map.dfs_folder + map.name + "/";
+	std::filesystem::create_directories(project_settings.project_directory + "/" +
+										dfs_output_path);
 
-		pugi::xml_document tmx_file;
+	std::string file_path = project_settings.project_directory + "/" + map.file_path;
 
-		auto result = tmx_file.load_file(file_path.c_str());
-		if (result.status != pugi::status_ok) {
-			console.AddLog("Error loading tiled map: %s", result.description());
-			continue;
-		}
+	pugi::xml_document tmx_file;
+
+	auto result = tmx_file.load_file(file_path.c_str());
+	if (result.status != pugi::status_ok) {
+		console.AddLog("Error loading tiled map: %s", result.description());
+		return;
+	}
 
-		auto xml_layers = tmx_file.child("map").children("layer");
-		for (auto &xml_layer : xml_layers) {
-			std::string output_file_path = dfs_output_path + xml_layer.attribute("name").value() +
-										   ".map";
+	auto xml_layers = tmx_file.child("map").children("layer");
+	for (auto &xml_layer : xml_layers) {
+		std::string output_file_path = dfs_output_path + xml_layer.attribute("name").value() +
+									   ".map";
 
-			int width = xml_layer.attribute("width").as_int();
+		int width = xml_layer.attribute("width").as_int();
 
-			std::stringstream layer_map;
-			std::string tile_string;
-			int cur_width = 0;
+		std::stringstream layer_map;
+		std::string tile_string;
+		int cur_width = 0;
 
-			std::string csv_map = xml_layer.child_value("data");
-			std::istringstream csv_stream(csv_map);
-			while (std::getline(csv_stream, tile_string, ',')) {
-				int tile = std::stoi(tile_string);
-				--tile;
+		std::string csv_map = xml_layer.child_value("data");
+		std::istringstream csv_stream(csv_map);
+		while (std::getline(csv_stream, tile_string, ',')) {
+			int tile = std::stoi(tile_string);
+			--tile;
 
-				layer_map << tile;
+			layer_map << tile;
 
-				++cur_width;
-				if (cur_width >= width) {
-					cur_width = 0;
-					layer_map << "\n";
-				} else {
-					layer_map << ",";
-				}
+			++cur_width;
+			if (cur_width >= width) {
+				cur_width = 0;
+				layer_map << "\n";
+			} else {
+				layer_map << ",";
 			}
+		}
 
-			std::ofstream layer_file(output_file_path);
-			layer_file << layer_map.str();
-			layer_file.close();
+		std::ofstream layer_file(output_file_path);
+		layer_file << layer_map.str();
+		layer_file.close();
 
-			console.AddLog("Created map file at %s", output_file_path.c_str());
-		}
+		console.AddLog("Created map file at %s", output_file_path.c_str());
 	}
 }
 
@@ -196,74 +347,79 @@ void Content::CreateLDtkMaps(const EngineSettings &engine_settings,
 	console.AddLog("Building ldtk maps assets...");
 
 	for (auto &map : maps) {
-		std::string dfs_output_path = "build/filesystem" + map->dfs_folder + map->name + "/";
-		std::filesystem::create_directories(project_settings.project_directory + "/" +
-											dfs_output_path);
+		CreateLDtkMap(engine_settings, project_settings, *map);
+	}
+}
 
-		std::string file_path = project_settings.project_directory + "/" + map->file_path;
+void Content::CreateLDtkMap(const EngineSettings &engine_settings,
+							const ProjectSettings &project_settings, const LibdragonLDtkMap &map) {
+	std::string dfs_output_path = "build/filesystem" + map.dfs_folder + map.name + "/";
+	std::filesystem::create_directories(project_settings.project_directory + "/" +
+										dfs_output_path);
 
-		ldtk::Project project;
+	std::string file_path = project_settings.project_directory + "/" + map.file_path;
 
-		try {
-			project.loadFromFile(file_path);
-		} catch (std::exception &ex) {
-			console.AddLog("Error loading ldtk map: %s", ex.what());
-			continue;
-		}
+	ldtk::Project project;
+
+	try {
+		project.loadFromFile(file_path);
+	} catch (std::exception &ex) {
+		console.AddLog("Error loading ldtk map: %s", ex.what());
+		return;
+	}
 
-		std::vector<LibdragonMapLayer> layers;
+	std::vector<LibdragonMapLayer> layers;
 
-		for (auto &world : project.allWorlds()) {
-			for (const auto &level : world.allLevels()) {
-				std::string level_name(level.name);
+	for (auto &world : project.allWorlds()) {
+		for (const auto &level : world.allLevels()) {
+			std::string level_name(level.name);
 
-				std::string level_output_dir = project_settings.project_directory + "/" +
-											   dfs_output_path + level_name;
-				std::filesystem::create_directories(level_output_dir);
+			std::string level_output_dir = project_settings.project_directory + "/" +
+										   dfs_output_path + level_name;
+			std::filesystem::create_directories(level_output_dir);
 
-				for (const auto &layer : level.allLayers()) {
-					if (layer.allTiles().empty())
-						continue;
+			for (const auto &layer : level.allLayers()) {
+				if (layer.allTiles().empty())
+					continue;
 
-					std::string layer_output_dir = level_output_dir + "/" + layer.getName() +
-												   ".map";
+				std::string layer_output_dir = level_output_dir + "/" + layer.getName() +
+											   ".map";
 
-					{
-						const size_t map_size = layer.getGridSize().x * layer.getGridSize().y;
-						std::vector<int> map_output;
-						map_output.reserve(map_size);
-						for (size_t i = 0; i < map_size; ++i) {
-							map_output.push_back(-1);
-						}
+				{
+					const size_t map_size = layer.getGridSize().x * layer.getGridSize().y;
+					std::vector<int> map_output;
+					map_output.reserve(map_size);
+					for (size_t i = 0; i < map_size; ++i) {
+						map_output.push_back(-1);
+					}
 
-						for (const auto &tile : layer.allTiles()) {
-							map_output[tile.coordId] = tile.tileId;
-						}
+					for (const auto &tile : layer.allTiles()) {
+						map_output[tile.coordId] = tile.tileId;
+					}
 
-						std::ofstream file(layer_output_dir);
+					std::ofstream file(layer_output_dir);
 
-						int coord_id = 0;
-						for (auto &tile : map_output) {
-							file << tile;
+					int coord_id = 0;
+					for (auto &tile : map_output) {
+						file << tile;
 
-							if (coord_id % layer.getGridSize().x == layer.getGridSize().x - 1)
-								file << "\n";
-							else
-								file << ",";
+						if (coord_id % layer.getGridSize().x == layer.getGridSize().x - 1)
+							file << "\n";
+						else
+							file << ",";
 
-							++coord_id;
-						}
+						++coord_id;
+					}
 
-						// replace last ',' to a new line
-						file.seekp(file.tellp() - std::streampos(1));
-						file << "\n";
+					// replace last ',' to a new line
+					file.seekp(file.tellp() - std::streampos(1));
+					file << "\n";
 
-						file.close();
+					file.close();
 
-						console.AddLog("Created map file at %s", layer_output_dir.c_str());
-					}
+					console.AddLog("Created map file at %s", layer_output_dir.c_str());
 				}
 			}
 		}
 	}
-}
\ No newline at end of file
+}
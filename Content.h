@@ -9,6 +9,7 @@
 #include "LibdragonLDtkMap.h"
 #include "LibdragonSound.h"
 #include "LibdragonTiledMap.h"
+#include "SpriteAtlas.h"
 #include "settings/EngineSettings.h"
 #include "settings/ProjectSettings.h"
 
@@ -17,6 +18,9 @@ class Content {
 	static void CreateSprites(const EngineSettings &engine_settings,
 							  const ProjectSettings &project_settings,
 							  const std::vector<std::unique_ptr<LibdragonImage>> &images);
+	static void CreateAtlases(const EngineSettings &engine_settings,
+							  const ProjectSettings &project_settings,
+							  const std::vector<std::unique_ptr<LibdragonImage>> &images);
 	static void CreateSounds(const EngineSettings &engine_settings,
 							 const ProjectSettings &project_settings,
 							 const std::vector<std::unique_ptr<LibdragonSound>> &sounds);
@@ -32,4 +36,23 @@ class Content {
 	static void CreateLDtkMaps(const EngineSettings &engine_settings,
 								const ProjectSettings &project_settings,
 								const std::vector<std::unique_ptr<LibdragonLDtkMap>> &maps);
+
+	// 'images' is used to build the palettes shared with other sprites
+	static void CreateSprite(const EngineSettings &engine_settings,
+							 const ProjectSettings &project_settings, const LibdragonImage &image,
+							 const std::vector<std::unique_ptr<LibdragonImage>> &images);
+	static void CreateAtlas(const EngineSettings &engine_settings,
+							const ProjectSettings &project_settings, const SpriteAtlas &atlas);
+	static void CreateSound(const EngineSettings &engine_settings,
+							const ProjectSettings &project_settings, const LibdragonSound &sound);
+	static void CreateGeneralFile(const EngineSettings &engine_settings,
+								  const ProjectSettings &project_settings,
+								  const LibdragonFile &file);
+	static void CreateFont(const EngineSettings &engine_settings,
+						   const ProjectSettings &project_settings, const LibdragonFont &font);
+	static void CreateTiledMap(const EngineSettings &engine_settings,
+							   const ProjectSettings &project_settings,
+							   const LibdragonTiledMap &map);
+	static void CreateLDtkMap(const EngineSettings &engine_settings,
+							  const ProjectSettings &project_settings, const LibdragonLDtkMap &map);
 };
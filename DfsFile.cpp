@@ -0,0 +1,68 @@
+#include "DfsFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// from libdragon's dfs_internal.h
+const uint32_t dfs_flags_dir = 0x10000000;
+const uint32_t dfs_size_mask = 0x0FFFFFFF;
+const uint32_t dfs_entry_size = 256;
+const char *dfs_root_path = "DragonFS 2.0";
+const int dfs_max_depth = 32;
+
+static uint32_t read_be32(const std::vector<uint8_t> &data, uint32_t offset) {
+	return (uint32_t)data[offset] << 24 | (uint32_t)data[offset + 1] << 16 |
+		   (uint32_t)data[offset + 2] << 8 | (uint32_t)data[offset + 3];
+}
+
+static bool read_directory(const std::vector<uint8_t> &data, uint32_t offset,
+						   const std::string &directory, int depth,
+						   std::map<std::string, DfsFileEntry> &entries) {
+	if (depth > dfs_max_depth)
+		return false;
+
+	// each entry: next entry, file pointer, flags (and size), then the name
+	while (offset != 0) {
+		if ((uint64_t)offset + dfs_entry_size > data.size())
+			return false;
+
+		uint32_t next_entry = read_be32(data, offset);
+		uint32_t file_pointer = read_be32(data, offset + 4);
+		uint32_t flags = read_be32(data, offset + 8);
+		const char *name = (const char *)&data[offset + 12];
+		std::string entry_path = directory + std::string(name, strnlen(name, dfs_entry_size - 12));
+
+		if (flags & dfs_flags_dir) {
+			if (file_pointer != 0 &&
+				!read_directory(data, file_pointer, entry_path + "/", depth + 1, entries))
+				return false;
+		} else {
+			entries[entry_path] = {file_pointer, flags & dfs_size_mask};
+		}
+
+		offset = next_entry;
+	}
+
+	return true;
+}
+
+bool read_dfs_entries(const std::string &path, std::map<std::string, DfsFileEntry> &entries) {
+	entries.clear();
+
+	std::ifstream filestream(path, std::ios::binary);
+	if (!filestream.is_open())
+		return false;
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(filestream)),
+							  std::istreambuf_iterator<char>());
+	filestream.close();
+
+	if (data.size() < dfs_entry_size ||
+		strncmp((const char *)&data[12], dfs_root_path, strlen(dfs_root_path)) != 0)
+		return false;
+
+	uint32_t first_entry = read_be32(data, 4);
+	return first_entry == 0 || read_directory(data, first_entry, "/", 0, entries);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+struct DfsFileEntry {
+	// from the start of the filesystem
+	uint32_t offset;
+	uint32_t size;
+};
+
+// Reads the directory tree of a DragonFS image (as built by mkdfs), keyed by the path used on
+// 'dfs_open' ("/sprites/coin.sprite").
+bool read_dfs_entries(const std::string &path, std::map<std::string, DfsFileEntry> &entries);
@@ -12,25 +12,32 @@ struct DroppedImage {
 	LibdragonImageType type;
 
 	SDL_Texture *image_data;
-	SDL_Texture *image_data_overlay;
 	int w, h;
 	float width_mult, height_mult;
+	// size of the image file, 'w' and 'h' are the preview size
+	int image_width, image_height;
 
 	char name[50] = "\0";
 	char dfs_folder[100] = "/\0";
 	int h_slices, v_slices;
+	bool trim;
+	// texels saved by 'trim', refreshed with the slices
+	int trim_saved_texels;
 
 	DroppedImage(const char *image_path, LibdragonImageType type)
 		: image_path(image_path),
 		  type(type),
 		  image_data(nullptr),
-		  image_data_overlay(nullptr),
 		  w(0),
 		  h(0),
 		  width_mult(1),
 		  height_mult(1),
+		  image_width(0),
+		  image_height(0),
 		  h_slices(1),
-		  v_slices(1) {
+		  v_slices(1),
+		  trim(false),
+		  trim_saved_texels(0) {
 	}
 };
 
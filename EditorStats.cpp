@@ -0,0 +1,227 @@
+#include "EditorStats.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "imgui.h"
+
+#include "App.h"
+#include "ConsoleApp.h"
+#include "TextureResidency.h"
+#include "ThreadCommand.h"
+#include "json.hpp"
+
+const Uint64 capture_duration_seconds = 10;
+
+static const char *section_names[STATS_SECTION_COUNT] = {"Update", "ImGui Render", "Present"};
+
+static float ticks_to_ms(Uint64 ticks) {
+	return (float)((double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+static Uint64 ticks_to_us(Uint64 ticks) {
+	return ticks * 1000000 / SDL_GetPerformanceFrequency();
+}
+
+static void add_texture(SDL_Texture *texture, int &count, size_t &bytes) {
+	if (!texture)
+		return;
+
+	++count;
+	bytes += texture_bytes(texture);
+}
+
+static float average(const float *values, int count) {
+	float total = 0;
+	for (int i = 0; i < count; ++i) {
+		total += values[i];
+	}
+	return total / (float)count;
+}
+
+EditorStats::EditorStats()
+	: is_open(false),
+	  frame_times(),
+	  frame_intervals(),
+	  section_times(),
+	  history_index(0),
+	  frame_start(0),
+	  section_start(0),
+	  last_frame_start(0),
+	  capture_start(0),
+	  capture_end(0) {
+}
+
+void EditorStats::BeginFrame() {
+	last_frame_start = frame_start;
+	frame_start = SDL_GetPerformanceCounter();
+	section_start = frame_start;
+
+	for (auto &section : section_times) {
+		section[history_index] = 0;
+	}
+}
+
+void EditorStats::EndSection(EditorStatsSection section) {
+	Uint64 now = SDL_GetPerformanceCounter();
+	section_times[section][history_index] = ticks_to_ms(now - section_start);
+	section_start = now;
+}
+
+void EditorStats::EndFrame() {
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	frame_times[history_index] = ticks_to_ms(now - frame_start);
+	frame_intervals[history_index] = last_frame_start ? ticks_to_ms(frame_start - last_frame_start)
+													  : 0;
+
+	if (IsCapturing()) {
+		CapturedFrame frame = {};
+		frame.start = frame_start;
+
+		for (int i = 0; i < STATS_SECTION_COUNT; ++i) {
+			frame.sections[i] = (Uint64)(section_times[i][history_index] *
+										 (double)SDL_GetPerformanceFrequency() / 1000.0);
+		}
+		captured_frames.push_back(frame);
+
+		if (now >= capture_end)
+			SaveCapture();
+	}
+
+	history_index = (history_index + 1) % history_size;
+}
+
+void EditorStats::StartCapture(const std::string &trace_directory) {
+	captured_frames.clear();
+	capture_directory = trace_directory;
+	capture_start = SDL_GetPerformanceCounter();
+	capture_end = capture_start + capture_duration_seconds * SDL_GetPerformanceFrequency();
+
+	console.AddLog("Capturing frames for %d seconds...", (int)capture_duration_seconds);
+}
+
+void EditorStats::SaveCapture() {
+	nlohmann::json json;
+	json["displayTimeUnit"] = "ms";
+	json["traceEvents"] = nlohmann::json::array();
+
+	for (auto &frame : captured_frames) {
+		Uint64 start = frame.start - capture_start;
+
+		Uint64 frame_duration = 0;
+		for (auto section : frame.sections) {
+			frame_duration += section;
+		}
+
+		json["traceEvents"].push_back({{"name", "Frame"},
+									   {"ph", "X"},
+									   {"pid", 1},
+									   {"tid", 1},
+									   {"ts", ticks_to_us(start)},
+									   {"dur", ticks_to_us(frame_duration)}});
+
+		for (int i = 0; i < STATS_SECTION_COUNT; ++i) {
+			json["traceEvents"].push_back({{"name", section_names[i]},
+										   {"ph", "X"},
+										   {"pid", 1},
+										   {"tid", 1},
+										   {"ts", ticks_to_us(start)},
+										   {"dur", ticks_to_us(frame.sections[i])}});
+			start += frame.sections[i];
+		}
+	}
+
+	std::filesystem::create_directories(capture_directory);
+	std::string filepath = capture_directory + "/trace_" + std::to_string(SDL_GetTicks()) +
+						   ".json";
+
+	std::ofstream filestream(filepath);
+	filestream << json.dump() << std::endl;
+	filestream.close();
+
+	console.AddLog("! Trace with %d frames saved to '%s'.", (int)captured_frames.size(),
+				   filepath.c_str());
+
+	captured_frames.clear();
+	capture_end = 0;
+}
+
+void EditorStats::Draw(App &app) {
+	if (!is_open)
+		return;
+
+	ImGui::SetNextWindowBgAlpha(0.85f);
+	ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 10.f, 30.f), ImGuiCond_Always,
+							ImVec2(1.f, 0.f));
+	if (ImGui::Begin("Performance Stats", &is_open,
+					 ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing |
+						 ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoSavedSettings)) {
+		ImGui::Text("Frame: %.2f ms (avg %.2f ms)",
+					frame_times[(history_index + history_size - 1) % history_size],
+					average(frame_times, history_size));
+		// the history is a ring buffer, so plotting starts from the oldest value
+		ImGui::PlotHistogram("##FrameTimes", frame_times, history_size, history_index, nullptr, 0.f,
+							 33.f, ImVec2(300, 60));
+		ImGui::Text("Interval: %.2f ms (avg %.2f ms)",
+					frame_intervals[(history_index + history_size - 1) % history_size],
+					average(frame_intervals, history_size));
+		ImGui::PlotHistogram("##FrameIntervals", frame_intervals, history_size, history_index,
+							 nullptr, 0.f, 100.f, ImVec2(300, 40));
+
+		ImGui::Separator();
+		for (int i = 0; i < STATS_SECTION_COUNT; ++i) {
+			ImGui::Text("%-14s %.2f ms", section_names[i], average(section_times[i], history_size));
+		}
+
+		ImGui::Separator();
+		{
+			const TextureResidency &textures = app.textures;
+			const double budget = (double)app.engine_settings.GetTextureBudget();
+			const double resident_mb = (double)textures.GetResidentBytes() / (1024.0 * 1024.0);
+
+			ImGui::Text("Full Textures: %d resident, %d evicted", textures.GetResidentCount(),
+						textures.GetEvictedCount());
+			char budget_text[64];
+			snprintf(budget_text, sizeof(budget_text), "%.2f / %.0f MB", resident_mb, budget);
+			ImGui::ProgressBar((float)(resident_mb / budget), ImVec2(300, 0), budget_text);
+			ImGui::Text("Loads: %d, Evictions: %d", textures.GetTotalLoads(),
+						textures.GetTotalEvictions());
+			ImGui::Text("Thumbnails: ~%.2f MB",
+						(double)textures.GetThumbnailBytes() / (1024.0 * 1024.0));
+
+			int texture_count = 0;
+			size_t texture_memory = 0;
+			for (auto &image : app.state.dropped_image_files) {
+				add_texture(image.image_data, texture_count, texture_memory);
+			}
+			for (auto &font : app.state.dropped_font_files) {
+				add_texture(font.font_data, texture_count, texture_memory);
+			}
+
+			ImGui::Text("Import Textures: %d (~%.2f MB)", texture_count,
+						(double)texture_memory / (1024.0 * 1024.0));
+		}
+		{
+			size_t console_memory = (size_t)console.Items.Capacity * sizeof(char *);
+			for (auto &item : console.Items) {
+				console_memory += strlen(item) + 1;
+			}
+
+			ImGui::Text("Console: %d lines (~%.1f KB)", console.Items.Size,
+						(double)console_memory / 1024.0);
+		}
+		ImGui::Text("Queued Commands: %d", (int)ThreadCommand::GetQueueSize());
+
+		ImGui::Separator();
+		ImGui::BeginDisabled(IsCapturing());
+		if (ImGui::Button(IsCapturing() ? "Capturing..." : "Capture 10 s")) {
+			StartCapture(app.GetEngineDirectory() + "/traces");
+		}
+		ImGui::EndDisabled();
+		if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+			ImGui::SetTooltip("Saves a trace file that can be opened on chrome://tracing");
+		}
+	}
+	ImGui::End();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+class App;
+
+enum EditorStatsSection {
+	STATS_UPDATE,
+	STATS_RENDER,
+	STATS_PRESENT,
+	STATS_SECTION_COUNT,
+};
+
+// Frame timings and resource usage of the editor itself, shown on the 'Performance Stats'
+// overlay. Can also capture a few seconds of frames into a trace file (chrome://tracing format).
+class EditorStats {
+   public:
+	bool is_open;
+
+	EditorStats();
+
+	void BeginFrame();
+	void EndSection(EditorStatsSection section);
+	void EndFrame();
+
+	void Draw(App &app);
+
+	void StartCapture(const std::string &trace_directory);
+	[[nodiscard]] bool IsCapturing() const {
+		return capture_end > 0;
+	}
+
+   private:
+	static const int history_size = 240;
+
+	float frame_times[history_size];
+	float frame_intervals[history_size];
+	float section_times[STATS_SECTION_COUNT][history_size];
+	int history_index;
+
+	Uint64 frame_start;
+	Uint64 section_start;
+	Uint64 last_frame_start;
+
+	struct CapturedFrame {
+		Uint64 start;
+		Uint64 sections[STATS_SECTION_COUNT];
+	};
+	std::vector<CapturedFrame> captured_frames;
+	std::string capture_directory;
+	Uint64 capture_start;
+	Uint64 capture_end;
+
+	void SaveCapture();
+};
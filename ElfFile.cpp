@@ -0,0 +1,151 @@
+#include "ElfFile.h"
+
+#include <fstream>
+#include <iterator>
+
+class ElfReader {
+   public:
+	ElfReader(const std::vector<Uint8> &data, bool is_big_endian)
+		: data(data), is_big_endian(is_big_endian), is_valid(true) {
+	}
+
+	// reads 'bytes' bytes at 'offset', flags the reader as invalid when out of bounds
+	Uint64 Read(Uint64 offset, int bytes) {
+		if (offset + bytes > data.size()) {
+			is_valid = false;
+			return 0;
+		}
+
+		Uint64 value = 0;
+		for (int i = 0; i < bytes; ++i) {
+			int shift = is_big_endian ? (bytes - 1 - i) * 8 : i * 8;
+			value |= (Uint64)data[offset + i] << shift;
+		}
+		return value;
+	}
+
+	std::string ReadString(Uint64 offset) {
+		std::string text;
+		while (offset < data.size() && data[offset] != 0) {
+			text += (char)data[offset++];
+		}
+		return text;
+	}
+
+	[[nodiscard]] bool IsValid() const {
+		return is_valid;
+	}
+
+   private:
+	const std::vector<Uint8> &data;
+	bool is_big_endian;
+	bool is_valid;
+};
+
+struct ElfSectionHeader {
+	Uint32 name;
+	Uint32 type;
+	Uint64 flags;
+	Uint64 address;
+	Uint64 offset;
+	Uint64 size;
+	Uint32 link;
+	Uint64 entry_size;
+};
+
+bool ElfFile::Load(const std::string &path) {
+	sections.clear();
+	symbols.clear();
+
+	std::ifstream filestream(path, std::ios::binary);
+	if (!filestream.is_open())
+		return false;
+
+	std::vector<Uint8> data((std::istreambuf_iterator<char>(filestream)),
+							std::istreambuf_iterator<char>());
+	filestream.close();
+
+	if (data.size() < 52 || data[0] != 0x7F || data[1] != 'E' || data[2] != 'L' || data[3] != 'F')
+		return false;
+
+	bool is_64 = data[4] == 2;
+	ElfReader reader(data, data[5] == 2);
+
+	// the fields after 'e_entry' move with the size of the addresses
+	int address_size = is_64 ? 8 : 4;
+	Uint64 section_offset = reader.Read(24 + address_size * 2, address_size);
+	Uint64 header_end = 24 + address_size * 3 + 4;
+	Uint64 section_entry_size = reader.Read(header_end + 6, 2);
+	Uint64 section_count = reader.Read(header_end + 8, 2);
+	Uint64 names_index = reader.Read(header_end + 10, 2);
+	if (!reader.IsValid() || section_entry_size == 0)
+		return false;
+
+	std::vector<ElfSectionHeader> headers;
+	for (Uint64 i = 0; i < section_count; ++i) {
+		Uint64 offset = section_offset + i * section_entry_size;
+
+		ElfSectionHeader header = {};
+		header.name = (Uint32)reader.Read(offset, 4);
+		header.type = (Uint32)reader.Read(offset + 4, 4);
+		header.flags = reader.Read(offset + 8, address_size);
+		header.address = reader.Read(offset + 8 + address_size, address_size);
+		header.offset = reader.Read(offset + 8 + address_size * 2, address_size);
+		header.size = reader.Read(offset + 8 + address_size * 3, address_size);
+		header.link = (Uint32)reader.Read(offset + 8 + address_size * 4, 4);
+		header.entry_size = reader.Read(offset + 16 + address_size * 5, address_size);
+		headers.push_back(header);
+	}
+	if (!reader.IsValid() || names_index >= headers.size())
+		return false;
+
+	for (auto &header : headers) {
+		sections.push_back({reader.ReadString(headers[names_index].offset + header.name),
+							header.type, header.flags, header.address, header.size});
+	}
+
+	// SHT_SYMTAB, executables keep it unless stripped
+	for (auto &header : headers) {
+		if (header.type != 2 || header.link >= headers.size() || header.entry_size == 0)
+			continue;
+
+		Uint64 strings_offset = headers[header.link].offset;
+		std::string file;
+		Uint64 symbols_end = header.offset + header.size;
+		for (Uint64 offset = header.offset; offset + header.entry_size <= symbols_end;
+			 offset += header.entry_size) {
+			ElfSymbol symbol;
+			Uint32 name = (Uint32)reader.Read(offset, 4);
+			Uint8 info;
+			Uint16 section_index;
+			if (is_64) {
+				info = (Uint8)reader.Read(offset + 4, 1);
+				section_index = (Uint16)reader.Read(offset + 6, 2);
+				symbol.value = reader.Read(offset + 8, 8);
+				symbol.size = reader.Read(offset + 16, 8);
+			} else {
+				symbol.value = reader.Read(offset + 4, 4);
+				symbol.size = reader.Read(offset + 8, 4);
+				info = (Uint8)reader.Read(offset + 12, 1);
+				section_index = (Uint16)reader.Read(offset + 14, 2);
+			}
+			if (!reader.IsValid())
+				return false;
+
+			symbol.name = reader.ReadString(strings_offset + name);
+			symbol.type = (ElfSymbolType)(info & 0xF);
+			symbol.is_local = (info >> 4) == 0;
+			// 0 is undefined, 0xff00 and above are reserved (absolute, common, ...)
+			symbol.section = section_index == 0 || section_index >= 0xFF00 ? -1 : section_index;
+
+			if (symbol.type == ELF_SYMBOL_FILE)
+				file = symbol.name;
+			else if (symbol.is_local)
+				symbol.file = file;
+
+			symbols.push_back(symbol);
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+enum ElfSymbolType {
+	ELF_SYMBOL_NOTYPE = 0,
+	ELF_SYMBOL_OBJECT = 1,
+	ELF_SYMBOL_FUNC = 2,
+	ELF_SYMBOL_SECTION = 3,
+	ELF_SYMBOL_FILE = 4,
+};
+
+struct ElfSection {
+	std::string name;
+	Uint32 type;
+	Uint64 flags;
+	Uint64 address;
+	Uint64 size;
+
+	// takes space on RDRAM once loaded
+	[[nodiscard]] bool IsAllocated() const {
+		return (flags & 0x2) != 0;
+	}
+	[[nodiscard]] bool IsCode() const {
+		return (flags & 0x4) != 0;
+	}
+	// .bss like, no bytes on the file
+	[[nodiscard]] bool IsNoBits() const {
+		return type == 8;
+	}
+};
+
+struct ElfSymbol {
+	std::string name;
+	Uint64 value;
+	Uint64 size;
+	ElfSymbolType type;
+	bool is_local;
+	// index on 'sections', -1 for undefined, absolute and common symbols
+	int section;
+	// for local symbols, the source file named by the last STT_FILE symbol before it
+	std::string file;
+};
+
+// Section and symbol tables of an ELF file (32 or 64 bits, any endianness), enough to measure
+// code and data without the toolchain.
+struct ElfFile {
+	std::vector<ElfSection> sections;
+	std::vector<ElfSymbol> symbols;
+
+	bool Load(const std::string &path);
+};
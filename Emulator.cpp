@@ -6,6 +6,7 @@
 #include "ConsoleApp.h"
 #include "ThreadCommand.h"
 #include "ProjectBuilder.h"
+#include "generated/generated.h"
 
 void Emulator::Run(App *app) {
 	std::string rom_filename = app->project.project_settings.rom_name + ".z64";
@@ -22,5 +23,15 @@ void Emulator::Run(App *app) {
 	char cmd[255];
 	snprintf(cmd, 255, "%s %s", app->engine_settings.GetEmulatorPath().c_str(),
 			 rom_filename.c_str());
-	ThreadCommand::QueueCommand(cmd);
+	if (!is_profiler_enabled(app->project.project_settings)) {
+		ThreadCommand::QueueCommand(cmd);
+		return;
+	}
+
+	// the reports of the rom go to the profiler window instead of the console
+	app->profiler.Clear();
+	app->profiler.is_open = true;
+	ThreadCommand::QueueCommand(cmd, [app](const std::string &line) {
+		return app->profiler.ParseLine(line);
+	});
 }
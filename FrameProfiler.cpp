@@ -0,0 +1,159 @@
+#include "FrameProfiler.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "imgui.h"
+
+#include "App.h"
+#include "Sdl.h"
+
+static const char *report_prefix = "@profile ";
+
+// the names written by 'profiler.gen.c', in the order of the slots
+static const char *slot_keys[PROFILER_SLOT_COUNT] = {
+	"tick", "display", "global_tick", "global_display", "scene_tick", "scene_display",
+};
+static const char *slot_names[PROFILER_SLOT_COUNT] = {
+	"Tick", "Display", "Global Script Tick", "Global Script Display", "Scene Tick", "Scene Display",
+};
+
+static int get_latest_index(int index, int size) {
+	return (index + size - 1) % size;
+}
+
+static std::string get_scene_label(const App &app, int scene_id) {
+	if (scene_id < 0)
+		return "No Scene";
+
+	for (auto &scene : app.project.scenes) {
+		if (scene.id == scene_id)
+			return std::to_string(scene_id) + ": " + scene.name;
+	}
+	return std::to_string(scene_id) + ": (removed)";
+}
+
+FrameProfiler::FrameProfiler() : is_open(false), last_scene(-1), selected_scene(-1) {
+}
+
+void FrameProfiler::Clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	scenes.clear();
+	last_scene = -1;
+}
+
+bool FrameProfiler::ParseLine(const std::string &line) {
+	// emulators may prefix the debug output with their own tags
+	size_t start = line.find(report_prefix);
+	if (start == std::string::npos)
+		return false;
+
+	int scene_id = -1;
+	float fps = 0;
+	float slot_ms[PROFILER_SLOT_COUNT] = {};
+
+	std::istringstream tokens(line.substr(start + strlen(report_prefix)));
+	std::string token;
+	while (tokens >> token) {
+		size_t equals = token.find('=');
+		if (equals == std::string::npos)
+			continue;
+
+		std::string key = token.substr(0, equals);
+		float value = strtof(token.c_str() + equals + 1, nullptr);
+		if (key == "scene") {
+			scene_id = (int)value;
+		} else if (key == "fps") {
+			fps = value;
+		} else {
+			for (int i = 0; i < PROFILER_SLOT_COUNT; ++i) {
+				if (key == slot_keys[i])
+					slot_ms[i] = value / 1000.f;
+			}
+		}
+	}
+
+	AddReport(scene_id, fps, slot_ms);
+
+	// the editor may be idle, the new report has to be drawn
+	Sdl::WakeUp();
+	return true;
+}
+
+void FrameProfiler::AddReport(int scene_id, float fps, const float *slot_ms) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto inserted = scenes.try_emplace(scene_id);
+	SceneHistory &history = inserted.first->second;
+	if (inserted.second) {
+		history = {};
+	}
+
+	history.fps[history.index] = fps;
+	for (int i = 0; i < PROFILER_SLOT_COUNT; ++i) {
+		history.slot_ms[i][history.index] = slot_ms[i];
+	}
+	history.index = (history.index + 1) % history_size;
+	if (history.count < history_size)
+		++history.count;
+
+	last_scene = scene_id;
+}
+
+void FrameProfiler::Draw(App &app) {
+	if (!is_open)
+		return;
+
+	ImGui::SetNextWindowSize(ImVec2(500, 600), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Frame Profiler", &is_open)) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (!app.project.project_settings.modules.profiler) {
+			ImGui::TextWrapped(
+				"Enable 'Profiler' on the project modules (with the ISViewer or USB debug output) "
+				"and run the rom on an emulator that prints the debug output.");
+		} else if (scenes.empty()) {
+			ImGui::TextWrapped("Waiting for the running rom to report...");
+		}
+
+		if (!scenes.empty()) {
+			if (scenes.find(selected_scene) == scenes.end())
+				selected_scene = last_scene;
+
+			if (ImGui::Button("Clear")) {
+				scenes.clear();
+				ImGui::End();
+				return;
+			}
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(-1);
+			if (ImGui::BeginCombo("##Scene", get_scene_label(app, selected_scene).c_str())) {
+				for (auto &[scene_id, history] : scenes) {
+					if (ImGui::Selectable(get_scene_label(app, scene_id).c_str(),
+										  scene_id == selected_scene))
+						selected_scene = scene_id;
+				}
+				ImGui::EndCombo();
+			}
+
+			const SceneHistory &history = scenes[selected_scene];
+			int latest = get_latest_index(history.index, history_size);
+			// until the history fills up, the plots start at the first report
+			int offset = history.count < history_size ? 0 : history.index;
+
+			ImGui::Text("FPS: %.2f (%d reports)", history.fps[latest], history.count);
+			ImGui::PlotLines("##FPS", history.fps, history.count, offset, nullptr, 0.f, 60.f,
+							 ImVec2(-1, 40));
+
+			ImGui::Separator();
+			for (int i = 0; i < PROFILER_SLOT_COUNT; ++i) {
+				ImGui::Text("%-22s %.2f ms/frame", slot_names[i], history.slot_ms[i][latest]);
+				ImGui::PushID(i);
+				// a frame of a 60 fps game as the top of the scale
+				ImGui::PlotLines("##Slot", history.slot_ms[i], history.count, offset, nullptr, 0.f,
+								 16.7f, ImVec2(-1, 40));
+				ImGui::PopID();
+			}
+		}
+	}
+	ImGui::End();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+class App;
+
+enum FrameProfilerSlot {
+	PROFILER_TICK,
+	PROFILER_DISPLAY,
+	PROFILER_GLOBAL_TICK,
+	PROFILER_GLOBAL_DISPLAY,
+	PROFILER_SCENE_TICK,
+	PROFILER_SCENE_DISPLAY,
+	PROFILER_SLOT_COUNT,
+};
+
+// CPU time of a rom built with the 'profiler' module, shown on the 'Frame Profiler' window. The
+// rom reports once a second through the debug output, those lines are taken from the emulator
+// output while it runs and kept per scene.
+class FrameProfiler {
+   public:
+	bool is_open;
+
+	FrameProfiler();
+
+	void Clear();
+	// called from the command thread, false when 'line' is not a report
+	bool ParseLine(const std::string &line);
+
+	void Draw(App &app);
+
+   private:
+	// one sample per report, so a couple of minutes of each scene
+	static const int history_size = 120;
+
+	struct SceneHistory {
+		float fps[history_size];
+		float slot_ms[PROFILER_SLOT_COUNT][history_size];
+		int index;
+		int count;
+	};
+
+	std::mutex mutex;
+	std::map<int, SceneHistory> scenes;
+	int last_scene;
+	int selected_scene;
+
+	void AddReport(int scene_id, float fps, const float *slot_ms);
+};
@@ -4,6 +4,7 @@
 
 #include "App.h"
 #include "ConsoleApp.h"
+#include "SpriteTmem.h"
 #include "imgui/imgui.h"
 #include "imgui/imgui_custom.h"
 
@@ -26,18 +27,13 @@ void ImportAssets::RenderImportScreen(App *app) {
 							float width = window_width - 30;
 							ImGui::Image((ImTextureID)(intptr_t)image_file->image_data,
 										 ImVec2(width, (float)image_file->height_mult * width));
-							ImGui::SamePlace(8);
-							ImGui::Image((ImTextureID)(intptr_t)image_file->image_data_overlay,
-										 ImVec2(width, (float)image_file->height_mult * width));
 						} else {
 							ImGui::Image((ImTextureID)(intptr_t)image_file->image_data,
 										 ImVec2((float)image_file->width_mult * window_height,
 												(float)window_height));
-							ImGui::SamePlace(8);
-							ImGui::Image((ImTextureID)(intptr_t)image_file->image_data_overlay,
-										 ImVec2((float)image_file->width_mult * window_height,
-												(float)window_height));
 						}
+						render_slices_overlay(image_file->h_slices, image_file->v_slices);
+
 						ImGui::Separator();
 						ImGui::Spacing();
 
@@ -47,49 +43,31 @@ void ImportAssets::RenderImportScreen(App *app) {
 										 ImGuiInputTextFlags_CharsFileName);
 						bool dfs_valid = input_text_dfs_folder(image_file->dfs_folder, 100);
 
-						bool recreate_grid = false;
-						if (ImGui::InputInt("H Slices", &image_file->h_slices)) {
-							recreate_grid = true;
+						bool slices_changed =
+							ImGui::InputInt("H Slices", &image_file->h_slices);
+						slices_changed |= ImGui::InputInt("V Slices", &image_file->v_slices);
+
+						const int default_bits =
+							app->project.project_settings.display.bit_depth == DEPTH_16_BPP ? 16
+																							: 32;
+						slices_changed |= render_sprite_tmem_fit(
+							image_file->image_width, image_file->image_height, image_file->h_slices,
+							image_file->v_slices, default_bits, false);
+
+						bool trim_changed =
+							ImGui::Checkbox("Trim Transparent Borders", &image_file->trim);
+						if (image_file->trim && (trim_changed || slices_changed)) {
+							SDL_Surface *surface = IMG_Load(image_file->image_path.c_str());
+							image_file->trim_saved_texels =
+								get_sprite_trim(surface, image_file->h_slices,
+												image_file->v_slices)
+									.GetSavedTexels();
+							if (surface)
+								SDL_FreeSurface(surface);
 						}
-						if (ImGui::InputInt("V Slices", &image_file->v_slices)) {
-							recreate_grid = true;
-						}
-						if (recreate_grid) {
-							if (SDL_SetRenderTarget(app->renderer, image_file->image_data_overlay) <
-								0) {
-								console.AddLog("Error setting render target: %s", SDL_GetError());
-							}
-
-							SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 0);
-							SDL_RenderClear(app->renderer);
-
-							SDL_SetRenderDrawColor(app->renderer, 0, 255, 0, 255);
-
-							int h_slices = image_file->h_slices - 1;
-							if (h_slices > 0) {
-								float steps = ((float)image_file->w * 2) /
-											  (float)image_file->h_slices;
-								for (int h = 1; h <= h_slices; ++h) {
-									SDL_RenderDrawLine(app->renderer, steps * h, 0, steps * h,
-													   (image_file->h * 2));
-								}
-							}
-							int v_slices = image_file->v_slices - 1;
-							if (v_slices > 0) {
-								float steps = ((float)image_file->h * 2) /
-											  (float)image_file->v_slices;
-								for (int v = 1; v <= v_slices; ++v) {
-									SDL_RenderDrawLine(app->renderer, 0, steps * v,
-													   (image_file->w * 2), steps * v);
-								}
-							}
-
-							SDL_Rect rect = {0, 0, image_file->w * 2, image_file->h * 2};
-							SDL_RenderDrawRect(app->renderer, &rect);
-
-							SDL_SetRenderDrawColor(app->renderer, 255, 255, 255, 255);
-
-							SDL_SetRenderTarget(app->renderer, nullptr);
+						if (image_file->trim) {
+							ImGui::Text("%.1f KB saved", (float)image_file->trim_saved_texels *
+															 default_bits / 8 / 1024.f);
 						}
 
 						ImGui::Separator();
@@ -125,6 +103,7 @@ void ImportAssets::RenderImportScreen(App *app) {
 									image->dfs_folder = dfs_folder;
 									image->h_slices = image_file->h_slices;
 									image->v_slices = image_file->v_slices;
+									image->trim = image_file->trim;
 									image->image_path = "assets/sprites/" + name + extension;
 
 									std::filesystem::create_directories(
@@ -142,7 +121,6 @@ void ImportAssets::RenderImportScreen(App *app) {
 										app->renderer);
 
 									SDL_DestroyTexture(image_file->image_data);
-									SDL_DestroyTexture(image_file->image_data_overlay);
 
 									app->state.dropped_image_files.erase(
 										app->state.dropped_image_files.begin() + (int)i);
@@ -158,7 +136,6 @@ void ImportAssets::RenderImportScreen(App *app) {
 						ImGui::SameLine();
 						if (ImGui::Button("Cancel")) {
 							SDL_DestroyTexture(image_file->image_data);
-							SDL_DestroyTexture(image_file->image_data_overlay);
 
 							app->state.dropped_image_files.erase(
 								app->state.dropped_image_files.begin() + (int)i);
@@ -462,7 +439,6 @@ void ImportAssets::RenderImportScreen(App *app) {
 									file->name = name;
 									file->dfs_folder = dfs_folder;
 									file->file_path = "assets/tiled_maps/" + name + +".tmx";
-									file->layers = map_file->layers;
 
 									std::filesystem::create_directories(
 										app->project.project_settings.project_directory +
@@ -471,6 +447,7 @@ void ImportAssets::RenderImportScreen(App *app) {
 										map_file->file_path,
 										app->project.project_settings.project_directory +
 											"/assets/tiled_maps/" + name + ".tmx");
+									file->SetLayers(map_file->layers);
 
 									file->SaveToDisk(
 										app->project.project_settings.project_directory);
@@ -539,7 +516,6 @@ void ImportAssets::RenderImportScreen(App *app) {
 									file->name = name;
 									file->dfs_folder = dfs_folder;
 									file->file_path = "assets/ldtk_maps/" + name + +".ldtk";
-									file->layers = map_file->layers;
 
 									std::filesystem::create_directories(
 										app->project.project_settings.project_directory +
@@ -548,6 +524,7 @@ void ImportAssets::RenderImportScreen(App *app) {
 										map_file->file_path,
 										app->project.project_settings.project_directory +
 											"/assets/ldtk_maps/" + name + ".ldtk");
+									file->SetLayers(map_file->layers);
 
 									file->SaveToDisk(
 										app->project.project_settings.project_directory);
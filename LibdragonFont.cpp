@@ -4,6 +4,7 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "TextureResidency.h"
 #include "json.hpp"
 #include "imgui/imgui.h"
 #include "imgui/imgui_custom.h"
@@ -15,28 +16,39 @@ LibdragonFont::LibdragonFont()
 	  height(0),
 	  display_width(0),
 	  display_height(0),
-	  loaded_image(nullptr) {
+	  thumbnail(nullptr),
+	  loaded_image(nullptr),
+	  last_drawn(0),
+	  full_image_requested(false) {
 }
 
 LibdragonFont::~LibdragonFont() {
-	if (loaded_image) {
-		SDL_DestroyTexture(loaded_image);
-		loaded_image = nullptr;
+	EvictFullImage();
+
+	if (thumbnail) {
+		SDL_DestroyTexture(thumbnail);
+		thumbnail = nullptr;
 	}
 }
 
 void LibdragonFont::LoadImage(const std::string &project_directory, SDL_Renderer *renderer) {
 	std::string path(project_directory + "/" + font_path);
 
-	if (loaded_image) {
-		SDL_DestroyTexture(loaded_image);
-		loaded_image = nullptr;
+	// the full image is loaded again the next time it is drawn
+	EvictFullImage();
+	full_image_requested = false;
+
+	if (thumbnail) {
+		SDL_DestroyTexture(thumbnail);
+		thumbnail = nullptr;
 	}
 
-	loaded_image = LoadTextureFromFont(path.c_str(), font_size, renderer);
+	SDL_Surface *surface = LoadSurfaceFromFont(path.c_str(), font_size, renderer);
+	if (!surface)
+		return;
 
-	int w, h;
-	SDL_QueryTexture(loaded_image, nullptr, nullptr, &w, &h);
+	int w = surface->w;
+	int h = surface->h;
 
 	width = w;
 	height = h;
@@ -52,6 +64,46 @@ void LibdragonFont::LoadImage(const std::string &project_directory, SDL_Renderer
 
 	display_width = w;
 	display_height = h;
+
+	thumbnail = create_thumbnail(renderer, surface, display_width, display_height);
+	SDL_FreeSurface(surface);
+}
+
+SDL_Texture *LibdragonFont::GetFullImage() {
+	last_drawn = SDL_GetTicks();
+
+	if (!loaded_image) {
+		full_image_requested = true;
+		return thumbnail;
+	}
+
+	return loaded_image;
+}
+
+std::string LibdragonFont::GetFullImagePath(const std::string &project_directory) const {
+	return project_directory + "/" + font_path;
+}
+
+void LibdragonFont::SetFullImage(SDL_Renderer *renderer, SDL_Surface *surface) {
+	EvictFullImage();
+	full_image_requested = false;
+
+	if (!surface)
+		return;
+
+	loaded_image = SDL_CreateTextureFromSurface(renderer, surface);
+	SDL_FreeSurface(surface);
+}
+
+void LibdragonFont::EvictFullImage() {
+	if (loaded_image) {
+		SDL_DestroyTexture(loaded_image);
+		loaded_image = nullptr;
+	}
+}
+
+size_t LibdragonFont::GetFullImageBytes() const {
+	return texture_bytes(loaded_image);
 }
 
 SDL_Surface *LibdragonFont::LoadSurfaceFromFont(const char *font_path, int font_size,
@@ -147,7 +199,7 @@ void LibdragonFont::DeleteFromDisk(const std::string &project_directory) const {
 	std::filesystem::remove(image_filepath);
 }
 
-void LibdragonFont::DrawTooltip() const {
+void LibdragonFont::DrawTooltip() {
 	std::stringstream tooltip;
 	tooltip << "Path: " << font_path << "\nDFS_Path: " << dfs_folder << name
 			<< ".font\nSize: " << font_size;
@@ -161,6 +213,6 @@ void LibdragonFont::DrawTooltip() const {
 	ImGui::Text("%s", tooltip.str().c_str());
 	ImGui::Separator();
 
-	ImGui::Image((ImTextureID)(intptr_t)loaded_image, ImVec2((float)width, (float)height));
+	ImGui::Image((ImTextureID)(intptr_t)GetFullImage(), ImVec2((float)width, (float)height));
 	ImGui::EndTooltip();
 }
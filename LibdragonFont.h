@@ -15,18 +15,31 @@ class LibdragonFont {
 	int display_width;
 	int display_height;
 
+	// always resident, at most 'display_width' x 'display_height'
+	SDL_Texture *thumbnail;
+	// full resolution, loaded on demand and evicted by 'TextureResidency'
 	SDL_Texture *loaded_image;
+	Uint32 last_drawn;
+	bool full_image_requested;
 
 	LibdragonFont();
 	~LibdragonFont();
 
 	void LoadImage(const std::string &project_directory, SDL_Renderer *renderer);
 
+	// returns the thumbnail (and requests the full image) while it is not loaded
+	SDL_Texture *GetFullImage();
+	[[nodiscard]] std::string GetFullImagePath(const std::string &project_directory) const;
+	// takes ownership of 'surface', decoded by 'TextureResidency' off the main thread
+	void SetFullImage(SDL_Renderer *renderer, SDL_Surface *surface);
+	void EvictFullImage();
+	[[nodiscard]] size_t GetFullImageBytes() const;
+
 	void SaveToDisk(const std::string &project_directory);
 	void LoadFromDisk(const std::string &filepath);
 	void DeleteFromDisk(const std::string &project_directory) const;
 
-	void DrawTooltip() const;
+	void DrawTooltip();
 
 	static SDL_Surface *LoadSurfaceFromFont(const char *font_path, int font_size,
 											SDL_Renderer *renderer);
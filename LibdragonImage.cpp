@@ -1,7 +1,15 @@
 #include "LibdragonImage.h"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
 
+#include "ColorQuantizer.h"
+#include "TextureResidency.h"
 #include "json.hpp"
 #include "imgui/imgui.h"
 #include "imgui/imgui_custom.h"
@@ -48,6 +56,161 @@ std::string get_libdragon_image_type_extension(LibdragonImageType type) {
 	return ".none";
 }
 
+std::string get_libdragon_sprite_format_name(LibdragonSpriteFormat format) {
+	switch (format) {
+		case SPRITE_FORMAT_DEFAULT:
+			return "Default";
+		case SPRITE_FORMAT_RGBA16:
+			return "RGBA16";
+		case SPRITE_FORMAT_RGBA32:
+			return "RGBA32";
+		case SPRITE_FORMAT_CI8:
+			return "CI8";
+		case SPRITE_FORMAT_CI4:
+			return "CI4";
+		case SPRITE_FORMAT_IA8:
+			return "IA8";
+		case SPRITE_FORMAT_I4:
+			return "I4";
+	}
+
+	return "none";
+}
+
+int get_libdragon_sprite_format_bits(LibdragonSpriteFormat format, int default_bits) {
+	switch (format) {
+		case SPRITE_FORMAT_DEFAULT:
+			return default_bits;
+		case SPRITE_FORMAT_RGBA16:
+			return 16;
+		case SPRITE_FORMAT_RGBA32:
+			return 32;
+		case SPRITE_FORMAT_CI8:
+		case SPRITE_FORMAT_IA8:
+			return 8;
+		case SPRITE_FORMAT_CI4:
+		case SPRITE_FORMAT_I4:
+			return 4;
+	}
+
+	return default_bits;
+}
+
+bool is_libdragon_sprite_format_indexed(LibdragonSpriteFormat format) {
+	return format == SPRITE_FORMAT_CI8 || format == SPRITE_FORMAT_CI4;
+}
+
+int SpriteTrim::GetSavedTexels() const {
+	return (frame_width * frame_height - cell_width * cell_height) * (int)frames.size();
+}
+
+SpriteTrim get_sprite_trim(SDL_Surface *surface, int h_slices, int v_slices) {
+	h_slices = std::max(h_slices, 1);
+	v_slices = std::max(v_slices, 1);
+
+	SpriteTrim trim = {};
+	SDL_Surface *rgba =
+		surface ? SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+	if (!rgba) {
+		// nothing to trim
+		trim.frame_width = trim.cell_width = surface ? surface->w / h_slices : 0;
+		trim.frame_height = trim.cell_height = surface ? surface->h / v_slices : 0;
+		trim.frames.assign((size_t)h_slices * v_slices,
+						   {0, 0, trim.frame_width, trim.frame_height});
+		return trim;
+	}
+
+	trim.frame_width = rgba->w / h_slices;
+	trim.frame_height = rgba->h / v_slices;
+
+	// frames are numbered left to right, top to bottom, like on libdragon
+	SDL_LockSurface(rgba);
+	for (int v = 0; v < v_slices; ++v) {
+		for (int h = 0; h < h_slices; ++h) {
+			int min_x = trim.frame_width, min_y = trim.frame_height, max_x = -1, max_y = -1;
+			for (int y = 0; y < trim.frame_height; ++y) {
+				Uint8 *row = (Uint8 *)rgba->pixels +
+							 (size_t)(v * trim.frame_height + y) * rgba->pitch +
+							 (size_t)h * trim.frame_width * 4;
+				for (int x = 0; x < trim.frame_width; ++x) {
+					if (row[x * 4 + 3] == 0)
+						continue;
+
+					min_x = std::min(min_x, x);
+					min_y = std::min(min_y, y);
+					max_x = std::max(max_x, x);
+					max_y = std::max(max_y, y);
+				}
+			}
+
+			if (max_x < 0)
+				trim.frames.push_back({0, 0, 0, 0});
+			else
+				trim.frames.push_back({min_x, min_y, max_x - min_x + 1, max_y - min_y + 1});
+
+			trim.cell_width = std::max(trim.cell_width, trim.frames.back().width);
+			trim.cell_height = std::max(trim.cell_height, trim.frames.back().height);
+		}
+	}
+	SDL_UnlockSurface(rgba);
+	SDL_FreeSurface(rgba);
+
+	// mksprite needs at least one texel, even when every frame is blank
+	trim.cell_width = std::max(trim.cell_width, 1);
+	trim.cell_height = std::max(trim.cell_height, 1);
+
+	return trim;
+}
+
+SDL_Surface *create_trimmed_surface(SDL_Surface *surface, const SpriteTrim &trim, int h_slices,
+									int v_slices) {
+	h_slices = std::max(h_slices, 1);
+	v_slices = std::max(v_slices, 1);
+
+	// rows are copied as bytes
+	SDL_Surface *source = surface;
+	if (surface->format->BitsPerPixel < 8)
+		source = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	if (!source)
+		return nullptr;
+
+	// new surfaces are cleared: transparent for RGBA and index 0 (transparent) for the palettes
+	SDL_Surface *trimmed = SDL_CreateRGBSurfaceWithFormat(
+		0, trim.cell_width * h_slices, trim.cell_height * v_slices,
+		source->format->BitsPerPixel, source->format->format);
+	if (trimmed && source->format->palette) {
+		SDL_SetPaletteColors(trimmed->format->palette, source->format->palette->colors, 0,
+							 source->format->palette->ncolors);
+	}
+
+	if (trimmed) {
+		int bytes_per_pixel = source->format->BytesPerPixel;
+
+		SDL_LockSurface(source);
+		SDL_LockSurface(trimmed);
+		for (int i = 0; i < (int)trim.frames.size() && i < h_slices * v_slices; ++i) {
+			const SpriteFrameTrim &frame = trim.frames[i];
+			int h = i % h_slices, v = i / h_slices;
+			for (int y = 0; y < frame.height; ++y) {
+				Uint8 *from = (Uint8 *)source->pixels +
+							  (size_t)(v * trim.frame_height + frame.y + y) * source->pitch +
+							  (size_t)(h * trim.frame_width + frame.x) * bytes_per_pixel;
+				Uint8 *to = (Uint8 *)trimmed->pixels +
+							(size_t)(v * trim.cell_height + y) * trimmed->pitch +
+							(size_t)h * trim.cell_width * bytes_per_pixel;
+				memcpy(to, from, (size_t)frame.width * bytes_per_pixel);
+			}
+		}
+		SDL_UnlockSurface(trimmed);
+		SDL_UnlockSurface(source);
+	}
+
+	if (source != surface)
+		SDL_FreeSurface(source);
+
+	return trimmed;
+}
+
 LibdragonImage::LibdragonImage()
 	: dfs_folder("/"),
 	  h_slices(1),
@@ -57,17 +220,21 @@ LibdragonImage::LibdragonImage()
 	  display_width(0),
 	  display_height(0),
 	  type(IMAGE_PNG),
-	  loaded_image(nullptr) {
+	  format(SPRITE_FORMAT_DEFAULT),
+	  dither(false),
+	  trim(false),
+	  thumbnail(nullptr),
+	  loaded_image(nullptr),
+	  last_drawn(0),
+	  full_image_requested(false) {
 }
 
 LibdragonImage::~LibdragonImage() {
-	if (loaded_image) {
-		SDL_DestroyTexture(loaded_image);
-		loaded_image = nullptr;
-	}
-	if (loaded_image_overlay) {
-		SDL_DestroyTexture(loaded_image_overlay);
-		loaded_image_overlay = nullptr;
+	EvictFullImage();
+
+	if (thumbnail) {
+		SDL_DestroyTexture(thumbnail);
+		thumbnail = nullptr;
 	}
 }
 
@@ -75,6 +242,8 @@ void LibdragonImage::SaveToDisk(const std::string &project_directory) {
 	nlohmann::json json = {
 		{"name", name},			{"image_path", image_path}, {"dfs_folder", dfs_folder},
 		{"h_slices", h_slices}, {"v_slices", v_slices},		{"type", type},
+		{"format", format},		{"palette_group", palette_group}, {"dither", dither},
+		{"atlas_group", atlas_group}, {"trim", trim},
 	};
 
 	std::string directory = project_directory + "/.ngine/sprites/";
@@ -102,6 +271,16 @@ void LibdragonImage::LoadFromDisk(const std::string &filepath) {
 	v_slices = json["v_slices"];
 	if (!json["type"].is_null())
 		type = json["type"];
+	if (!json["format"].is_null())
+		format = json["format"];
+	if (!json["palette_group"].is_null())
+		palette_group = json["palette_group"];
+	if (!json["dither"].is_null())
+		dither = json["dither"];
+	if (!json["atlas_group"].is_null())
+		atlas_group = json["atlas_group"];
+	if (!json["trim"].is_null())
+		trim = json["trim"];
 
 	std::replace(dfs_folder.begin(), dfs_folder.end(), '\\', '/');
 }
@@ -117,18 +296,25 @@ void LibdragonImage::DeleteFromDisk(const std::string &project_directory) const
 void LibdragonImage::LoadImage(const std::string &project_directory, SDL_Renderer *renderer) {
 	std::string path(project_directory + "/" + image_path);
 
-	loaded_image = IMG_LoadTexture(renderer, path.c_str());
+	// the full image is loaded again the next time it is drawn
+	EvictFullImage();
+	full_image_requested = false;
+
+	if (thumbnail) {
+		SDL_DestroyTexture(thumbnail);
+		thumbnail = nullptr;
+	}
+
+	SDL_Surface *surface = IMG_Load(path.c_str());
+	if (!surface)
+		return;
 
-	int w, h;
-	SDL_QueryTexture(loaded_image, nullptr, nullptr, &w, &h);
+	int w = surface->w;
+	int h = surface->h;
 
 	width = w;
 	height = h;
 
-	loaded_image_overlay = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
-											 SDL_TEXTUREACCESS_TARGET, w * 2, h * 2);
-	SDL_SetTextureBlendMode(loaded_image_overlay, SDL_BLENDMODE_BLEND);
-
 	const float max_size = 130.f;
 	if (w > h) {
 		h = (int)(((float)h / (float)w) * max_size);
@@ -141,45 +327,58 @@ void LibdragonImage::LoadImage(const std::string &project_directory, SDL_Rendere
 	display_width = w;
 	display_height = h;
 
-	RecreateOverlay(renderer, h_slices, v_slices);
+	thumbnail = create_thumbnail(renderer, surface, display_width, display_height);
+	SDL_FreeSurface(surface);
 }
 
-void LibdragonImage::RecreateOverlay(SDL_Renderer *renderer, int overlay_h_slices, int overlay_v_slices) {
-	SDL_SetRenderTarget(renderer, loaded_image_overlay);
+SDL_Texture *LibdragonImage::GetFullImage() {
+	last_drawn = SDL_GetTicks();
 
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-	SDL_RenderClear(renderer);
+	if (!loaded_image) {
+		full_image_requested = true;
+		return thumbnail;
+	}
 
-	SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+	return loaded_image;
+}
 
-	int total_h_slices = overlay_h_slices - 1;
-	if (total_h_slices > 0) {
-		float steps = ((float)width * 2) / (float)overlay_h_slices;
-		for (int h = 1; h <= total_h_slices; ++h) {
-			SDL_RenderDrawLine(renderer, steps * h, 0, steps * h, (height * 2));
-		}
-	}
-	int total_v_slices = overlay_v_slices - 1;
-	if (total_v_slices > 0) {
-		float steps = ((float)height * 2) / (float)overlay_v_slices;
-		for (int v = 1; v <= total_v_slices; ++v) {
-			SDL_RenderDrawLine(renderer, 0, steps * v, (width * 2), steps * v);
-		}
-	}
+std::string LibdragonImage::GetFullImagePath(const std::string &project_directory) const {
+	return project_directory + "/" + image_path;
+}
 
-	SDL_Rect rect = {0, 0, width * 2, height * 2};
-	SDL_RenderDrawRect(renderer, &rect);
+void LibdragonImage::SetFullImage(SDL_Renderer *renderer, SDL_Surface *surface) {
+	EvictFullImage();
+	full_image_requested = false;
 
-	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+	if (!surface)
+		return;
 
-	SDL_SetRenderTarget(renderer, nullptr);
+	loaded_image = SDL_CreateTextureFromSurface(renderer, surface);
+	SDL_FreeSurface(surface);
 }
 
-void LibdragonImage::DrawTooltip() const {
+void LibdragonImage::EvictFullImage() {
+	if (loaded_image) {
+		SDL_DestroyTexture(loaded_image);
+		loaded_image = nullptr;
+	}
+}
+
+size_t LibdragonImage::GetFullImageBytes() const {
+	return texture_bytes(loaded_image);
+}
+
+void LibdragonImage::DrawTooltip() {
 	std::stringstream tooltip;
 	tooltip << "Path: " << image_path << "\nDFS_Path: " << dfs_folder << name
 			<< ".sprite\nSize: " << width << "x" << height << "\nSlices: " << h_slices << "x"
-			<< v_slices << "\n";
+			<< v_slices << "\nFormat: " << get_libdragon_sprite_format_name(format) << "\n";
+	if (is_libdragon_sprite_format_indexed(format) && !palette_group.empty())
+		tooltip << "Palette Group: " << palette_group << "\n";
+	if (!atlas_group.empty())
+		tooltip << "Atlas: " << atlas_group << "\n";
+	else if (trim)
+		tooltip << "Trimmed\n";
 
 	ImGui::BeginTooltip();
 	render_badge("sprite", ImVec4(.4f, .8f, .4f, 0.7f));
@@ -192,6 +391,174 @@ void LibdragonImage::DrawTooltip() const {
 	ImGui::Text("%s", tooltip.str().c_str());
 	ImGui::Separator();
 
-	ImGui::Image((ImTextureID)(intptr_t)loaded_image, ImVec2((float)width, (float)height));
+	ImGui::Image((ImTextureID)(intptr_t)GetFullImage(), ImVec2((float)width, (float)height));
 	ImGui::EndTooltip();
 }
+
+size_t LibdragonImage::GetSpriteBytes(int default_bits) const {
+	int bits = get_libdragon_sprite_format_bits(format, default_bits);
+	size_t bytes = (size_t)width * height * bits / 8;
+
+	// palettes are RGBA16
+	if (format == SPRITE_FORMAT_CI8)
+		bytes += 256 * 2;
+	else if (format == SPRITE_FORMAT_CI4)
+		bytes += 16 * 2;
+
+	return bytes;
+}
+
+SpriteTrim LibdragonImage::LoadTrim(const std::string &project_directory) const {
+	return LoadTrim(project_directory, h_slices, v_slices);
+}
+
+SpriteTrim LibdragonImage::LoadTrim(const std::string &project_directory, int trim_h_slices,
+									int trim_v_slices) const {
+	SDL_Surface *surface = IMG_Load((project_directory + "/" + image_path).c_str());
+	if (!surface)
+		return get_sprite_trim(nullptr, trim_h_slices, trim_v_slices);
+
+	SpriteTrim sprite_trim = get_sprite_trim(surface, trim_h_slices, trim_v_slices);
+	SDL_FreeSurface(surface);
+
+	return sprite_trim;
+}
+
+struct CachedPaletteGroup {
+	// paths, formats and modification times of the members the palette was built from
+	std::string signature;
+	ColorQuantizer quantizer;
+};
+
+static std::string get_palette_group_signature(const std::string &project_directory,
+											   const std::vector<PaletteGroupMember> &members) {
+	std::stringstream signature;
+	for (auto &member : members) {
+		std::error_code error;
+		auto write_time =
+			std::filesystem::last_write_time(project_directory + "/" + member.image_path, error);
+		signature << member.image_path << '|' << member.format << '|'
+				  << (error ? 0 : write_time.time_since_epoch().count()) << '\n';
+	}
+	return signature.str();
+}
+
+// a copy, 'ColorQuantizer::Remap' fills its own cache and builds run next to the editor preview
+static ColorQuantizer get_palette_group_quantizer(const std::string &project_directory,
+												  const SpriteFormatSource &source) {
+	static std::mutex mutex;
+	static std::map<std::string, CachedPaletteGroup> groups;
+
+	std::string signature = get_palette_group_signature(project_directory, source.group_members);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	CachedPaletteGroup &group = groups[project_directory + "/" + source.palette_group];
+	if (group.signature == signature)
+		return group.quantizer;
+
+	ColorQuantizer quantizer;
+	int max_colors = 256;
+	for (auto &member : source.group_members) {
+		SDL_Surface *group_surface =
+			IMG_Load((project_directory + "/" + member.image_path).c_str());
+		if (group_surface) {
+			quantizer.AddImage(group_surface);
+			SDL_FreeSurface(group_surface);
+		}
+		// one CI4 sprite limits the whole group to 16 colors
+		if (member.format == SPRITE_FORMAT_CI4)
+			max_colors = 16;
+	}
+	quantizer.BuildPalette(max_colors);
+
+	group.signature = signature;
+	group.quantizer = quantizer;
+
+	return quantizer;
+}
+
+SDL_Surface *load_format_surface(const std::string &project_directory,
+								 const SpriteFormatSource &source, int default_bits) {
+	const LibdragonSpriteFormat format = source.format;
+
+	SDL_Surface *surface = IMG_Load((project_directory + "/" + source.image_path).c_str());
+	if (!surface)
+		return nullptr;
+
+	if (is_libdragon_sprite_format_indexed(format)) {
+		ColorQuantizer quantizer;
+		if (source.palette_group.empty()) {
+			quantizer.AddImage(surface);
+			quantizer.BuildPalette(format == SPRITE_FORMAT_CI4 ? 16 : 256);
+		} else {
+			quantizer = get_palette_group_quantizer(project_directory, source);
+		}
+
+		SDL_Surface *indexed = quantizer.Remap(surface, source.dither);
+		SDL_FreeSurface(surface);
+
+		return indexed;
+	}
+
+	SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(surface);
+	if (!rgba)
+		return nullptr;
+
+	LibdragonSpriteFormat reduced_format = format;
+	if (format == SPRITE_FORMAT_DEFAULT)
+		reduced_format = default_bits == 16 ? SPRITE_FORMAT_RGBA16 : SPRITE_FORMAT_RGBA32;
+
+	SDL_LockSurface(rgba);
+	for (int y = 0; y < rgba->h; ++y) {
+		Uint8 *row = (Uint8 *)rgba->pixels + (size_t)y * rgba->pitch;
+		for (int x = 0; x < rgba->w; ++x) {
+			Uint8 *pixel = row + x * 4;
+			int intensity = (pixel[0] * 299 + pixel[1] * 587 + pixel[2] * 114) / 1000;
+
+			switch (reduced_format) {
+				case SPRITE_FORMAT_RGBA16:
+					for (int c = 0; c < 3; ++c) {
+						pixel[c] = (Uint8)((pixel[c] & 0xF8) | (pixel[c] >> 5));
+					}
+					pixel[3] = pixel[3] >= 128 ? 255 : 0;
+					break;
+				case SPRITE_FORMAT_IA8:
+					intensity = (intensity >> 4) * 17;
+					pixel[0] = pixel[1] = pixel[2] = (Uint8)intensity;
+					pixel[3] = (Uint8)((pixel[3] >> 4) * 17);
+					break;
+				case SPRITE_FORMAT_I4:
+					// intensity is also used as alpha
+					intensity = (intensity >> 4) * 17;
+					pixel[0] = pixel[1] = pixel[2] = pixel[3] = (Uint8)intensity;
+					break;
+				default:
+					break;
+			}
+		}
+	}
+	SDL_UnlockSurface(rgba);
+
+	return rgba;
+}
+
+SDL_Surface *LibdragonImage::LoadFormatSurface(
+	const std::string &project_directory,
+	const std::vector<std::unique_ptr<LibdragonImage>> &images, int default_bits) const {
+	return load_format_surface(project_directory, GetFormatSource(images), default_bits);
+}
+
+SpriteFormatSource LibdragonImage::GetFormatSource(
+	const std::vector<std::unique_ptr<LibdragonImage>> &images) const {
+	SpriteFormatSource source = {image_path, format, dither, palette_group, {}};
+	if (!is_libdragon_sprite_format_indexed(format) || palette_group.empty())
+		return source;
+
+	for (auto &image : images) {
+		if (image->palette_group == palette_group &&
+			is_libdragon_sprite_format_indexed(image->format))
+			source.group_members.push_back({image->image_path, image->format});
+	}
+	return source;
+}
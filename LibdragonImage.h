@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <SDL2/SDL_image.h>
 
 enum LibdragonImageType {
@@ -14,9 +15,70 @@ enum LibdragonImageType {
 	IMAGE_TGA,
 };
 
+// format of the texels on the rom, 'SPRITE_FORMAT_DEFAULT' follows the display bit depth
+enum LibdragonSpriteFormat {
+	SPRITE_FORMAT_DEFAULT,
+	SPRITE_FORMAT_RGBA16,
+	SPRITE_FORMAT_RGBA32,
+	SPRITE_FORMAT_CI8,
+	SPRITE_FORMAT_CI4,
+	SPRITE_FORMAT_IA8,
+	SPRITE_FORMAT_I4,
+};
+
 std::string get_libdragon_image_type_name(LibdragonImageType type);
 std::string get_libdragon_image_type_extension(LibdragonImageType type);
 
+std::string get_libdragon_sprite_format_name(LibdragonSpriteFormat format);
+// bits per texel, 'SPRITE_FORMAT_DEFAULT' uses 'default_bits'
+int get_libdragon_sprite_format_bits(LibdragonSpriteFormat format, int default_bits);
+bool is_libdragon_sprite_format_indexed(LibdragonSpriteFormat format);
+
+// opaque bounding box of a frame, relative to its top left corner (empty for blank frames)
+struct SpriteFrameTrim {
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+// Frames cropped to their opaque bounding box. Sprites are sliced on a grid, so every trimmed
+// frame still takes a cell of the same size (the largest box) on the sheet.
+struct SpriteTrim {
+	int frame_width;
+	int frame_height;
+	int cell_width;
+	int cell_height;
+	std::vector<SpriteFrameTrim> frames;
+
+	[[nodiscard]] int GetSavedTexels() const;
+};
+
+SpriteTrim get_sprite_trim(SDL_Surface *surface, int h_slices, int v_slices);
+// each frame copied to the top left corner of its cell, keeping the pixel format and palette
+SDL_Surface *create_trimmed_surface(SDL_Surface *surface, const SpriteTrim &trim, int h_slices,
+									int v_slices);
+
+struct PaletteGroupMember {
+	std::string image_path;
+	LibdragonSpriteFormat format;
+};
+
+// what 'load_format_surface' reads from the project, copied so it can run on another thread
+struct SpriteFormatSource {
+	std::string image_path;
+	LibdragonSpriteFormat format;
+	bool dither;
+	std::string palette_group;
+	// the indexed sprites of 'palette_group', this one included
+	std::vector<PaletteGroupMember> group_members;
+};
+
+// The shared palette of a group is quantized once and cached until a member is added, removed,
+// changes its format or its image is modified.
+SDL_Surface *load_format_surface(const std::string &project_directory,
+								 const SpriteFormatSource &source, int default_bits);
+
 class LibdragonImage {
    public:
 	std::string name;
@@ -32,18 +94,55 @@ class LibdragonImage {
 
 	LibdragonImageType type;
 
+	LibdragonSpriteFormat format;
+	// sprites on the same group share one palette (color indexed formats only)
+	std::string palette_group;
+	bool dither;
+	// sprites on the same group are packed on one atlas instead of their own '.sprite'
+	std::string atlas_group;
+	// frames are cropped to their opaque pixels, see 'SpriteTrim'
+	bool trim;
+
+	// always resident, at most 'display_width' x 'display_height'
+	SDL_Texture *thumbnail;
+	// full resolution, loaded on demand and evicted by 'TextureResidency'
 	SDL_Texture *loaded_image;
-	SDL_Texture *loaded_image_overlay;
+	Uint32 last_drawn;
+	bool full_image_requested;
 
 	LibdragonImage();
 	~LibdragonImage();
 
 	void LoadImage(const std::string &project_directory, SDL_Renderer *renderer);
-	void RecreateOverlay(SDL_Renderer *renderer, int overlay_h_slices, int overlay_v_slices);
+
+	// returns the thumbnail (and requests the full image) while it is not loaded
+	SDL_Texture *GetFullImage();
+	[[nodiscard]] std::string GetFullImagePath(const std::string &project_directory) const;
+	// takes ownership of 'surface', decoded by 'TextureResidency' off the main thread
+	void SetFullImage(SDL_Renderer *renderer, SDL_Surface *surface);
+	void EvictFullImage();
+	[[nodiscard]] size_t GetFullImageBytes() const;
 
 	void SaveToDisk(const std::string &project_directory);
 	void LoadFromDisk(const std::string &filepath);
 	void DeleteFromDisk(const std::string &project_directory) const;
 
-	void DrawTooltip() const;
+	void DrawTooltip();
+
+	// bytes of texels and palette on the rom
+	[[nodiscard]] size_t GetSpriteBytes(int default_bits) const;
+
+	// the same 'get_sprite_trim' used when building, from the original image
+	[[nodiscard]] SpriteTrim LoadTrim(const std::string &project_directory) const;
+	// with slices that are not saved yet, for the editor
+	[[nodiscard]] SpriteTrim LoadTrim(const std::string &project_directory, int trim_h_slices,
+									  int trim_v_slices) const;
+
+	// loads the image as it will look on the console: an 8 bits surface with the (maybe shared)
+	// palette for the indexed formats, the reduced precision colors for the others
+	[[nodiscard]] SDL_Surface *LoadFormatSurface(
+		const std::string &project_directory,
+		const std::vector<std::unique_ptr<LibdragonImage>> &images, int default_bits) const;
+	[[nodiscard]] SpriteFormatSource GetFormatSource(
+		const std::vector<std::unique_ptr<LibdragonImage>> &images) const;
 };
@@ -12,7 +12,8 @@
 
 extern App *g_app;
 
-LibdragonLDtkMap::LibdragonLDtkMap() : dfs_folder("/") {
+LibdragonLDtkMap::LibdragonLDtkMap()
+	: dfs_folder("/"), layers_loaded(false), source_size(0), source_mtime(0) {
 }
 
 void LibdragonLDtkMap::SaveToDisk(const std::string &project_directory) {
@@ -21,6 +22,14 @@ void LibdragonLDtkMap::SaveToDisk(const std::string &project_directory) {
 	json["file_path"] = file_path;
 	json["dfs_folder"] = dfs_folder;
 
+	if (layers_loaded) {
+		json["source_size"] = source_size;
+		json["source_mtime"] = source_mtime;
+		for (auto &layer : layers) {
+			json["layers"].push_back(layer.name);
+		}
+	}
+
 	std::string directory = project_directory + "/.ngine/ldtk_maps/";
 	if (!std::filesystem::exists(directory))
 		std::filesystem::create_directories(directory);
@@ -45,7 +54,29 @@ void LibdragonLDtkMap::LoadFromDisk(const std::string &filepath) {
 
 	std::replace(dfs_folder.begin(), dfs_folder.end(), '\\', '/');
 
-	LoadLayers();
+	layers.clear();
+	layers_loaded = false;
+
+	// only trust the cached layers if the source file was not touched since they were parsed
+	if (!json["layers"].is_null() && !json["source_size"].is_null() &&
+		!json["source_mtime"].is_null()) {
+		uintmax_t current_size;
+		int64_t current_mtime;
+		std::string full_file_path = g_app->project.project_settings.project_directory + "/" +
+									 file_path;
+		if (get_map_source_stats(full_file_path, current_size, current_mtime) &&
+			current_size == json["source_size"] && current_mtime == json["source_mtime"]) {
+			for (auto &layer_name : json["layers"]) {
+				LibdragonMapLayer layer;
+				layer.name = layer_name;
+				layers.push_back(layer);
+			}
+
+			source_size = current_size;
+			source_mtime = current_mtime;
+			layers_loaded = true;
+		}
+	}
 }
 
 void LibdragonLDtkMap::DeleteFromDisk(const std::string &project_directory) const {
@@ -60,6 +91,26 @@ void LibdragonLDtkMap::LoadLayers() {
 	std::string full_file_path = g_app->project.project_settings.project_directory + "/" +
 								 file_path;
 	layers = LoadLayers(full_file_path);
+
+	get_map_source_stats(full_file_path, source_size, source_mtime);
+	layers_loaded = true;
+}
+
+void LibdragonLDtkMap::EnsureLayersLoaded() {
+	if (layers_loaded)
+		return;
+
+	LoadLayers();
+	SaveToDisk(g_app->project.project_settings.project_directory);
+}
+
+void LibdragonLDtkMap::SetLayers(const std::vector<LibdragonMapLayer> &new_layers) {
+	std::string full_file_path = g_app->project.project_settings.project_directory + "/" +
+								 file_path;
+
+	layers = new_layers;
+	get_map_source_stats(full_file_path, source_size, source_mtime);
+	layers_loaded = true;
 }
 
 std::vector<LibdragonMapLayer> LibdragonLDtkMap::LoadLayers(const std::string &file_path) {
@@ -92,7 +143,9 @@ std::vector<LibdragonMapLayer> LibdragonLDtkMap::LoadLayers(const std::string &f
 	return layers;
 }
 
-void LibdragonLDtkMap::DrawTooltip() const {
+void LibdragonLDtkMap::DrawTooltip() {
+	EnsureLayersLoaded();
+
 	std::stringstream tooltip;
 	tooltip << "Path: " << file_path << "\n\nLayers:";
 	for (auto &layer : layers) {
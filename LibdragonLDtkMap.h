@@ -13,6 +13,11 @@ class LibdragonLDtkMap {
 
 	std::vector<LibdragonMapLayer> layers;
 
+	// layer list is cached on the json and only parsed again when the source file changes
+	bool layers_loaded;
+	uintmax_t source_size;
+	int64_t source_mtime;
+
 	LibdragonLDtkMap();
 
 	void SaveToDisk(const std::string &project_directory);
@@ -20,7 +25,9 @@ class LibdragonLDtkMap {
 	void DeleteFromDisk(const std::string &project_directory) const;
 
 	void LoadLayers();
+	void EnsureLayersLoaded();
+	void SetLayers(const std::vector<LibdragonMapLayer> &new_layers);
 	static std::vector<LibdragonMapLayer> LoadLayers(const std::string &file_path);
 
-	void DrawTooltip() const;
+	void DrawTooltip();
 };
@@ -8,7 +8,14 @@
 #include "imgui/imgui_custom.h"
 
 LibdragonSound::LibdragonSound(LibdragonSoundType type)
-	: type(type), wav_loop(false), wav_loop_offset(0), ym_compress(false) {
+	: type(type),
+	  wav_loop(false),
+	  wav_loop_offset(0),
+	  wav_override_processing(false),
+	  wav_resample(false),
+	  wav_mono(false),
+	  wav_bit_depth(16),
+	  ym_compress(false) {
 }
 
 void LibdragonSound::SaveToDisk(const std::string &project_directory) {
@@ -19,6 +26,10 @@ void LibdragonSound::SaveToDisk(const std::string &project_directory) {
 		{"type", type},
 		{"wav_loop", wav_loop},
 		{"wav_loop_offset", wav_loop_offset},
+		{"wav_override_processing", wav_override_processing},
+		{"wav_resample", wav_resample},
+		{"wav_mono", wav_mono},
+		{"wav_bit_depth", wav_bit_depth},
 		{"ym_compress", ym_compress},
 	};
 
@@ -49,6 +60,15 @@ void LibdragonSound::LoadFromDisk(const std::string &filepath) {
 	wav_loop_offset = json["wav_loop_offset"];
 	ym_compress = json["ym_compress"];
 
+	if (!json["wav_override_processing"].is_null())
+		wav_override_processing = json["wav_override_processing"];
+	if (!json["wav_resample"].is_null())
+		wav_resample = json["wav_resample"];
+	if (!json["wav_mono"].is_null())
+		wav_mono = json["wav_mono"];
+	if (!json["wav_bit_depth"].is_null())
+		wav_bit_depth = json["wav_bit_depth"];
+
 	std::replace(dfs_folder.begin(), dfs_folder.end(), '\\', '/');
 }
 
@@ -78,6 +98,8 @@ void LibdragonSound::DrawTooltip() const {
 			tooltip << "\nType: WAV (Waveforms)\nLoop: " << (wav_loop ? "Yes" : "No");
 			if (wav_loop)
 				tooltip << "\nLoop Offset: " << wav_loop_offset;
+			tooltip << "\nProcessing: "
+					<< (wav_override_processing ? "Custom" : "Project Defaults");
 		} break;
 		case SOUND_XM: {
 			tooltip << "\nType: XM (MilkyTracker, OpenMPT)";
@@ -161,3 +183,10 @@ std::string LibdragonSound::GetExtensionName() const {
 			return "not_mapped";
 	}
 }
+
+SoundProcessOptions LibdragonSound::GetProcessOptions(const AudioSettings &audio) const {
+	if (wav_override_processing)
+		return {wav_resample ? audio.frequency : 0, wav_mono, wav_bit_depth};
+
+	return {audio.resample_sounds ? audio.frequency : 0, audio.mono_sounds, audio.sound_bit_depth};
+}
@@ -3,6 +3,9 @@
 #include <memory>
 #include <string>
 
+#include "audio/SoundProcessor.h"
+#include "settings/AudioSettings.h"
+
 enum LibdragonSoundType {
 	SOUND_UNKNOWN,
 	SOUND_WAV,
@@ -21,6 +24,12 @@ class LibdragonSound {
 	bool wav_loop;
 	int wav_loop_offset;
 
+	// when false the project defaults from 'AudioSettings' are used
+	bool wav_override_processing;
+	bool wav_resample;
+	bool wav_mono;
+	int wav_bit_depth;
+
 	bool ym_compress;
 
 	explicit LibdragonSound(LibdragonSoundType type);
@@ -34,4 +43,5 @@ class LibdragonSound {
 	[[nodiscard]] std::string GetLibdragonExtension() const;
 	[[nodiscard]] std::string GetExtension() const;
 	[[nodiscard]] std::string GetExtensionName() const;
+	[[nodiscard]] SoundProcessOptions GetProcessOptions(const AudioSettings &audio) const;
 };
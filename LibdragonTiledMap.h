@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,6 +8,8 @@ struct LibdragonMapLayer {
 	std::string name;
 };
 
+bool get_map_source_stats(const std::string &file_path, uintmax_t &size, int64_t &mtime);
+
 class LibdragonTiledMap {
    public:
 	std::string name;
@@ -15,6 +18,11 @@ class LibdragonTiledMap {
 
 	std::vector<LibdragonMapLayer> layers;
 
+	// layer list is cached on the json and only parsed again when the source file changes
+	bool layers_loaded;
+	uintmax_t source_size;
+	int64_t source_mtime;
+
 	LibdragonTiledMap();
 
 	void SaveToDisk(const std::string &project_directory);
@@ -22,7 +30,9 @@ class LibdragonTiledMap {
 	void DeleteFromDisk(const std::string &project_directory) const;
 
 	void LoadLayers();
+	void EnsureLayersLoaded();
+	void SetLayers(const std::vector<LibdragonMapLayer> &new_layers);
 	static std::vector<LibdragonMapLayer> LoadLayers(const std::string &file_path);
 
-	void DrawTooltip() const;
+	void DrawTooltip();
 };
@@ -1,7 +1,9 @@
 #include "ProjectBuilder.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <filesystem>
+#include <set>
 #include <thread>
 
 #include "App.h"
@@ -73,33 +75,26 @@ void ProjectBuilder::Create(App *app, std::string project_folder) {
 	std::thread(create_project_thread, app, project_folder).detach();
 }
 
-void create_build_files(App *app) {
-	std::filesystem::remove_all(app->project.project_settings.project_directory + "/build");
-
+void generate_code_files(App *app) {
 	generate_game_gen_h(app->project);
+	generate_asset_cache_gen_c(app->project);
+	generate_asset_stream_gen_c(app->project);
+	generate_sprite_batch_gen_c(app->project);
+	generate_profiler_gen_c(app->project);
 
 	generate_makefile_gen(app->project);
 
 	std::string setup_path(app->project.project_settings.project_directory + "/src/setup.gen.c");
-	generate_setup_gen_c(setup_path, app->project.project_settings);
+	generate_setup_gen_c(setup_path, app->project);
 
 	std::string change_scene_path(app->project.project_settings.project_directory +
 								  "/src/scenes/change_scene.gen.c");
 	generate_change_scene_gen_c(change_scene_path, app->project);
 
 	generate_scene_gen_files(app->project);
+}
 
-	Content::CreateSprites(app->engine_settings, app->project.project_settings,
-						   app->project.images);
-	Content::CreateSounds(app->engine_settings, app->project.project_settings, app->project.sounds);
-	Content::CreateGeneralFiles(app->engine_settings, app->project.project_settings,
-								app->project.general_files);
-	Content::CreateFonts(app->engine_settings, app->project.project_settings, app->project.fonts);
-	Content::CreateTiledMaps(app->engine_settings, app->project.project_settings,
-							 app->project.tiled_maps);
-	Content::CreateLDtkMaps(app->engine_settings, app->project.project_settings,
-							app->project.ldtk_maps);
-
+void run_content_pipeline_script(App *app) {
 	std::string path_to_content_script(app->project.project_settings.project_directory +
 									   "/.ngine/pipeline/content_pipeline_end.term");
 	if (std::filesystem::exists(path_to_content_script)) {
@@ -120,12 +115,235 @@ void create_build_files(App *app) {
 	}
 }
 
+// Removes the converted files of assets that are no longer on the project, which would otherwise
+// stay on the '.dfs' of incremental builds. Atlases are cleared when they are packed.
+void remove_stale_build_files(App *app) {
+	const Project &project = app->project;
+	std::string filesystem_directory = project.project_settings.project_directory +
+									   "/build/filesystem";
+	if (!std::filesystem::exists(filesystem_directory))
+		return;
+
+	std::set<std::string> known_files;
+	std::vector<std::string> known_folders = {"/atlases/"};
+	for (auto &image : project.images) {
+		if (image->atlas_group.empty())
+			known_files.insert(image->dfs_folder + image->name + ".sprite");
+	}
+	for (auto &sound : project.sounds) {
+		known_files.insert(sound->dfs_folder + sound->name + sound->GetLibdragonExtension());
+	}
+	for (auto &file : project.general_files) {
+		if (file->copy_to_filesystem)
+			known_files.insert(file->dfs_folder + file->GetFilename());
+	}
+	for (auto &font : project.fonts) {
+		known_files.insert(font->dfs_folder + font->name + ".font");
+	}
+	for (auto &map : project.tiled_maps) {
+		known_folders.push_back(map->dfs_folder + map->name + "/");
+	}
+	for (auto &map : project.ldtk_maps) {
+		known_folders.push_back(map->dfs_folder + map->name + "/");
+	}
+
+	std::vector<std::filesystem::path> stale_files;
+	for (auto &file : std::filesystem::recursive_directory_iterator(filesystem_directory)) {
+		if (!file.is_regular_file())
+			continue;
+
+		std::string dfs_path =
+			"/" + std::filesystem::relative(file.path(), filesystem_directory).generic_string();
+		bool is_known = known_files.contains(dfs_path) ||
+						std::any_of(known_folders.begin(), known_folders.end(),
+									[&dfs_path](const std::string &folder) {
+										return dfs_path.starts_with(folder);
+									});
+		if (!is_known)
+			stale_files.push_back(file.path());
+	}
+	for (auto &path : stale_files) {
+		console.AddLog("Removing '%s' from the filesystem.", path.filename().string().c_str());
+		std::filesystem::remove(path);
+	}
+}
+
+// the asset table needs the final layout of the filesystem, so it is built before 'make'
+void queue_asset_table(App *app) {
+	AssetTableSnapshot snapshot = get_asset_table_snapshot(app->project);
+	if (snapshot.dfs_paths.empty()) {
+		generate_asset_table_gen_c(snapshot);
+		return;
+	}
+
+	Libdragon::Exec(app, "/n64_toolchain/bin/mkdfs build/" + snapshot.rom_name +
+							 ".dfs build/filesystem");
+	// by value, the project may change before the callback runs
+	ThreadCommand::QueueCallback(
+		[snapshot = std::move(snapshot)]() { return generate_asset_table_gen_c(snapshot); });
+}
+
+void create_build_files(App *app) {
+	std::filesystem::remove_all(app->project.project_settings.project_directory + "/build");
+
+	generate_code_files(app);
+
+	Content::CreateSprites(app->engine_settings, app->project.project_settings,
+						   app->project.images);
+	Content::CreateSounds(app->engine_settings, app->project.project_settings, app->project.sounds);
+	Content::CreateGeneralFiles(app->engine_settings, app->project.project_settings,
+								app->project.general_files);
+	Content::CreateFonts(app->engine_settings, app->project.project_settings, app->project.fonts);
+	Content::CreateTiledMaps(app->engine_settings, app->project.project_settings,
+							 app->project.tiled_maps);
+	Content::CreateLDtkMaps(app->engine_settings, app->project.project_settings,
+							app->project.ldtk_maps);
+
+	run_content_pipeline_script(app);
+
+	queue_asset_table(app);
+}
+
 void ProjectBuilder::Build(App *app) {
 	create_build_files(app);
 
 	Libdragon::Build(app);
 }
 
+void ProjectBuilder::BuildChanged(App *app, const std::vector<std::string> &changed_files) {
+	const std::string &project_directory = app->project.project_settings.project_directory;
+
+	// nothing to reuse yet
+	if (!std::filesystem::exists(project_directory + "/build")) {
+		Build(app);
+		return;
+	}
+
+	std::set<std::string> changed(changed_files.begin(), changed_files.end());
+	auto has_changed = [&changed](const std::string &source_path, const std::string &json_path) {
+		return changed.contains(source_path) || changed.contains(json_path);
+	};
+
+	// the conversion of every asset depends on the project settings (bit depth, audio defaults)
+	if (changed.contains("ngine.project.json")) {
+		Build(app);
+		return;
+	}
+
+	// generated files are only rewritten when needed, otherwise make would recompile everything
+	bool regenerate_code = false;
+	bool scenes_changed = false;
+	bool assets_removed = false;
+	for (auto &path : changed) {
+		if (path.starts_with(".ngine/"))
+			regenerate_code = true;
+		// a removed asset only shows up as its missing json
+		if (path.starts_with(".ngine/") && !path.starts_with(".ngine/scenes/") &&
+			!std::filesystem::exists(project_directory + "/" + path))
+			assets_removed = true;
+		// the preload sizes are checked with the asset table
+		if (path.starts_with(".ngine/scenes/"))
+			scenes_changed = true;
+	}
+
+	const EngineSettings &engine_settings = app->engine_settings;
+	const ProjectSettings &project_settings = app->project.project_settings;
+
+	bool content_changed = false;
+	// a sprite that left its group (or was removed) only shows up as a changed or missing json,
+	// so any sprite change packs the atlases again
+	bool atlases_changed = std::any_of(changed.begin(), changed.end(), [](const std::string &path) {
+		return path.starts_with(".ngine/sprites/");
+	});
+	std::vector<std::string> changed_palette_groups;
+	for (auto &image : app->project.images) {
+		if (has_changed(image->image_path, ".ngine/sprites/" + image->name + ".sprite.json")) {
+			content_changed = true;
+
+			if (!image->atlas_group.empty()) {
+				atlases_changed = true;
+				continue;
+			}
+			// the frame offsets are on 'game.gen.h'
+			if (image->trim)
+				regenerate_code = true;
+
+			Content::CreateSprite(engine_settings, project_settings, *image,
+								  app->project.images);
+
+			if (!image->palette_group.empty())
+				changed_palette_groups.push_back(image->palette_group);
+		}
+	}
+	// the palette of the whole group may have changed
+	for (auto &image : app->project.images) {
+		if (!image->palette_group.empty() && image->atlas_group.empty() &&
+			std::find(changed_palette_groups.begin(), changed_palette_groups.end(),
+					  image->palette_group) != changed_palette_groups.end() &&
+			!has_changed(image->image_path, ".ngine/sprites/" + image->name + ".sprite.json")) {
+			Content::CreateSprite(engine_settings, project_settings, *image,
+								  app->project.images);
+		}
+	}
+	// packing is global, so any change can move every sub-rect
+	if (atlases_changed) {
+		Content::CreateAtlases(engine_settings, project_settings, app->project.images);
+		regenerate_code = true;
+		content_changed = true;
+	}
+	for (auto &sound : app->project.sounds) {
+		if (has_changed(sound->sound_path, ".ngine/sounds/" + sound->name + ".sound.json")) {
+			Content::CreateSound(engine_settings, project_settings, *sound);
+			content_changed = true;
+		}
+	}
+	for (auto &file : app->project.general_files) {
+		if (has_changed(file->file_path, ".ngine/general/" + file->name + ".general.json")) {
+			Content::CreateGeneralFile(engine_settings, project_settings, *file);
+			content_changed = true;
+		}
+	}
+	for (auto &font : app->project.fonts) {
+		if (has_changed(font->font_path, ".ngine/fonts/" + font->name + ".font.json")) {
+			Content::CreateFont(engine_settings, project_settings, *font);
+			content_changed = true;
+		}
+	}
+	for (auto &map : app->project.tiled_maps) {
+		if (has_changed(map->file_path, ".ngine/tiled_maps/" + map->name + ".tiled_maps.json")) {
+			Content::CreateTiledMap(engine_settings, project_settings, *map);
+			content_changed = true;
+		}
+	}
+	for (auto &map : app->project.ldtk_maps) {
+		if (has_changed(map->file_path, ".ngine/ldtk_maps/" + map->name + ".ldtk_maps.json")) {
+			Content::CreateLDtkMap(engine_settings, project_settings, *map);
+			content_changed = true;
+		}
+	}
+
+	if (assets_removed) {
+		remove_stale_build_files(app);
+		content_changed = true;
+	}
+
+	if (regenerate_code)
+		generate_code_files(app);
+
+	if (content_changed) {
+		run_content_pipeline_script(app);
+
+		// the dfs rule only looks at the top level of the filesystem folder
+		std::filesystem::remove(project_directory + "/build/" + project_settings.rom_name +
+								".dfs");
+	}
+	if (content_changed || scenes_changed ||
+		!std::filesystem::exists(project_directory + "/src/asset_table.gen.c"))
+		queue_asset_table(app);
+
+	Libdragon::Build(app);
+}
+
 void ProjectBuilder::Rebuild(App *app) {
 	Libdragon::CleanSync(app);
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "LibdragonImage.h"
 #include "LibdragonSound.h"
@@ -11,6 +13,8 @@ class ProjectBuilder {
    public:
 	static void Create(App *app, std::string project_folder);
 	static void Build(App *app);
+	// converts only the assets touched by 'changed_files' (relative to the project) and runs make
+	static void BuildChanged(App *app, const std::vector<std::string> &changed_files);
 	static void Rebuild(App *app);
 
 	static void GenerateStaticFiles(const std::string& project_folder);
@@ -35,17 +35,21 @@ class ProjectState {
 	char editor_path[255];
 	char libdragon_exe_path[255];
 	bool libdragon_use_bundled;
+	int texture_budget;
 	ProjectSettingsScreen project_settings_screen;
 
 	Scene *current_scene;
 	char scene_name[100];
 
+	bool watch_build;
+
 	void LoadEngineSetings(const EngineSettings &engine_settings) {
 		strcpy(emulator_path, engine_settings.GetEmulatorPath().c_str());
 		strcpy(editor_path, engine_settings.GetEditorLocation().c_str());
 		strcpy(libdragon_exe_path, engine_settings.GetLibdragonExeLocation().c_str());
 
 		libdragon_use_bundled = engine_settings.GetLibdragonUseBundled();
+		texture_budget = engine_settings.GetTextureBudget();
 	}
 
 	explicit ProjectState(const EngineSettings &engine_settings)
@@ -57,9 +61,11 @@ class ProjectState {
 		  editor_path(),
 		  libdragon_exe_path(),
 		  libdragon_use_bundled(true),
+		  texture_budget(256),
 		  project_settings_screen(),
 		  current_scene(nullptr),
-		  scene_name() {
+		  scene_name(),
+		  watch_build(false) {
 		memset(scene_name, 0, 100);
 
 		LoadEngineSetings(engine_settings);
@@ -69,8 +75,6 @@ class ProjectState {
 		for (auto &image : dropped_image_files) {
 			if (image.image_data)
 				SDL_DestroyTexture(image.image_data);
-			if (image.image_data_overlay)
-				SDL_DestroyTexture(image.image_data_overlay);
 		}
 		for (auto &image : dropped_font_files) {
 			if (image.font_data)
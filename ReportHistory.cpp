@@ -0,0 +1,73 @@
+#include "ReportHistory.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#include "ThreadCommand.h"
+
+const Uint32 build_check_interval_ms = 1000;
+
+int64_t get_file_time(const std::string &path) {
+	std::error_code error;
+	auto time = std::filesystem::last_write_time(path, error);
+	return error ? 0 : (int64_t)time.time_since_epoch().count();
+}
+
+std::string format_kb(uintmax_t bytes) {
+	char text[32];
+	snprintf(text, 32, "%.1f KB", (double)bytes / 1024.0);
+	return text;
+}
+
+std::string format_delta(uintmax_t bytes, uintmax_t previous_bytes, int decimals) {
+	char text[32];
+	snprintf(text, 32, "%+.*f KB", decimals, ((double)bytes - (double)previous_bytes) / 1024.0);
+	return text;
+}
+
+ReportHistory::ReportHistory(std::string filename, std::string time_key)
+	: filename(std::move(filename)), time_key(std::move(time_key)), last_check(0) {
+}
+
+bool ReportHistory::HasNewBuild(const std::string &build_path, int64_t analyzed_time) {
+	if (SDL_GetTicks() - last_check < build_check_interval_ms || ThreadCommand::IsRunning())
+		return false;
+
+	last_check = SDL_GetTicks();
+
+	int64_t build_time = get_file_time(build_path);
+	return build_time != 0 && build_time != analyzed_time;
+}
+
+nlohmann::json ReportHistory::LoadPrevious(const std::string &project_directory,
+										   int64_t build_time, bool &is_new_build) const {
+	is_new_build = true;
+
+	std::string report_path = project_directory + "/" + filename;
+	if (!std::filesystem::exists(report_path))
+		return nullptr;
+
+	// a broken or hand edited report is not compared with
+	std::ifstream filestream(report_path);
+	nlohmann::json last_report = nlohmann::json::parse(filestream, nullptr, false);
+	filestream.close();
+	if (!last_report.is_object())
+		return nullptr;
+
+	// the same build analyzed again keeps comparing with the build before it
+	is_new_build = last_report[time_key] != build_time;
+	nlohmann::json previous = is_new_build ? last_report : last_report["previous"];
+	if (!previous.is_object())
+		return nullptr;
+
+	return previous;
+}
+
+void ReportHistory::Save(const std::string &project_directory,
+						 const nlohmann::json &report) const {
+	std::ofstream filestream(project_directory + "/" + filename);
+	filestream << report.dump(4) << std::endl;
+	filestream.close();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <SDL2/SDL.h>
+
+#include "json.hpp"
+
+// 0 when the file is missing
+int64_t get_file_time(const std::string &path);
+std::string format_kb(uintmax_t bytes);
+// with the sign, "+1.5 KB" when it grew
+std::string format_delta(uintmax_t bytes, uintmax_t previous_bytes, int decimals = 1);
+
+// The last analysis of a size report, saved as json on the project folder so the next build can
+// be compared with it. Also tells the report window when a new build is there to analyze.
+class ReportHistory {
+   public:
+	// 'time_key' holds the modification time of the analyzed build
+	ReportHistory(std::string filename, std::string time_key);
+
+	// checked once a second, true when 'build_path' changed since 'analyzed_time' and nothing is
+	// building anymore
+	bool HasNewBuild(const std::string &build_path, int64_t analyzed_time);
+
+	// The report to compare 'build_time' with: the saved one for a new build, or the one saved as
+	// its 'previous' when the same build is analyzed again. Null when there is none, or when the
+	// file can't be parsed (it is overwritten on 'Save').
+	[[nodiscard]] nlohmann::json LoadPrevious(const std::string &project_directory,
+											  int64_t build_time, bool &is_new_build) const;
+	void Save(const std::string &project_directory, const nlohmann::json &report) const;
+
+   private:
+	std::string filename;
+	std::string time_key;
+	Uint32 last_check;
+};
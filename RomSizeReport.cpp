@@ -0,0 +1,456 @@
+#include "RomSizeReport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#include "imgui.h"
+#include "imgui_custom.h"
+
+#include "App.h"
+#include "ConsoleApp.h"
+#include "ReportHistory.h"
+#include "SpriteAtlas.h"
+#include "json.hpp"
+
+const float treemap_height = 220.f;
+
+struct TreemapRect {
+	ImVec2 min;
+	ImVec2 max;
+};
+
+static uintmax_t get_file_bytes(const std::string &path) {
+	std::error_code error;
+	uintmax_t bytes = std::filesystem::file_size(path, error);
+	return error ? 0 : bytes;
+}
+
+static std::string get_rom_path(const Project &project) {
+	return project.project_settings.project_directory + "/" + project.project_settings.rom_name +
+		   ".z64";
+}
+
+static ImU32 get_type_color(const std::string &type) {
+	if (type == "sprite")
+		return IM_COL32(90, 170, 90, 255);
+	if (type == "atlas")
+		return IM_COL32(60, 130, 60, 255);
+	if (type == "sound")
+		return IM_COL32(80, 120, 200, 255);
+	if (type == "font")
+		return IM_COL32(200, 160, 60, 255);
+	if (type == "tiled map" || type == "ldtk map")
+		return IM_COL32(170, 90, 170, 255);
+	if (type == "file")
+		return IM_COL32(130, 130, 130, 255);
+	return IM_COL32(90, 90, 90, 255);
+}
+
+// Splits the weights (biggest first) in two halves of similar total along the longest side of
+// the rect, until there is one weight per rect.
+static void layout_treemap(const std::vector<double> &weights, size_t begin, size_t end,
+						   ImVec2 min, ImVec2 max, std::vector<TreemapRect> &rects) {
+	if (end - begin == 1) {
+		rects[begin] = {min, max};
+		return;
+	}
+
+	double total = 0;
+	for (size_t i = begin; i < end; ++i) {
+		total += weights[i];
+	}
+
+	size_t split = begin;
+	double first_total = 0;
+	do {
+		first_total += weights[split++];
+	} while (split < end - 1 && first_total < total / 2);
+
+	float ratio = total > 0 ? (float)(first_total / total) : 0.5f;
+	if (max.x - min.x >= max.y - min.y) {
+		float x = min.x + (max.x - min.x) * ratio;
+		layout_treemap(weights, begin, split, min, ImVec2(x, max.y), rects);
+		layout_treemap(weights, split, end, ImVec2(x, min.y), max, rects);
+	} else {
+		float y = min.y + (max.y - min.y) * ratio;
+		layout_treemap(weights, begin, split, min, ImVec2(max.x, y), rects);
+		layout_treemap(weights, split, end, ImVec2(min.x, y), max, rects);
+	}
+}
+
+RomSizeReport::RomSizeReport()
+	: is_open(false),
+	  rom_bytes(0),
+	  dfs_bytes(0),
+	  rom_time(0),
+	  has_previous(false),
+	  previous_rom_bytes(0),
+	  previous_dfs_bytes(0),
+	  group_by_type(false),
+	  history("rom_size_report.json", "rom_time") {
+}
+
+bool RomSizeReport::Analyze(const Project &project) {
+	const std::string &project_directory = project.project_settings.project_directory;
+	const std::string filesystem_directory = project_directory + "/build/filesystem";
+
+	rom_time = get_file_time(get_rom_path(project));
+	if (!std::filesystem::exists(filesystem_directory)) {
+		console.AddLog("[error] Nothing to analyze, please build the project first.");
+		return false;
+	}
+
+	// what each asset is converted to, maps are converted to a folder
+	std::map<std::string, RomSizeEntry> known_files;
+	std::vector<RomSizeEntry> known_folders;
+	auto make_entry = [&project_directory](const std::string &dfs_path, const std::string &name,
+										   const std::string &type, const std::string &dfs_folder,
+										   const std::string &source_path) {
+		return RomSizeEntry{dfs_path, name, type, dfs_folder,
+							get_file_bytes(project_directory + "/" + source_path), 0};
+	};
+	for (auto &image : project.images) {
+		if (image->atlas_group.empty()) {
+			std::string dfs_path = image->dfs_folder + image->name + ".sprite";
+			known_files[dfs_path] =
+				make_entry(dfs_path, image->name, "sprite", image->dfs_folder, image->image_path);
+		}
+	}
+	for (auto &atlas : pack_sprite_atlases(project.images)) {
+		std::string dfs_path = "/atlases/" + atlas.name + ".sprite";
+		RomSizeEntry entry = make_entry(dfs_path, atlas.name, "atlas", "/atlases/", "");
+		for (auto &sprite : atlas.sprites) {
+			entry.source_bytes +=
+				get_file_bytes(project_directory + "/" + sprite.image->image_path);
+		}
+		known_files[dfs_path] = entry;
+	}
+	for (auto &sound : project.sounds) {
+		std::string dfs_path = sound->dfs_folder + sound->name + sound->GetLibdragonExtension();
+		known_files[dfs_path] =
+			make_entry(dfs_path, sound->name, "sound", sound->dfs_folder, sound->sound_path);
+	}
+	for (auto &file : project.general_files) {
+		std::string dfs_path = file->dfs_folder + file->GetFilename();
+		known_files[dfs_path] =
+			make_entry(dfs_path, file->name, "file", file->dfs_folder, file->file_path);
+	}
+	for (auto &font : project.fonts) {
+		std::string dfs_path = font->dfs_folder + font->name + ".font";
+		known_files[dfs_path] =
+			make_entry(dfs_path, font->name, "font", font->dfs_folder, font->font_path);
+	}
+	for (auto &map : project.tiled_maps) {
+		known_folders.push_back(make_entry(map->dfs_folder + map->name + "/", map->name,
+										   "tiled map", map->dfs_folder, map->file_path));
+	}
+	for (auto &map : project.ldtk_maps) {
+		known_folders.push_back(make_entry(map->dfs_folder + map->name + "/", map->name,
+										   "ldtk map", map->dfs_folder, map->file_path));
+	}
+
+	std::vector<RomSizeEntry> new_entries;
+	std::map<std::string, size_t> entry_indexes;
+	for (auto &file : std::filesystem::recursive_directory_iterator(filesystem_directory)) {
+		if (!file.is_regular_file())
+			continue;
+
+		std::filesystem::path relative_path =
+			std::filesystem::relative(file.path(), filesystem_directory);
+		std::string dfs_path = "/" + relative_path.generic_string();
+
+		RomSizeEntry entry;
+		auto known_file = known_files.find(dfs_path);
+		auto known_folder = std::find_if(known_folders.begin(), known_folders.end(),
+										 [&dfs_path](const RomSizeEntry &folder) {
+											 return dfs_path.starts_with(folder.dfs_path);
+										 });
+		if (known_file != known_files.end()) {
+			entry = known_file->second;
+		} else if (known_folder != known_folders.end()) {
+			entry = *known_folder;
+		} else {
+			// added by the content pipeline script, most likely
+			std::string dfs_folder = "/" + relative_path.parent_path().generic_string();
+			if (!dfs_folder.ends_with("/"))
+				dfs_folder += "/";
+			entry = {dfs_path, relative_path.filename().string(), "other", dfs_folder, 0, 0};
+		}
+
+		auto index = entry_indexes.find(entry.dfs_path);
+		if (index == entry_indexes.end()) {
+			index = entry_indexes.insert({entry.dfs_path, new_entries.size()}).first;
+			new_entries.push_back(entry);
+		}
+		new_entries[index->second].converted_bytes += file.file_size();
+	}
+	std::sort(new_entries.begin(), new_entries.end(),
+			  [](const RomSizeEntry &a, const RomSizeEntry &b) {
+				  return a.converted_bytes > b.converted_bytes;
+			  });
+
+	entries = new_entries;
+	rom_bytes = get_file_bytes(get_rom_path(project));
+	dfs_bytes = get_file_bytes(project_directory + "/build/" + project.project_settings.rom_name +
+							   ".dfs");
+
+	bool is_new_build;
+	nlohmann::json previous = history.LoadPrevious(project_directory, rom_time, is_new_build);
+	has_previous = false;
+	previous_sizes.clear();
+	if (previous.is_object() && previous["assets"].is_array() &&
+		previous["rom_bytes"].is_number_unsigned() && previous["dfs_bytes"].is_number_unsigned()) {
+		has_previous = true;
+		previous_rom_bytes = previous["rom_bytes"].get<uintmax_t>();
+		previous_dfs_bytes = previous["dfs_bytes"].get<uintmax_t>();
+		for (auto &asset : previous["assets"]) {
+			if (!asset.is_object() || !asset["path"].is_string() ||
+				!asset["converted_bytes"].is_number_unsigned())
+				continue;
+
+			previous_sizes[asset["path"].get<std::string>()] =
+				asset["converted_bytes"].get<uintmax_t>();
+		}
+	}
+
+	nlohmann::json json = {
+		{"rom_time", rom_time},
+		{"rom_bytes", rom_bytes},
+		{"dfs_bytes", dfs_bytes},
+		{"assets", nlohmann::json::array()},
+	};
+	for (auto &entry : entries) {
+		json["assets"].push_back({{"path", entry.dfs_path},
+								  {"name", entry.name},
+								  {"type", entry.type},
+								  {"dfs_folder", entry.dfs_folder},
+								  {"source_bytes", entry.source_bytes},
+								  {"converted_bytes", entry.converted_bytes}});
+	}
+	if (has_previous) {
+		json["previous"] = {
+			{"rom_time", previous["rom_time"]},
+			{"rom_bytes", previous_rom_bytes},
+			{"dfs_bytes", previous_dfs_bytes},
+			{"assets", nlohmann::json::array()},
+		};
+		for (auto &[path, bytes] : previous_sizes) {
+			json["previous"]["assets"].push_back({{"path", path}, {"converted_bytes", bytes}});
+		}
+	}
+
+	history.Save(project_directory, json);
+
+	if (has_previous && is_new_build) {
+		int grown_count = 0;
+		for (auto &entry : entries) {
+			auto previous_size = previous_sizes.find(entry.dfs_path);
+			if (previous_size != previous_sizes.end() &&
+				entry.converted_bytes > previous_size->second)
+				++grown_count;
+		}
+		console.AddLog("ROM size: %s (%s since the previous build, %d assets grew).",
+					   format_kb(rom_bytes).c_str(),
+					   format_delta(rom_bytes, previous_rom_bytes).c_str(), grown_count);
+	}
+
+	return true;
+}
+
+void RomSizeReport::Draw(App &app) {
+	if (!is_open || !app.project.project_settings.IsOpen())
+		return;
+
+	// analyzes again once a build finishes
+	if (history.HasNewBuild(get_rom_path(app.project), rom_time))
+		Analyze(app.project);
+
+	ImGui::SetNextWindowSize(ImVec2(700, 500), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("ROM Size Report", &is_open)) {
+		if (ImGui::Button("Analyze"))
+			Analyze(app.project);
+		if (ImGui::IsItemHovered()) {
+			ImGui::SetTooltip("Saved to 'rom_size_report.json' on the project folder.");
+		}
+
+		ImGui::SameLine();
+		ImGui::TextUnformatted("Group by:");
+		ImGui::SameLine();
+		if (ImGui::RadioButton("Folder", !group_by_type))
+			group_by_type = false;
+		ImGui::SameLine();
+		if (ImGui::RadioButton("Type", group_by_type))
+			group_by_type = true;
+
+		ImGui::Text("ROM: %s", format_kb(rom_bytes).c_str());
+		if (has_previous) {
+			ImGui::SameLine();
+			if (rom_bytes > previous_rom_bytes)
+				ImGui::TextColored(color_invalid_input, "(%s)",
+								   format_delta(rom_bytes, previous_rom_bytes).c_str());
+			else
+				ImGui::Text("(%s)", format_delta(rom_bytes, previous_rom_bytes).c_str());
+		}
+		ImGui::SameLine();
+		ImGui::Text("  DFS: %s", format_kb(dfs_bytes).c_str());
+		if (has_previous) {
+			ImGui::SameLine();
+			if (dfs_bytes > previous_dfs_bytes)
+				ImGui::TextColored(color_invalid_input, "(%s)",
+								   format_delta(dfs_bytes, previous_dfs_bytes).c_str());
+			else
+				ImGui::Text("(%s)", format_delta(dfs_bytes, previous_dfs_bytes).c_str());
+		}
+
+		if (!entries.empty()) {
+			DrawTreemap();
+			DrawTable();
+		}
+	}
+	ImGui::End();
+}
+
+void RomSizeReport::DrawTreemap() {
+	// entries are sorted by size, so are the groups and their entries
+	std::vector<std::string> group_names;
+	std::map<std::string, std::vector<const RomSizeEntry *>> groups;
+	std::map<std::string, double> group_totals;
+	for (auto &entry : entries) {
+		const std::string &group = group_by_type ? entry.type : entry.dfs_folder;
+		if (!groups.contains(group))
+			group_names.push_back(group);
+
+		groups[group].push_back(&entry);
+		group_totals[group] += (double)entry.converted_bytes;
+	}
+	std::stable_sort(group_names.begin(), group_names.end(),
+					 [&group_totals](const std::string &a, const std::string &b) {
+						 return group_totals[a] > group_totals[b];
+					 });
+
+	ImVec2 min = ImGui::GetCursorScreenPos();
+	ImVec2 size(ImGui::GetContentRegionAvail().x, treemap_height);
+	ImVec2 max(min.x + size.x, min.y + size.y);
+	ImGui::InvisibleButton("##Treemap", size);
+	bool is_hovered = ImGui::IsItemHovered();
+	ImVec2 mouse = ImGui::GetMousePos();
+
+	std::vector<double> group_weights;
+	for (auto &group : group_names) {
+		group_weights.push_back(group_totals[group]);
+	}
+	std::vector<TreemapRect> group_rects(group_names.size());
+	layout_treemap(group_weights, 0, group_names.size(), min, max, group_rects);
+
+	ImDrawList *draw_list = ImGui::GetWindowDrawList();
+	const float font_size = ImGui::GetFontSize();
+	for (size_t g = 0; g < group_names.size(); ++g) {
+		auto &group_entries = groups[group_names[g]];
+
+		std::vector<double> weights;
+		for (auto entry : group_entries) {
+			weights.push_back((double)entry->converted_bytes);
+		}
+		std::vector<TreemapRect> rects(group_entries.size());
+		layout_treemap(weights, 0, group_entries.size(), group_rects[g].min, group_rects[g].max,
+					   rects);
+
+		for (size_t i = 0; i < group_entries.size(); ++i) {
+			const RomSizeEntry *entry = group_entries[i];
+			const TreemapRect &rect = rects[i];
+
+			draw_list->AddRectFilled(rect.min, rect.max, get_type_color(entry->type));
+			draw_list->AddRect(rect.min, rect.max, IM_COL32(30, 30, 30, 255));
+
+			float text_width = ImGui::CalcTextSize(entry->name.c_str()).x;
+			if (rect.max.x - rect.min.x > text_width + 4.f &&
+				rect.max.y - rect.min.y > font_size + 4.f) {
+				draw_list->AddText(ImVec2(rect.min.x + 2.f, rect.min.y + 2.f),
+								   IM_COL32(255, 255, 255, 230), entry->name.c_str());
+			}
+
+			if (is_hovered && mouse.x >= rect.min.x && mouse.x < rect.max.x &&
+				mouse.y >= rect.min.y && mouse.y < rect.max.y) {
+				draw_list->AddRect(rect.min, rect.max, IM_COL32(255, 255, 0, 255));
+				ImGui::SetTooltip("%s (%s)\n%s\nSource: %s\nConverted: %s", entry->name.c_str(),
+								  entry->type.c_str(), entry->dfs_path.c_str(),
+								  format_kb(entry->source_bytes).c_str(),
+								  format_kb(entry->converted_bytes).c_str());
+			}
+		}
+
+		draw_list->AddRect(group_rects[g].min, group_rects[g].max, IM_COL32(255, 255, 255, 255),
+						   0.f, 0, 2.f);
+	}
+}
+
+void RomSizeReport::DrawTable() {
+	std::vector<std::string> group_names;
+	std::map<std::string, std::vector<const RomSizeEntry *>> groups;
+	std::map<std::string, uintmax_t> group_totals;
+	for (auto &entry : entries) {
+		const std::string &group = group_by_type ? entry.type : entry.dfs_folder;
+		if (!groups.contains(group))
+			group_names.push_back(group);
+
+		groups[group].push_back(&entry);
+		group_totals[group] += entry.converted_bytes;
+	}
+
+	if (ImGui::BeginTable("RomSizeReport", 5,
+						  ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+							  ImGuiTableFlags_ScrollY)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Asset");
+		ImGui::TableSetupColumn("Type");
+		ImGui::TableSetupColumn("Source");
+		ImGui::TableSetupColumn("Converted");
+		ImGui::TableSetupColumn("Change");
+		ImGui::TableHeadersRow();
+
+		for (auto &group : group_names) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			bool is_open_group = ImGui::TreeNodeEx(group.c_str(),
+												   ImGuiTreeNodeFlags_DefaultOpen |
+													   ImGuiTreeNodeFlags_SpanFullWidth);
+			ImGui::TableNextColumn();
+			ImGui::TableNextColumn();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(format_kb(group_totals[group]).c_str());
+			ImGui::TableNextColumn();
+			if (!is_open_group)
+				continue;
+
+			for (auto entry : groups[group]) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(entry->name.c_str());
+				if (ImGui::IsItemHovered())
+					ImGui::SetTooltip("%s", entry->dfs_path.c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(entry->type.c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(format_kb(entry->source_bytes).c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(format_kb(entry->converted_bytes).c_str());
+				ImGui::TableNextColumn();
+				if (has_previous) {
+					auto previous_size = previous_sizes.find(entry->dfs_path);
+					if (previous_size == previous_sizes.end())
+						ImGui::TextUnformatted("new");
+					else if (entry->converted_bytes > previous_size->second)
+						ImGui::TextColored(
+							color_invalid_input, "%s",
+							format_delta(entry->converted_bytes, previous_size->second).c_str());
+					else if (entry->converted_bytes < previous_size->second)
+						ImGui::TextUnformatted(
+							format_delta(entry->converted_bytes, previous_size->second).c_str());
+				}
+			}
+			ImGui::TreePop();
+		}
+		ImGui::EndTable();
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "ReportHistory.h"
+
+class App;
+class Project;
+
+// One file (or folder, for maps) on 'build/filesystem' and the asset it was converted from.
+struct RomSizeEntry {
+	std::string dfs_path;
+	std::string name;
+	std::string type;
+	std::string dfs_folder;
+	uintmax_t source_bytes;
+	uintmax_t converted_bytes;
+};
+
+// What is filling the rom after a build, shown on the 'ROM Size Report' window. Each analysis is
+// saved to 'rom_size_report.json' on the project folder, together with the sizes of the previous
+// build so growing assets can be flagged.
+class RomSizeReport {
+   public:
+	bool is_open;
+
+	RomSizeReport();
+
+	bool Analyze(const Project &project);
+
+	void Draw(App &app);
+
+   private:
+	std::vector<RomSizeEntry> entries;
+	uintmax_t rom_bytes;
+	uintmax_t dfs_bytes;
+	int64_t rom_time;
+
+	bool has_previous;
+	std::map<std::string, uintmax_t> previous_sizes;
+	uintmax_t previous_rom_bytes;
+	uintmax_t previous_dfs_bytes;
+
+	bool group_by_type;
+	ReportHistory history;
+
+	void DrawTreemap();
+	void DrawTable();
+};
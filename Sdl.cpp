@@ -1,8 +1,10 @@
 #include "Sdl.h"
 
+#include <atomic>
 #include <cstdio>
 #include <string>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_ttf.h>
 
 #include "imgui.h"
@@ -11,13 +13,15 @@
 
 #include "App.h"
 
+static Uint32 wake_up_event = (Uint32)-1;
+static std::atomic_bool wake_up_pending(false);
+
 void Sdl::Init(App *app) {
 	int rendererFlags, windowFlags;
 
-	rendererFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE;
-#ifndef DEBUG
-	rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
-#endif
+	// frames are only drawn when something changes, so vsync is fine on debug builds as well
+	rendererFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE |
+					SDL_RENDERER_PRESENTVSYNC;
 	windowFlags = SDL_WINDOW_RESIZABLE;
 
 	if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
@@ -25,6 +29,8 @@ void Sdl::Init(App *app) {
 		exit(1);
 	}
 
+	wake_up_event = SDL_RegisterEvents(1);
+
 	IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG | IMG_INIT_TIF);
 	TTF_Init();
 
@@ -65,12 +71,14 @@ void Sdl::Init(App *app) {
 		fprintf(stderr, "Unable to allocate mixing channels: %s\n", SDL_GetError());
 		exit(-1);
 	}
+
+	app->audio_preview.Init();
+	app->textures.Init();
 }
 
 void Sdl::Quit(App *app, SDL_Window *window, SDL_Renderer *renderer) {
-	if (app->audio_sample) {
-		Mix_FreeChunk(app->audio_sample);
-	}
+	app->textures.Quit();
+	app->audio_preview.Quit();
 	Mix_CloseAudio();
 
 	ImGui_ImplSDLRenderer_Shutdown();
@@ -85,9 +93,34 @@ void Sdl::Quit(App *app, SDL_Window *window, SDL_Renderer *renderer) {
 }
 
 void Sdl::ProcessEvent(SDL_Event *event) {
+	if (event->type == wake_up_event) {
+		wake_up_pending = false;
+		return;
+	}
+
 	ImGui_ImplSDL2_ProcessEvent(event);
 }
 
+bool Sdl::NextEvent(SDL_Event *event, int timeout) {
+	if (timeout <= 0)
+		return SDL_PollEvent(event);
+
+	return SDL_WaitEventTimeout(event, timeout);
+}
+
+void Sdl::WakeUp() {
+	if (wake_up_event == (Uint32)-1)
+		return;
+
+	// one pending event is enough no matter how many lines are logged
+	if (wake_up_pending.exchange(true))
+		return;
+
+	SDL_Event event = {};
+	event.type = wake_up_event;
+	SDL_PushEvent(&event);
+}
+
 void Sdl::NewFrame() {
 	ImGui_ImplSDLRenderer_NewFrame();
 	ImGui_ImplSDL2_NewFrame();
@@ -103,5 +136,8 @@ void Sdl::RenderStart(SDL_Renderer *renderer) {
 
 void Sdl::RenderEnd(SDL_Renderer *renderer) {
 	ImGui_ImplSDLRenderer_RenderDrawData(ImGui::GetDrawData());
+}
+
+void Sdl::Present(SDL_Renderer *renderer) {
 	SDL_RenderPresent(renderer);
 }
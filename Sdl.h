@@ -10,8 +10,13 @@ class Sdl {
 	static void Quit(App* app, SDL_Window *window, SDL_Renderer *renderer);
 
 	static void ProcessEvent(SDL_Event *event);
+	// waits up to 'timeout' ms for the next event, or just polls when 'timeout' is 0
+	static bool NextEvent(SDL_Event *event, int timeout);
+	// wakes the main loop up from any thread (new console output, finished commands...)
+	static void WakeUp();
 
 	static void NewFrame();
 	static void RenderStart(SDL_Renderer *renderer);
 	static void RenderEnd(SDL_Renderer *renderer);
+	static void Present(SDL_Renderer *renderer);
 };
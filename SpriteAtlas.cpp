@@ -0,0 +1,91 @@
+#include "SpriteAtlas.h"
+
+#include <cctype>
+#include <map>
+
+#include "ConsoleApp.h"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+// tries power of two sheets, growing the smallest side, until everything fits
+static bool pack_atlas(SpriteAtlas &atlas, std::vector<stbrp_rect> &rects) {
+	int area = 0;
+	for (auto &rect : rects) {
+		area += rect.w * rect.h;
+	}
+
+	int width = 8, height = 8;
+	while (width * height < area) {
+		if (width <= height)
+			width *= 2;
+		else
+			height *= 2;
+	}
+
+	std::vector<stbrp_node> nodes(atlas_max_size);
+	while (width <= atlas_max_size && height <= atlas_max_size) {
+		stbrp_context context;
+		stbrp_init_target(&context, width, height, nodes.data(), (int)nodes.size());
+		if (stbrp_pack_rects(&context, rects.data(), (int)rects.size())) {
+			atlas.width = width;
+			atlas.height = height;
+			return true;
+		}
+
+		if (width <= height)
+			width *= 2;
+		else
+			height *= 2;
+	}
+
+	return false;
+}
+
+std::vector<SpriteAtlas> pack_sprite_atlases(
+	const std::vector<std::unique_ptr<LibdragonImage>> &images) {
+	std::map<std::string, SpriteAtlas> groups;
+	for (auto &image : images) {
+		if (image->atlas_group.empty())
+			continue;
+
+		SpriteAtlas &atlas = groups[image->atlas_group];
+		atlas.name = image->atlas_group;
+		atlas.sprites.push_back({image.get(), 0, 0});
+	}
+
+	std::vector<SpriteAtlas> atlases;
+	for (auto &[name, atlas] : groups) {
+		std::vector<stbrp_rect> rects;
+		for (size_t i = 0; i < atlas.sprites.size(); ++i) {
+			stbrp_rect rect = {};
+			rect.id = (int)i;
+			rect.w = atlas.sprites[i].image->width + atlas_padding * 2;
+			rect.h = atlas.sprites[i].image->height + atlas_padding * 2;
+			rects.push_back(rect);
+		}
+
+		if (!pack_atlas(atlas, rects)) {
+			console.AddLog("[error] Sprites of atlas '%s' do not fit on a %dx%d sheet.",
+						   name.c_str(), atlas_max_size, atlas_max_size);
+			continue;
+		}
+
+		for (auto &rect : rects) {
+			atlas.sprites[rect.id].x = rect.x + atlas_padding;
+			atlas.sprites[rect.id].y = rect.y + atlas_padding;
+		}
+		atlases.push_back(atlas);
+	}
+
+	return atlases;
+}
+
+std::string get_atlas_identifier(const std::string &name) {
+	std::string identifier;
+	for (char c : name) {
+		identifier += std::isalnum((unsigned char)c) ? (char)std::toupper((unsigned char)c) : '_';
+	}
+	return identifier;
+}
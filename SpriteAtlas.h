@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LibdragonImage.h"
+
+struct AtlasSprite {
+	const LibdragonImage *image;
+	// top left corner on the atlas, without the padding
+	int x;
+	int y;
+};
+
+// Sprites tagged with the same 'atlas_group', packed on a single sheet.
+struct SpriteAtlas {
+	std::string name;
+	int width;
+	int height;
+	std::vector<AtlasSprite> sprites;
+};
+
+// transparent pixels around each sprite, so filtering never reads a neighbour
+const int atlas_padding = 1;
+const int atlas_max_size = 1024;
+
+// Packs every atlas group, ordered by name. Only the image sizes are used, so the layout is the
+// same when generating code and when building the sheets.
+std::vector<SpriteAtlas> pack_sprite_atlases(
+	const std::vector<std::unique_ptr<LibdragonImage>> &images);
+
+// 'name' turned into a valid C identifier, upper case
+std::string get_atlas_identifier(const std::string &name);
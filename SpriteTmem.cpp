@@ -0,0 +1,118 @@
+#include "SpriteTmem.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_custom.h"
+
+static int align_8(int bytes) {
+	return (bytes + 7) & ~7;
+}
+
+static int get_tmem_row_bytes(int width, int bits) {
+	// 32 bits texels are split in two halves of TMEM (red/green and blue/alpha)
+	if (bits == 32)
+		return align_8(width * 2) * 2;
+
+	return align_8((width * bits + 7) / 8);
+}
+
+TmemUsage get_sprite_tmem_usage(int width, int height, int h_slices, int v_slices, int bits,
+								bool indexed) {
+	TmemUsage usage = {};
+	usage.frame_width = width / std::max(h_slices, 1);
+	usage.frame_height = height / std::max(v_slices, 1);
+	usage.bits = bits;
+	usage.row_bytes = get_tmem_row_bytes(usage.frame_width, bits);
+	usage.bytes = usage.row_bytes * usage.frame_height;
+	usage.limit = indexed ? tmem_bytes / 2 : tmem_bytes;
+
+	if (usage.frame_width <= 0 || usage.frame_height <= 0)
+		return usage;
+
+	if (usage.row_bytes <= usage.limit) {
+		// loaded in strips of full rows
+		int rows_per_load = usage.limit / usage.row_bytes;
+		usage.loads = (usage.frame_height + rows_per_load - 1) / rows_per_load;
+	} else {
+		// not even one row fits, each row is loaded in pieces
+		int max_width = bits == 32 ? usage.limit / 4 : usage.limit * 8 / bits;
+		usage.loads = ((usage.frame_width + max_width - 1) / max_width) * usage.frame_height;
+	}
+
+	return usage;
+}
+
+std::vector<SliceSuggestion> suggest_tmem_slices(int width, int height, int bits, bool indexed,
+												 int max_suggestions) {
+	std::vector<SliceSuggestion> suggestions;
+	for (int h = 1; h <= width; ++h) {
+		if (width % h != 0)
+			continue;
+
+		for (int v = 1; v <= height; ++v) {
+			if (height % v != 0)
+				continue;
+
+			if (get_sprite_tmem_usage(width, height, h, v, bits, indexed).Fits()) {
+				suggestions.push_back({h, v});
+				// more slices on this column only make it smaller
+				break;
+			}
+		}
+	}
+
+	// fewest frames, then the most square ones
+	std::sort(suggestions.begin(), suggestions.end(),
+			  [width, height](const SliceSuggestion &a, const SliceSuggestion &b) {
+				  int a_frames = a.h_slices * a.v_slices, b_frames = b.h_slices * b.v_slices;
+				  if (a_frames != b_frames)
+					  return a_frames < b_frames;
+
+				  return std::abs(width / a.h_slices - height / a.v_slices) <
+						 std::abs(width / b.h_slices - height / b.v_slices);
+			  });
+	if ((int)suggestions.size() > max_suggestions)
+		suggestions.resize(max_suggestions);
+
+	return suggestions;
+}
+
+bool render_sprite_tmem_fit(int width, int height, int &h_slices, int &v_slices, int bits,
+							bool indexed) {
+	TmemUsage usage = get_sprite_tmem_usage(width, height, h_slices, v_slices, bits, indexed);
+	if (usage.Fits()) {
+		ImGui::Text("TMEM: %d / %d bytes per frame", usage.bytes, usage.limit);
+		return false;
+	}
+
+	ImGui::TextColored(color_invalid_input, "TMEM: %d / %d bytes per frame, %d loads per draw",
+					   usage.bytes, usage.limit, usage.loads);
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip(
+			"Each %dx%d frame needs more than one texture load. Use more slices so every frame "
+			"fits on TMEM.",
+			usage.frame_width, usage.frame_height);
+	}
+
+	bool changed = false;
+	std::vector<SliceSuggestion> suggestions = suggest_tmem_slices(width, height, bits, indexed);
+	if (!suggestions.empty()) {
+		ImGui::TextUnformatted("Suggested slices:");
+		for (auto &suggestion : suggestions) {
+			char label[32];
+			snprintf(label, 32, "%dx%d", suggestion.h_slices, suggestion.v_slices);
+
+			ImGui::SameLine();
+			if (ImGui::SmallButton(label)) {
+				h_slices = suggestion.h_slices;
+				v_slices = suggestion.v_slices;
+				changed = true;
+			}
+		}
+	}
+
+	return changed;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+// texture memory of the RDP, everything drawn by one texture load has to fit here
+const int tmem_bytes = 4096;
+
+struct TmemUsage {
+	int frame_width;
+	int frame_height;
+	int bits;
+	// bytes of one row of texels on TMEM, rows are 8 bytes aligned
+	int row_bytes;
+	int bytes;
+	// TMEM available for the texels: half of it holds the palette on the indexed formats
+	int limit;
+	// loads needed to draw a whole frame
+	int loads;
+
+	[[nodiscard]] bool Fits() const {
+		return loads <= 1;
+	}
+};
+
+struct SliceSuggestion {
+	int h_slices;
+	int v_slices;
+};
+
+TmemUsage get_sprite_tmem_usage(int width, int height, int h_slices, int v_slices, int bits,
+								bool indexed);
+
+// Slices that divide the image evenly and fit each frame on one load, fewest frames first.
+std::vector<SliceSuggestion> suggest_tmem_slices(int width, int height, int bits, bool indexed,
+												 int max_suggestions = 3);
+
+/**
+ * Shows if each frame fits on TMEM and, when it does not, buttons with the suggested slices.
+ * Returns if a suggestion was picked ('h_slices' and 'v_slices' are updated).
+ */
+bool render_sprite_tmem_fit(int width, int height, int &h_slices, int &v_slices, int bits,
+							bool indexed);
@@ -0,0 +1,250 @@
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <SDL2/SDL_image.h>
+
+#include "App.h"
+#include "LibdragonFont.h"
+#include "LibdragonImage.h"
+#include "Sdl.h"
+
+// uploading is done on the main thread (the renderer is not thread-safe), so keep each frame short
+const int max_uploads_per_frame = 2;
+// textures drawn this recently are never evicted, otherwise a small budget would load every frame
+const Uint32 keep_time = 1000;
+
+struct ResidentTexture {
+	Uint32 last_drawn;
+	size_t bytes;
+	std::function<void()> evict;
+};
+
+size_t texture_bytes(SDL_Texture *texture) {
+	if (!texture)
+		return 0;
+
+	int w, h;
+	if (SDL_QueryTexture(texture, nullptr, nullptr, &w, &h) != 0)
+		return 0;
+
+	return (size_t)w * (size_t)h * 4;
+}
+
+SDL_Texture *create_thumbnail(SDL_Renderer *renderer, SDL_Surface *surface, int max_width,
+							  int max_height) {
+	if (!surface)
+		return nullptr;
+
+	SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	if (!converted)
+		return nullptr;
+
+	SDL_Surface *scaled = SDL_CreateRGBSurfaceWithFormat(0, std::min(surface->w, max_width),
+														 std::min(surface->h, max_height), 32,
+														 SDL_PIXELFORMAT_RGBA32);
+	if (!scaled) {
+		SDL_FreeSurface(converted);
+		return nullptr;
+	}
+
+	// copy the alpha channel as is instead of blending it with the empty surface
+	SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);
+	SDL_BlitScaled(converted, nullptr, scaled, nullptr);
+
+	SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, scaled);
+
+	SDL_FreeSurface(scaled);
+	SDL_FreeSurface(converted);
+
+	return texture;
+}
+
+static std::function<SDL_Surface *()> full_image_decoder(const LibdragonImage &image,
+														const std::string &path) {
+	return [path]() { return IMG_Load(path.c_str()); };
+}
+
+static std::function<SDL_Surface *()> full_image_decoder(const LibdragonFont &font,
+														const std::string &path) {
+	const int font_size = font.font_size;
+	return [path, font_size]() {
+		return LibdragonFont::LoadSurfaceFromFont(path.c_str(), font_size, nullptr);
+	};
+}
+
+template <typename T, typename Job>
+static void queue_requested(App &app, std::vector<std::unique_ptr<T>> &assets,
+							std::vector<const void *> &pending, std::deque<Job> &queued) {
+	for (auto &asset : assets) {
+		if (!asset->full_image_requested)
+			continue;
+		if (std::find(pending.begin(), pending.end(), asset.get()) != pending.end())
+			continue;
+
+		std::string path = asset->GetFullImagePath(app.project.project_settings.project_directory);
+		pending.push_back(asset.get());
+		queued.push_back({asset.get(), path, full_image_decoder(*asset, path), nullptr});
+	}
+}
+
+// returns false if the job does not belong to any of 'assets', the surface is not taken then
+template <typename T, typename Job>
+static bool upload_decoded(App &app, std::vector<std::unique_ptr<T>> &assets, Job &job) {
+	for (auto &asset : assets) {
+		if (asset.get() != job.asset)
+			continue;
+
+		// reloaded or replaced while it was decoding, it is requested again on the next draw
+		if (!asset->full_image_requested ||
+			asset->GetFullImagePath(app.project.project_settings.project_directory) != job.path)
+			return false;
+
+		asset->SetFullImage(app.renderer, job.surface);
+		return true;
+	}
+	return false;
+}
+
+template <typename T>
+static void collect_resident(std::vector<std::unique_ptr<T>> &assets,
+							 std::vector<ResidentTexture> &resident, int &evicted_count,
+							 size_t &thumbnail_bytes) {
+	for (auto &asset : assets) {
+		thumbnail_bytes += texture_bytes(asset->thumbnail);
+
+		size_t bytes = asset->GetFullImageBytes();
+		if (bytes == 0) {
+			++evicted_count;
+			continue;
+		}
+
+		T *ptr = asset.get();
+		resident.push_back({asset->last_drawn, bytes, [ptr]() { ptr->EvictFullImage(); }});
+	}
+}
+
+TextureResidency::TextureResidency()
+	: is_decoding(false),
+	  resident_count(0),
+	  resident_bytes(0),
+	  evicted_count(0),
+	  thumbnail_bytes(0),
+	  total_loads(0),
+	  total_evictions(0) {
+}
+
+TextureResidency::~TextureResidency() {
+	Quit();
+}
+
+void TextureResidency::Init() {
+	is_decoding = true;
+	decode_thread = std::thread(&TextureResidency::DecodeLoop, this);
+}
+
+void TextureResidency::Quit() {
+	if (decode_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			is_decoding = false;
+		}
+		jobs_changed.notify_one();
+		decode_thread.join();
+	}
+
+	for (auto &job : decoded) {
+		SDL_FreeSurface(job.surface);
+	}
+	decoded.clear();
+	queued.clear();
+	pending.clear();
+}
+
+void TextureResidency::DecodeLoop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		jobs_changed.wait(lock, [this]() { return !is_decoding || !queued.empty(); });
+		if (!is_decoding)
+			break;
+
+		DecodeJob job = std::move(queued.front());
+		queued.pop_front();
+
+		lock.unlock();
+		job.surface = job.decode();
+		lock.lock();
+
+		decoded.push_back(std::move(job));
+		Sdl::WakeUp();
+	}
+}
+
+void TextureResidency::Update(App &app) {
+	std::vector<DecodeJob> uploads;
+	bool has_more_uploads;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue_requested(app, app.project.images, pending, queued);
+		queue_requested(app, app.project.fonts, pending, queued);
+
+		const size_t count = std::min(decoded.size(), (size_t)max_uploads_per_frame);
+		std::move(decoded.begin(), decoded.begin() + (long)count, std::back_inserter(uploads));
+		decoded.erase(decoded.begin(), decoded.begin() + (long)count);
+		has_more_uploads = !decoded.empty();
+	}
+	jobs_changed.notify_one();
+
+	int loads = 0;
+	for (auto &job : uploads) {
+		std::erase(pending, job.asset);
+
+		if (upload_decoded(app, app.project.images, job) ||
+			upload_decoded(app, app.project.fonts, job))
+			++loads;
+		else
+			SDL_FreeSurface(job.surface);
+	}
+	total_loads += loads;
+
+	// draw again with the full texture, and pick up the uploads that did not fit on this frame
+	if (loads > 0 || has_more_uploads)
+		Sdl::WakeUp();
+
+	std::vector<ResidentTexture> resident;
+	evicted_count = 0;
+	thumbnail_bytes = 0;
+	collect_resident(app.project.images, resident, evicted_count, thumbnail_bytes);
+	collect_resident(app.project.fonts, resident, evicted_count, thumbnail_bytes);
+
+	resident_bytes = 0;
+	for (auto &texture : resident) {
+		resident_bytes += texture.bytes;
+	}
+	resident_count = (int)resident.size();
+
+	const size_t budget = (size_t)app.engine_settings.GetTextureBudget() * 1024 * 1024;
+	if (resident_bytes <= budget)
+		return;
+
+	std::sort(resident.begin(), resident.end(),
+			  [](const ResidentTexture &a, const ResidentTexture &b) {
+				  return a.last_drawn < b.last_drawn;
+			  });
+
+	const Uint32 now = SDL_GetTicks();
+	for (auto &texture : resident) {
+		if (resident_bytes <= budget || now - texture.last_drawn < keep_time)
+			break;
+
+		texture.evict();
+
+		resident_bytes -= texture.bytes;
+		--resident_count;
+		++evicted_count;
+		++total_evictions;
+	}
+}
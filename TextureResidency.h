@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL2/SDL.h>
+
+class App;
+
+// RGBA32 estimate, the renderer does not expose the real allocation size
+size_t texture_bytes(SDL_Texture *texture);
+
+// Creates a copy of 'surface' scaled down to fit 'max_width' x 'max_height'.
+SDL_Texture *create_thumbnail(SDL_Renderer *renderer, SDL_Surface *surface, int max_width,
+							  int max_height);
+
+// Keeps the full resolution textures of sprites and fonts under a memory budget. Thumbnails are
+// always resident, the full textures are loaded the first time they are drawn and the least
+// recently drawn ones are evicted when the budget is exceeded. Images are decoded on a worker
+// thread, only the texture upload runs on the main thread.
+class TextureResidency {
+   public:
+	TextureResidency();
+	~TextureResidency();
+
+	void Init();
+	// stops the worker, must be called before SDL_image and SDL_ttf are shut down
+	void Quit();
+
+	// queues the textures requested on the last frame, uploads the decoded ones and evicts the ones
+	// over the budget
+	void Update(App &app);
+
+	[[nodiscard]] int GetResidentCount() const {
+		return resident_count;
+	}
+	[[nodiscard]] size_t GetResidentBytes() const {
+		return resident_bytes;
+	}
+	[[nodiscard]] int GetEvictedCount() const {
+		return evicted_count;
+	}
+	[[nodiscard]] size_t GetThumbnailBytes() const {
+		return thumbnail_bytes;
+	}
+	[[nodiscard]] int GetTotalLoads() const {
+		return total_loads;
+	}
+	[[nodiscard]] int GetTotalEvictions() const {
+		return total_evictions;
+	}
+
+   private:
+	struct DecodeJob {
+		// only compared, the asset may be gone by the time the job is done
+		const void *asset;
+		std::string path;
+		std::function<SDL_Surface *()> decode;
+		SDL_Surface *surface;
+	};
+
+	// assets with a job queued, being decoded or waiting for the upload, main thread only
+	std::vector<const void *> pending;
+
+	std::mutex mutex;
+	std::condition_variable jobs_changed;
+	std::deque<DecodeJob> queued;
+	std::vector<DecodeJob> decoded;
+	bool is_decoding;
+	std::thread decode_thread;
+
+	void DecodeLoop();
+
+	int resident_count;
+	size_t resident_bytes;
+	int evicted_count;
+	size_t thumbnail_bytes;
+	int total_loads;
+	int total_evictions;
+};
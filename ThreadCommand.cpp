@@ -1,5 +1,6 @@
 #include "ThreadCommand.h"
 
+#include <functional>
 #include <queue>
 #include <thread>
 #include <unistd.h>
@@ -7,6 +8,7 @@
 
 #include "App.h"
 #include "ConsoleApp.h"
+#include "Sdl.h"
 
 extern App *g_app;
 
@@ -16,12 +18,15 @@ char separator[] = " && \0";
 char separator[] = "\n\0";
 #endif
 
-int exec(std::string cmd) {
+// 'line_filter', when set, sees each output line as it arrives, the ones it takes are not logged
+int exec(std::string cmd,
+		 const std::function<bool(const std::string &)> &line_filter = nullptr) {
 	if (!cmd.starts_with("echo"))
 		console.AddLog("%s", cmd.c_str());
 
 	char buffer[128];
 	std::string output;
+	std::string line;
 
 	cmd.append(" 2>&1");
 
@@ -42,9 +47,22 @@ int exec(std::string cmd) {
 
 	while (!feof(pipe)) {
 		if (fgets(buffer, 128, pipe) != nullptr) {
-			output += buffer;
+			if (!line_filter) {
+				output += buffer;
+				continue;
+			}
+
+			// lines longer than the buffer come in pieces
+			line += buffer;
+			if (line.back() == '\n') {
+				if (!line_filter(line))
+					output += line;
+				line.clear();
+			}
 		}
 	}
+	if (!line.empty() && !line_filter(line))
+		output += line;
 
 	if (!output.empty()) {
 		console.AddLog("%s", output.c_str());
@@ -97,16 +115,30 @@ int exec_result(std::string cmd, std::string &result) {
 	return result_code;
 }
 
+// either a shell command or, when 'callback' is set, a step that runs in-process
+struct QueuedCommand {
+	std::string command;
+	std::function<bool()> callback;
+	std::function<bool(const std::string &)> line_filter;
+};
+
 static bool is_running_command;
-static std::string current_command;
+static QueuedCommand current_command;
 
-static std::queue<std::string> command_queue;
+static std::queue<QueuedCommand> command_queue;
 
 static void run_next_command();
 
-static void command_thread(const char *command) {
-	int result = exec(command);
-	bool success = result == EXIT_SUCCESS;
+static void command_thread() {
+	bool success;
+	if (current_command.callback) {
+		success = current_command.callback();
+	} else {
+		int result = exec(current_command.command, current_command.line_filter);
+		success = result == EXIT_SUCCESS;
+		if (!success)
+			console.AddLog("[error] Process returned %d.", result);
+	}
 
 	if (success) {
 		if (command_queue.empty()) {
@@ -115,7 +147,6 @@ static void command_thread(const char *command) {
 			run_next_command();
 		}
 	} else {
-		console.AddLog("[error] Process returned %d.", result);
 		if (!command_queue.empty()) {
 			// on failure stop all other queued commands
 			while (!command_queue.empty()) {
@@ -125,15 +156,17 @@ static void command_thread(const char *command) {
 
 		is_running_command = false;
 	}
+
+	Sdl::WakeUp();
 }
 
 static void run_next_command() {
 	current_command = command_queue.front();
-	std::thread(command_thread, current_command.c_str()).detach();
+	std::thread(command_thread).detach();
 	command_queue.pop();
 }
 
-void ThreadCommand::QueueCommand(std::string command) {
+static void queue_command(QueuedCommand command) {
 	command_queue.push(std::move(command));
 
 	if (is_running_command)
@@ -143,6 +176,27 @@ void ThreadCommand::QueueCommand(std::string command) {
 	run_next_command();
 }
 
+void ThreadCommand::QueueCommand(std::string command) {
+	queue_command({std::move(command), nullptr, nullptr});
+}
+
+void ThreadCommand::QueueCommand(std::string command,
+								 std::function<bool(const std::string &)> line_filter) {
+	queue_command({std::move(command), nullptr, std::move(line_filter)});
+}
+
+void ThreadCommand::QueueCallback(std::function<bool()> callback) {
+	queue_command({"", std::move(callback), nullptr});
+}
+
+bool ThreadCommand::IsRunning() {
+	return is_running_command;
+}
+
+size_t ThreadCommand::GetQueueSize() {
+	return command_queue.size() + (is_running_command ? 1 : 0);
+}
+
 static int run_command(std::string command) {
 	return exec(command);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 
 extern char separator[];
@@ -7,7 +8,18 @@ extern char separator[];
 class ThreadCommand {
    public:
 	static void QueueCommand(std::string command);
+	// same, but each output line goes through 'line_filter' while the command runs, the lines it
+	// returns true for are kept out of the console
+	static void QueueCommand(std::string command,
+							 std::function<bool(const std::string &)> line_filter);
+	// runs 'callback' on the command thread after the commands queued before it, returning false
+	// stops the queue like a failed command
+	static void QueueCallback(std::function<bool()> callback);
 	static int RunCommand(std::string command);
 	static int RunCommand(std::string command, std::string &result);
 	static void RunCommandDetached(std::string command);
+
+	static bool IsRunning();
+	// commands waiting on the queue, including the one currently running
+	static size_t GetQueueSize();
 };
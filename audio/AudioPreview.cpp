@@ -0,0 +1,245 @@
+#include "AudioPreview.h"
+
+#include <algorithm>
+#include <SDL2/SDL_mixer.h>
+
+#include "../Sdl.h"
+#include "WavSource.h"
+#include "XmSource.h"
+#include "YmSource.h"
+
+// about a third of a second at 44100 Hz, far more than a mixer callback asks for
+const int ring_frames = 16384;
+const int decode_chunk_frames = 1024;
+const Uint32 decode_idle_ms = 5;
+
+AudioPreview::AudioPreview()
+	: source(),
+	  output_rate(44100),
+	  state(),
+	  volume(),
+	  is_hooked(false),
+	  ring(ring_frames * 2),
+	  ring_read(0),
+	  ring_write(0),
+	  flush_requested(false),
+	  flush_to(0),
+	  flush_position(0),
+	  source_ended(false),
+	  position(0),
+	  duration(0),
+	  is_decoding(false) {
+	SDL_AtomicSet(&state, SS_STOPPED);
+	SDL_AtomicSet(&volume, MIX_MAX_VOLUME);
+}
+
+AudioPreview::~AudioPreview() {
+	Quit();
+}
+
+void AudioPreview::Init() {
+	int frequency;
+	Uint16 format;
+	int channels;
+	if (Mix_QuerySpec(&frequency, &format, &channels) != 0) {
+		output_rate = frequency;
+	}
+
+	is_decoding = true;
+	decode_thread = std::thread(&AudioPreview::DecodeLoop, this);
+
+	Mix_HookMusic(&AudioPreview::MixCallback, this);
+	is_hooked = true;
+}
+
+void AudioPreview::Quit() {
+	if (is_hooked) {
+		Mix_HookMusic(nullptr, nullptr);
+		is_hooked = false;
+	}
+	if (decode_thread.joinable()) {
+		is_decoding = false;
+		decode_thread.join();
+	}
+	Close();
+}
+
+bool AudioPreview::Open(const std::string &path, LibdragonSoundType type) {
+	Close();
+
+	switch (type) {
+		case SOUND_WAV: {
+			auto wav = std::make_unique<WavSource>(output_rate);
+			if (!wav->OpenWav(path))
+				return false;
+			SetSource(std::move(wav));
+		} break;
+		case SOUND_XM: {
+			auto xm = std::make_unique<XmSource>(output_rate);
+			if (!xm->Open(path))
+				return false;
+			SetSource(std::move(xm));
+		} break;
+		case SOUND_YM: {
+			auto ym = std::make_unique<YmSource>(output_rate);
+			if (!ym->Open(path))
+				return false;
+			SetSource(std::move(ym));
+		} break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool AudioPreview::OpenWav64(const std::string &path) {
+	Close();
+
+	auto wav = std::make_unique<WavSource>(output_rate);
+	if (!wav->OpenWav64(path))
+		return false;
+
+	SetSource(std::move(wav));
+	return true;
+}
+
+void AudioPreview::Close() {
+	SetSource(nullptr);
+}
+
+void AudioPreview::SetSource(std::unique_ptr<AudioSource> new_source) {
+	// freed outside of the lock so the audio thread is not kept waiting
+	std::unique_ptr<AudioSource> old_source;
+	{
+		std::lock_guard<std::mutex> lock(source_mutex);
+		SDL_AtomicSet(&state, SS_STOPPED);
+		old_source = std::move(source);
+		source = std::move(new_source);
+		duration = source ? source->GetDuration() : 0;
+		RequestFlush(0);
+	}
+}
+
+void AudioPreview::RequestFlush(double seconds) {
+	source_ended = false;
+	flush_to = ring_write.load();
+	flush_position = (Sint64)(seconds * output_rate);
+	flush_requested = true;
+}
+
+void AudioPreview::Play() {
+	std::lock_guard<std::mutex> lock(source_mutex);
+	if (!source)
+		return;
+
+	source->Seek(0);
+	RequestFlush(0);
+	SDL_AtomicSet(&state, SS_PLAYING);
+}
+
+void AudioPreview::Pause() {
+	SDL_AtomicCAS(&state, SS_PLAYING, SS_PAUSED);
+}
+
+void AudioPreview::Resume() {
+	SDL_AtomicCAS(&state, SS_PAUSED, SS_PLAYING);
+}
+
+void AudioPreview::Stop() {
+	SDL_AtomicSet(&state, SS_STOPPED);
+}
+
+void AudioPreview::Seek(double seconds) {
+	std::lock_guard<std::mutex> lock(source_mutex);
+	if (!source)
+		return;
+
+	source->Seek(seconds);
+	RequestFlush(seconds);
+}
+
+void AudioPreview::SetVolume(int new_volume) {
+	SDL_AtomicSet(&volume, std::clamp(new_volume, 0, MIX_MAX_VOLUME));
+}
+
+bool AudioPreview::IsOpen() const {
+	return source != nullptr;
+}
+
+SoundState AudioPreview::GetState() const {
+	return (SoundState)SDL_AtomicGet(const_cast<SDL_atomic_t *>(&state));
+}
+
+double AudioPreview::GetPosition() const {
+	return (double)position / output_rate;
+}
+
+double AudioPreview::GetDuration() const {
+	return duration;
+}
+
+void AudioPreview::DecodeLoop() {
+	while (is_decoding) {
+		bool has_decoded = false;
+		{
+			std::lock_guard<std::mutex> lock(source_mutex);
+			Uint64 write = ring_write;
+			int free_frames = ring_frames - (int)(write - ring_read);
+			if (source && !source_ended && free_frames >= decode_chunk_frames) {
+				// up to the end of the ring, the rest goes on the next chunk
+				int start = (int)(write % ring_frames);
+				int frames = std::min(decode_chunk_frames, ring_frames - start);
+				int rendered = source->Render(&ring[start * 2], frames);
+				ring_write = write + rendered;
+				if (rendered < frames)
+					source_ended = true;
+				has_decoded = true;
+			}
+		}
+		if (!has_decoded)
+			SDL_Delay(decode_idle_ms);
+	}
+}
+
+void AudioPreview::MixCallback(void *udata, Uint8 *stream, int len) {
+	auto *preview = (AudioPreview *)udata;
+	auto *buffer = (Sint16 *)stream;
+	int frames = len / 4;
+
+	if (preview->flush_requested.exchange(false)) {
+		preview->ring_read = preview->flush_to.load();
+		preview->position = preview->flush_position.load();
+	}
+
+	int rendered = 0;
+	if (SDL_AtomicGet(&preview->state) == SS_PLAYING) {
+		Uint64 read = preview->ring_read;
+		bool has_ended = preview->source_ended;
+		int available = (int)(preview->ring_write - read);
+		rendered = std::min(available, frames);
+		for (int i = 0; i < rendered; ++i) {
+			const Sint16 *frame = &preview->ring[((read + i) % ring_frames) * 2];
+			buffer[i * 2] = frame[0];
+			buffer[i * 2 + 1] = frame[1];
+		}
+		preview->ring_read = read + rendered;
+		preview->position += rendered;
+
+		// running short before the end is a late decode, only the end of the source stops it
+		if (has_ended && rendered == available && rendered < frames) {
+			SDL_AtomicSet(&preview->state, SS_STOPPED);
+			// the editor may be idle, so it needs to see the state change
+			Sdl::WakeUp();
+		}
+	}
+
+	int volume = SDL_AtomicGet(&preview->volume);
+	if (volume != MIX_MAX_VOLUME) {
+		for (int i = 0; i < rendered * 2; ++i) {
+			buffer[i] = (Sint16)(buffer[i] * volume / MIX_MAX_VOLUME);
+		}
+	}
+
+	SDL_memset(buffer + rendered * 2, 0, (size_t)(len - rendered * 4));
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "../LibdragonSound.h"
+#include "AudioSource.h"
+
+enum SoundState { SS_STOPPED, SS_PLAYING, SS_PAUSED };
+
+// Plays sound assets on the editor from the SDL_mixer music hook, decoding them as they play
+// instead of loading the whole file up front. Decoding (and its file reads) runs ahead on a
+// worker thread, the mixer callback only copies from a ring buffer.
+class AudioPreview {
+   public:
+	AudioPreview();
+	~AudioPreview();
+
+	// hooks into the mixer, must be called after the audio device is open
+	void Init();
+	// unhooks from the mixer and closes the current source
+	void Quit();
+
+	bool Open(const std::string &path, LibdragonSoundType type);
+	// opens the file built by audioconv64 instead of the source file
+	bool OpenWav64(const std::string &path);
+	void Close();
+
+	void Play();
+	void Pause();
+	void Resume();
+	void Stop();
+	void Seek(double seconds);
+	// 0 to MIX_MAX_VOLUME
+	void SetVolume(int new_volume);
+
+	[[nodiscard]] bool IsOpen() const;
+	[[nodiscard]] SoundState GetState() const;
+	[[nodiscard]] double GetPosition() const;
+	[[nodiscard]] double GetDuration() const;
+
+   private:
+	// taken by the decode thread while rendering, never by the mixer callback
+	std::unique_ptr<AudioSource> source;
+	std::mutex source_mutex;
+
+	int output_rate;
+	SDL_atomic_t state;
+	SDL_atomic_t volume;
+	bool is_hooked;
+
+	// stereo frames, written by the decode thread and read by the callback, the indexes only grow
+	std::vector<Sint16> ring;
+	std::atomic<Uint64> ring_read;
+	std::atomic<Uint64> ring_write;
+	// set after a seek or a new source, the callback skips what was decoded before 'flush_to'
+	std::atomic<bool> flush_requested;
+	std::atomic<Uint64> flush_to;
+	std::atomic<Sint64> flush_position;
+	// the source has nothing left after what is on the ring
+	std::atomic<bool> source_ended;
+
+	// in frames of the output rate, of what was actually played
+	std::atomic<Sint64> position;
+	std::atomic<double> duration;
+
+	std::atomic<bool> is_decoding;
+	std::thread decode_thread;
+
+	void SetSource(std::unique_ptr<AudioSource> new_source);
+	// with 'source_mutex' held, drops what is on the ring once the callback gets to it
+	void RequestFlush(double seconds);
+	void DecodeLoop();
+
+	static void MixCallback(void *udata, Uint8 *stream, int len);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// Something that can be played by 'AudioPreview'. Sources always render signed 16 bits stereo
+// frames at the rate they were opened with, and are only used from one thread at a time.
+class AudioSource {
+   public:
+	virtual ~AudioSource() = default;
+
+	// renders up to 'frames' frames into 'buffer', returns less than that when the source ended
+	virtual int Render(Sint16 *buffer, int frames) = 0;
+	virtual void Seek(double seconds) = 0;
+
+	// both in seconds
+	[[nodiscard]] virtual double GetPosition() const = 0;
+	[[nodiscard]] virtual double GetDuration() const = 0;
+};
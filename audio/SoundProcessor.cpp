@@ -0,0 +1,207 @@
+#include "SoundProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../ConsoleApp.h"
+
+// width of the resampling filter, in zero crossings of the sinc on each side
+const int zero_crossings = 16;
+// filter phases between two input samples, the ones in between are interpolated
+const int phase_count = 256;
+// kaiser window shape, about 90 dB of stopband attenuation
+const double kaiser_beta = 8.6;
+
+static double bessel_i0(double x) {
+	double sum = 1, term = 1;
+	for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+// Kaiser windowed sinc resampler. The dot product is split in four lanes over contiguous floats so
+// the compiler can vectorize it.
+static std::vector<float> resample(const std::vector<float> &input, int input_rate,
+								   int output_rate) {
+	const double pi = 3.14159265358979323846;
+	const double ratio = (double)input_rate / output_rate;
+	// when lowering the rate the filter also removes what the new rate cannot represent
+	const double cutoff = std::min(1.0, 1.0 / ratio) * .95;
+	const int half_width = (int)std::ceil(zero_crossings / cutoff);
+	const int taps = (half_width * 2 + 3) & ~3;
+
+	std::vector<float> table((size_t)(phase_count + 1) * taps);
+	const double window_scale = 1.0 / bessel_i0(kaiser_beta);
+	for (int p = 0; p <= phase_count; ++p) {
+		for (int t = 0; t < taps; ++t) {
+			// distance to the output position, in input samples
+			double x = t - half_width + 1 - (double)p / phase_count;
+			double w = x / half_width;
+			double window =
+				fabs(w) >= 1 ? 0 : bessel_i0(kaiser_beta * sqrt(1 - w * w)) * window_scale;
+			double sinc = x == 0 ? 1 : sin(pi * cutoff * x) / (pi * cutoff * x);
+
+			table[(size_t)p * taps + t] = (float)(cutoff * sinc * window);
+		}
+	}
+
+	// silence around the samples, so the filter never reads out of range
+	std::vector<float> padded(input.size() + (size_t)taps * 2, 0.f);
+	std::copy(input.begin(), input.end(), padded.begin() + taps);
+
+	std::vector<float> output((size_t)((double)input.size() / ratio));
+	for (size_t i = 0; i < output.size(); ++i) {
+		double position = (double)i * ratio;
+		double base = floor(position);
+		double phase = (position - base) * phase_count;
+		int p = (int)phase;
+		float weight = (float)(phase - p);
+
+		const float *c0 = &table[(size_t)p * taps];
+		const float *c1 = c0 + taps;
+		const float *samples = &padded[(size_t)base - half_width + 1 + taps];
+
+		float lanes[4] = {};
+		for (int t = 0; t < taps; t += 4) {
+			for (int lane = 0; lane < 4; ++lane) {
+				float c = c0[t + lane] + weight * (c1[t + lane] - c0[t + lane]);
+				lanes[lane] += samples[t + lane] * c;
+			}
+		}
+
+		output[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+
+	return output;
+}
+
+SoundFormat get_source_format(const WavInfo &info) {
+	return {info.rate, info.channels, std::min(info.bits, 16)};
+}
+
+SoundFormat get_processed_format(const WavInfo &info, const SoundProcessOptions &options) {
+	SoundFormat format = get_source_format(info);
+
+	if (options.frequency > 0 && options.frequency < format.rate)
+		format.rate = options.frequency;
+	if (options.mono)
+		format.channels = 1;
+	format.bits = std::min(format.bits, options.bit_depth);
+
+	return format;
+}
+
+bool needs_processing(const WavInfo &info, const SoundProcessOptions &options) {
+	SoundFormat source = get_source_format(info);
+	SoundFormat processed = get_processed_format(info, options);
+
+	return source.rate != processed.rate || source.channels != processed.channels ||
+		   source.bits != processed.bits;
+}
+
+Sint64 get_sound_size(const WavInfo &info, const SoundFormat &format) {
+	Sint64 frames = info.rate > 0 ? info.GetFrames() * format.rate / info.rate : 0;
+	return frames * format.channels * (format.bits / 8);
+}
+
+bool process_sound(const std::string &input_path, const std::string &output_path,
+				   const SoundProcessOptions &options) {
+	SDL_AudioSpec spec;
+	Uint8 *wav_buffer;
+	Uint32 wav_length;
+	if (!SDL_LoadWAV(input_path.c_str(), &spec, &wav_buffer, &wav_length)) {
+		console.AddLog("[error] Could not load '%s': %s", input_path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	// everything is processed as float
+	SDL_AudioCVT cvt;
+	if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, (int)spec.freq, AUDIO_F32SYS,
+						  spec.channels, (int)spec.freq) < 0) {
+		console.AddLog("[error] Could not convert '%s': %s", input_path.c_str(), SDL_GetError());
+		SDL_FreeWAV(wav_buffer);
+		return false;
+	}
+
+	std::vector<Uint8> converted((size_t)wav_length * std::max(cvt.len_mult, 1));
+	memcpy(converted.data(), wav_buffer, wav_length);
+	SDL_FreeWAV(wav_buffer);
+
+	cvt.buf = converted.data();
+	cvt.len = (int)wav_length;
+	cvt.len_cvt = (int)wav_length;
+	if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) {
+		console.AddLog("[error] Could not convert '%s': %s", input_path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	const auto *samples = (const float *)converted.data();
+	const int source_channels = spec.channels;
+	const size_t frames = (size_t)cvt.len_cvt / sizeof(float) / source_channels;
+
+	WavInfo info = WavInfo();
+	info.channels = source_channels;
+	info.rate = spec.freq;
+	info.bits = SDL_AUDIO_BITSIZE(spec.format);
+	SoundFormat format = get_processed_format(info, options);
+
+	// one plane per output channel, downmixing averages all channels
+	std::vector<std::vector<float>> planes(format.channels, std::vector<float>(frames));
+	for (size_t i = 0; i < frames; ++i) {
+		if (format.channels == 1) {
+			float sum = 0;
+			for (int c = 0; c < source_channels; ++c) {
+				sum += samples[i * source_channels + c];
+			}
+			planes[0][i] = sum / (float)source_channels;
+		} else {
+			for (int c = 0; c < format.channels; ++c) {
+				planes[c][i] = samples[i * source_channels + c];
+			}
+		}
+	}
+
+	if (format.rate != spec.freq) {
+		for (auto &plane : planes) {
+			plane = resample(plane, spec.freq, format.rate);
+		}
+	}
+
+	const size_t output_frames = planes[0].size();
+	std::vector<Uint8> output(output_frames * format.channels * (format.bits / 8));
+	if (format.bits == 8) {
+		// triangular dither hides the quantization distortion under a little noise, seeded so
+		// builds are reproducible
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> half_step(-.5f, .5f);
+		for (size_t i = 0; i < output_frames; ++i) {
+			for (int c = 0; c < format.channels; ++c) {
+				float value = planes[c][i] * 127.f + half_step(random) + half_step(random);
+				output[i * format.channels + c] =
+					(Uint8)(std::clamp((int)lroundf(value), -128, 127) + 128);
+			}
+		}
+	} else {
+		auto *output_samples = (Sint16 *)output.data();
+		for (size_t i = 0; i < output_frames; ++i) {
+			for (int c = 0; c < format.channels; ++c) {
+				float value = planes[c][i] * 32767.f;
+				Sint16 sample = (Sint16)std::clamp((int)lroundf(value), -32768, 32767);
+				output_samples[i * format.channels + c] = (Sint16)SDL_SwapLE16((Uint16)sample);
+			}
+		}
+	}
+
+	if (!write_wav(output_path, output.data(), (Sint64)output_frames, format.channels,
+				   format.rate, format.bits)) {
+		console.AddLog("[error] Could not write '%s': %s", output_path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
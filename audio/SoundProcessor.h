@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <SDL2/SDL.h>
+
+#include "WavFile.h"
+
+// What is done to a wave file before it is converted by 'audioconv64'.
+struct SoundProcessOptions {
+	// 0 keeps the source rate, sounds are never resampled to a higher rate
+	int frequency;
+	bool mono;
+	// 8 or 16
+	int bit_depth;
+};
+
+struct SoundFormat {
+	int rate;
+	int channels;
+	int bits;
+};
+
+// format of the samples written to the rom ('audioconv64' stores at most 16 bits)
+SoundFormat get_source_format(const WavInfo &info);
+SoundFormat get_processed_format(const WavInfo &info, const SoundProcessOptions &options);
+bool needs_processing(const WavInfo &info, const SoundProcessOptions &options);
+
+// size of the samples on the rom, in bytes
+Sint64 get_sound_size(const WavInfo &info, const SoundFormat &format);
+
+// writes the processed wave file to 'output_path', ready to be converted
+bool process_sound(const std::string &input_path, const std::string &output_path,
+				   const SoundProcessOptions &options);
@@ -0,0 +1,88 @@
+#include "WavFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+bool read_wav_info(SDL_RWops *file, WavInfo &info) {
+	info = WavInfo();
+
+	char id[4];
+	if (SDL_RWread(file, id, 4, 1) != 1 || memcmp(id, "RIFF", 4) != 0)
+		return false;
+	SDL_ReadLE32(file);
+	if (SDL_RWread(file, id, 4, 1) != 1 || memcmp(id, "WAVE", 4) != 0)
+		return false;
+
+	info.data_size = -1;
+	while (SDL_RWread(file, id, 4, 1) == 1) {
+		Uint32 chunk_size = SDL_ReadLE32(file);
+		Sint64 chunk_start = SDL_RWtell(file);
+
+		if (memcmp(id, "fmt ", 4) == 0) {
+			info.format = SDL_ReadLE16(file);
+			info.channels = SDL_ReadLE16(file);
+			info.rate = (int)SDL_ReadLE32(file);
+			SDL_ReadLE32(file);	 // byte rate
+			info.block_align = SDL_ReadLE16(file);
+			info.bits = SDL_ReadLE16(file);
+
+			// WAVE_FORMAT_EXTENSIBLE keeps the real format on the sub format guid
+			if (info.format == 0xFFFE && chunk_size >= 26) {
+				SDL_ReadLE16(file);	 // extension size
+				SDL_ReadLE16(file);	 // valid bits
+				SDL_ReadLE32(file);	 // channel mask
+				info.format = SDL_ReadLE16(file);
+			}
+		} else if (memcmp(id, "data", 4) == 0) {
+			info.data_offset = chunk_start;
+			// some encoders do not fill the size when streaming, so also clamp it to the file
+			info.data_size = std::min((Sint64)chunk_size, SDL_RWsize(file) - chunk_start);
+			return info.channels > 0 && info.rate > 0 && info.block_align > 0;
+		}
+
+		// chunks are padded to an even size
+		SDL_RWseek(file, chunk_start + chunk_size + (chunk_size & 1), RW_SEEK_SET);
+	}
+
+	return false;
+}
+
+bool read_wav_info(const std::string &path, WavInfo &info) {
+	SDL_RWops *file = SDL_RWFromFile(path.c_str(), "rb");
+	if (!file)
+		return false;
+
+	bool result = read_wav_info(file, info);
+	SDL_RWclose(file);
+
+	return result;
+}
+
+bool write_wav(const std::string &path, const void *data, Sint64 frames, int channels, int rate,
+			   int bits) {
+	SDL_RWops *file = SDL_RWFromFile(path.c_str(), "wb");
+	if (!file)
+		return false;
+
+	const Uint32 block_align = channels * bits / 8;
+	const Uint32 data_size = (Uint32)(frames * block_align);
+
+	SDL_RWwrite(file, "RIFF", 4, 1);
+	SDL_WriteLE32(file, 36 + data_size + (data_size & 1));
+	SDL_RWwrite(file, "WAVEfmt ", 8, 1);
+	SDL_WriteLE32(file, 16);
+	SDL_WriteLE16(file, 1);
+	SDL_WriteLE16(file, (Uint16)channels);
+	SDL_WriteLE32(file, (Uint32)rate);
+	SDL_WriteLE32(file, rate * block_align);
+	SDL_WriteLE16(file, (Uint16)block_align);
+	SDL_WriteLE16(file, (Uint16)bits);
+	SDL_RWwrite(file, "data", 4, 1);
+	SDL_WriteLE32(file, data_size);
+
+	bool result = SDL_RWwrite(file, data, 1, data_size) == data_size;
+	if (data_size & 1)
+		SDL_WriteU8(file, 0);
+
+	return SDL_RWclose(file) == 0 && result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <SDL2/SDL.h>
+
+// Header of a RIFF wave file, as needed to read its samples.
+struct WavInfo {
+	// 1 for PCM, 3 for float (the real format for WAVE_FORMAT_EXTENSIBLE)
+	Uint16 format;
+	int channels;
+	int rate;
+	int bits;
+	int block_align;
+	Sint64 data_offset;
+	Sint64 data_size;
+
+	[[nodiscard]] Sint64 GetFrames() const {
+		return block_align > 0 ? data_size / block_align : 0;
+	}
+};
+
+// reads the header from the start of 'file', leaving it at the start of the samples
+bool read_wav_info(SDL_RWops *file, WavInfo &info);
+bool read_wav_info(const std::string &path, WavInfo &info);
+
+// writes interleaved 8 (unsigned) or 16 bits PCM samples
+bool write_wav(const std::string &path, const void *data, Sint64 frames, int channels, int rate,
+			   int bits);
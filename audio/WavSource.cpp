@@ -0,0 +1,204 @@
+#include "WavSource.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../ConsoleApp.h"
+#include "WavFile.h"
+
+// source frames read from disk at a time
+const int chunk_frames = 2048;
+
+WavSource::WavSource(int output_rate)
+	: output_rate(output_rate),
+	  file(nullptr),
+	  stream(nullptr),
+	  data_offset(0),
+	  total_frames(0),
+	  read_frame(0),
+	  frame_size(0),
+	  channels(0),
+	  rate(0),
+	  expand_24_bits(false),
+	  flushed(false),
+	  seek_position(0),
+	  rendered_frames(0) {
+}
+
+WavSource::~WavSource() {
+	if (stream)
+		SDL_FreeAudioStream(stream);
+	if (file)
+		SDL_RWclose(file);
+}
+
+bool WavSource::OpenWav(const std::string &path) {
+	file = SDL_RWFromFile(path.c_str(), "rb");
+	if (!file) {
+		console.AddLog("[error] Could not open '%s': %s", path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	WavInfo info;
+	if (!read_wav_info(file, info)) {
+		console.AddLog("[error] '%s' is not a wave file or has no audio data.", path.c_str());
+		return false;
+	}
+
+	channels = info.channels;
+	rate = info.rate;
+	data_offset = info.data_offset;
+
+	SDL_AudioFormat audio_format;
+	if (info.format == 1 && info.bits == 8) {
+		audio_format = AUDIO_U8;
+	} else if (info.format == 1 && info.bits == 16) {
+		audio_format = AUDIO_S16LSB;
+	} else if (info.format == 1 && info.bits == 24) {
+		audio_format = AUDIO_S32LSB;
+		expand_24_bits = true;
+	} else if (info.format == 1 && info.bits == 32) {
+		audio_format = AUDIO_S32LSB;
+	} else if (info.format == 3 && info.bits == 32) {
+		audio_format = AUDIO_F32LSB;
+	} else {
+		console.AddLog("[error] Preview is not supported for this wave format (%d, %d bits).",
+					   info.format, info.bits);
+		return false;
+	}
+
+	frame_size = info.block_align;
+	total_frames = info.GetFrames();
+
+	return Setup(path, audio_format);
+}
+
+bool WavSource::OpenWav64(const std::string &path) {
+	file = SDL_RWFromFile(path.c_str(), "rb");
+	if (!file) {
+		console.AddLog("[error] Could not open '%s': %s", path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	char id[4];
+	if (SDL_RWread(file, id, 4, 1) != 1 || memcmp(id, "WV64", 4) != 0) {
+		console.AddLog("[error] '%s' is not a wav64 file.", path.c_str());
+		return false;
+	}
+
+	SDL_ReadU8(file);  // version
+	Uint8 format = SDL_ReadU8(file);
+	channels = SDL_ReadU8(file);
+	int bits = SDL_ReadU8(file);
+	rate = (int)SDL_ReadBE32(file);
+	total_frames = SDL_ReadBE32(file);
+	SDL_ReadBE32(file);	 // loop length
+	data_offset = SDL_ReadBE32(file);
+
+	if (format != 0) {
+		console.AddLog("[error] Preview is not supported for compressed wav64 files.");
+		return false;
+	}
+	if (channels <= 0 || rate <= 0 || (bits != 8 && bits != 16)) {
+		console.AddLog("[error] '%s' has no audio data.", path.c_str());
+		return false;
+	}
+
+	frame_size = channels * bits / 8;
+
+	return Setup(path, bits == 16 ? AUDIO_S16MSB : AUDIO_S8);
+}
+
+bool WavSource::Setup(const std::string &path, SDL_AudioFormat format) {
+	stream = SDL_NewAudioStream(format, (Uint8)channels, rate, AUDIO_S16SYS, 2, output_rate);
+	if (!stream) {
+		console.AddLog("[error] Could not play '%s': %s", path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	// 24 bits samples are expanded to 32 bits in place
+	read_buffer.resize((size_t)chunk_frames * channels * 4);
+
+	Seek(0);
+	return true;
+}
+
+void WavSource::ReadChunk() {
+	Sint64 frames = std::min((Sint64)chunk_frames, total_frames - read_frame);
+
+	size_t frames_read = SDL_RWread(file, read_buffer.data(), frame_size, (size_t)frames);
+	if (frames_read == 0) {
+		// truncated file, finish with what was read
+		read_frame = total_frames;
+		return;
+	}
+	read_frame += (Sint64)frames_read;
+
+	int bytes = (int)frames_read * frame_size;
+	if (expand_24_bits) {
+		// backwards, so nothing is overwritten before being read
+		Uint8 *data = read_buffer.data();
+		for (int i = (int)frames_read * channels - 1; i >= 0; --i) {
+			Uint8 b0 = data[i * 3], b1 = data[i * 3 + 1], b2 = data[i * 3 + 2];
+			data[i * 4] = 0;
+			data[i * 4 + 1] = b0;
+			data[i * 4 + 2] = b1;
+			data[i * 4 + 3] = b2;
+		}
+		bytes = (int)frames_read * channels * 4;
+	}
+
+	SDL_AudioStreamPut(stream, read_buffer.data(), bytes);
+}
+
+int WavSource::Render(Sint16 *buffer, int frames) {
+	if (!stream)
+		return 0;
+
+	int rendered = 0;
+	while (rendered < frames) {
+		int bytes = SDL_AudioStreamGet(stream, buffer + rendered * 2, (frames - rendered) * 4);
+		if (bytes < 0)
+			break;
+		if (bytes > 0) {
+			rendered += bytes / 4;
+			continue;
+		}
+
+		if (read_frame < total_frames) {
+			ReadChunk();
+		} else if (!flushed) {
+			// the converter keeps a few frames to resample, get them out at the end
+			SDL_AudioStreamFlush(stream);
+			flushed = true;
+		} else {
+			break;
+		}
+	}
+
+	rendered_frames += rendered;
+	return rendered;
+}
+
+void WavSource::Seek(double seconds) {
+	if (!stream)
+		return;
+
+	Sint64 frame = std::clamp((Sint64)(seconds * rate), (Sint64)0, total_frames);
+
+	SDL_RWseek(file, data_offset + frame * frame_size, RW_SEEK_SET);
+	SDL_AudioStreamClear(stream);
+
+	read_frame = frame;
+	flushed = false;
+	seek_position = (double)frame / rate;
+	rendered_frames = 0;
+}
+
+double WavSource::GetPosition() const {
+	return std::min(seek_position + (double)rendered_frames / output_rate, GetDuration());
+}
+
+double WavSource::GetDuration() const {
+	return rate > 0 ? (double)total_frames / rate : 0;
+}
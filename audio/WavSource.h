@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "AudioSource.h"
+
+// Streams a wave file from disk, a small chunk at a time, converting it to the output format.
+class WavSource : public AudioSource {
+   public:
+	explicit WavSource(int output_rate);
+	~WavSource() override;
+
+	// RIFF wave file, PCM (8, 16, 24 or 32 bits) or 32 bits float
+	bool OpenWav(const std::string &path);
+	// 'audioconv64' output, only the uncompressed format
+	bool OpenWav64(const std::string &path);
+
+	int Render(Sint16 *buffer, int frames) override;
+	void Seek(double seconds) override;
+
+	[[nodiscard]] double GetPosition() const override;
+	[[nodiscard]] double GetDuration() const override;
+
+	WavSource(WavSource const &) = delete;
+	WavSource &operator=(WavSource const &) = delete;
+
+   private:
+	int output_rate;
+
+	SDL_RWops *file;
+	SDL_AudioStream *stream;
+	std::vector<Uint8> read_buffer;
+
+	Sint64 data_offset;
+	Sint64 total_frames;
+	Sint64 read_frame;
+	int frame_size;
+	int channels;
+	int rate;
+	bool expand_24_bits;
+	bool flushed;
+
+	double seek_position;
+	Sint64 rendered_frames;
+
+	bool Setup(const std::string &path, SDL_AudioFormat format);
+	void ReadChunk();
+};
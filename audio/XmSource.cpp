@@ -0,0 +1,951 @@
+#include "XmSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <set>
+
+#include "../ConsoleApp.h"
+
+// frames mixed at a time
+const int mix_block_frames = 4096;
+// songs that never loop back are cut at this length
+const int max_duration_seconds = 30 * 60;
+
+const double pi = 3.14159265358979323846;
+
+static Uint8 read_u8(const std::vector<Uint8> &data, size_t offset) {
+	return offset < data.size() ? data[offset] : 0;
+}
+
+static Uint16 read_u16(const std::vector<Uint8> &data, size_t offset) {
+	return (Uint16)(read_u8(data, offset) | (read_u8(data, offset + 1) << 8));
+}
+
+static Uint32 read_u32(const std::vector<Uint8> &data, size_t offset) {
+	return (Uint32)read_u16(data, offset) | ((Uint32)read_u16(data, offset + 2) << 16);
+}
+
+XmSource::XmSource(int output_rate)
+	: output_rate(output_rate),
+	  channel_count(0),
+	  song_length(0),
+	  restart_position(0),
+	  linear_frequencies(true),
+	  default_speed(6),
+	  default_bpm(125),
+	  orders(),
+	  speed(6),
+	  bpm(125),
+	  tick(0),
+	  order(0),
+	  row(0),
+	  global_volume(64),
+	  global_volume_slide(0),
+	  pattern_delay(0),
+	  repeating_row(false),
+	  jump_pending(false),
+	  jump_order(0),
+	  jump_row(0),
+	  ended(true),
+	  tick_frames_left(0),
+	  position_frames(0),
+	  duration_frames(0) {
+}
+
+bool XmSource::Open(const std::string &path) {
+	std::ifstream filestream(path, std::ios::binary);
+	if (!filestream.is_open()) {
+		console.AddLog("[error] Could not open '%s'.", path.c_str());
+		return false;
+	}
+	std::vector<Uint8> data((std::istreambuf_iterator<char>(filestream)),
+							std::istreambuf_iterator<char>());
+	filestream.close();
+
+	if (data.size() < 336 || memcmp(data.data(), "Extended Module: ", 17) != 0) {
+		console.AddLog("[error] '%s' is not a XM module.", path.c_str());
+		return false;
+	}
+
+	size_t header_size = read_u32(data, 60);
+	song_length = std::min((int)read_u16(data, 64), 256);
+	restart_position = read_u16(data, 66);
+	channel_count = read_u16(data, 68);
+	int pattern_count = read_u16(data, 70);
+	int instrument_count = read_u16(data, 72);
+	linear_frequencies = (read_u16(data, 74) & 1) != 0;
+	default_speed = read_u16(data, 76);
+	default_bpm = read_u16(data, 78);
+	memcpy(orders, &data[80], 256);
+
+	if (channel_count <= 0 || channel_count > 64 || song_length == 0) {
+		console.AddLog("[error] '%s' is not a valid XM module.", path.c_str());
+		return false;
+	}
+
+	size_t offset = 60 + header_size;
+
+	patterns.resize(pattern_count);
+	for (auto &pattern : patterns) {
+		size_t pattern_header_size = read_u32(data, offset);
+		pattern.rows = std::clamp((int)read_u16(data, offset + 5), 1, 256);
+		size_t packed_size = read_u16(data, offset + 7);
+		offset += pattern_header_size;
+
+		pattern.notes.assign((size_t)pattern.rows * channel_count, Note{});
+
+		// each note only stores the columns that are set
+		size_t end = offset + packed_size;
+		size_t position = offset;
+		for (auto &note : pattern.notes) {
+			if (position >= end)
+				break;
+
+			Uint8 flags = read_u8(data, position++);
+			if (flags & 0x80) {
+				if (flags & 0x01)
+					note.note = read_u8(data, position++);
+				if (flags & 0x02)
+					note.instrument = read_u8(data, position++);
+				if (flags & 0x04)
+					note.volume = read_u8(data, position++);
+				if (flags & 0x08)
+					note.effect = read_u8(data, position++);
+				if (flags & 0x10)
+					note.param = read_u8(data, position++);
+			} else {
+				note.note = flags;
+				note.instrument = read_u8(data, position++);
+				note.volume = read_u8(data, position++);
+				note.effect = read_u8(data, position++);
+				note.param = read_u8(data, position++);
+			}
+		}
+		offset = end;
+	}
+
+	auto read_envelope = [&data](Envelope &envelope, size_t points_offset, size_t count_offset,
+								 size_t info_offset, size_t type_offset) {
+		envelope.count = std::min((int)read_u8(data, count_offset), 12);
+		for (int i = 0; i < 12; ++i) {
+			envelope.points[i][0] = read_u16(data, points_offset + i * 4);
+			envelope.points[i][1] = std::min((int)read_u16(data, points_offset + i * 4 + 2), 64);
+		}
+
+		int last_point = std::max(envelope.count - 1, 0);
+		envelope.sustain = std::min((int)read_u8(data, info_offset), last_point);
+		envelope.loop_start = std::min((int)read_u8(data, info_offset + 1), last_point);
+		envelope.loop_end = std::min((int)read_u8(data, info_offset + 2), last_point);
+
+		Uint8 type = read_u8(data, type_offset);
+		envelope.enabled = (type & 1) && envelope.count > 0;
+		envelope.sustain_enabled = (type & 2) != 0;
+		envelope.loop_enabled = (type & 4) != 0;
+	};
+
+	instruments.resize(instrument_count);
+	for (auto &instrument : instruments) {
+		size_t instrument_size = read_u32(data, offset);
+		int sample_count = read_u16(data, offset + 27);
+
+		memset(instrument.sample_map, 0, sizeof(instrument.sample_map));
+		instrument.volume_envelope = {};
+		instrument.panning_envelope = {};
+		instrument.fadeout = 0;
+
+		if (sample_count == 0) {
+			offset += instrument_size;
+			continue;
+		}
+
+		size_t sample_header_size = read_u32(data, offset + 29);
+		// old trackers may save a shorter header without the envelopes
+		if (instrument_size >= 241) {
+			for (int i = 0; i < 96; ++i) {
+				instrument.sample_map[i] = read_u8(data, offset + 33 + i);
+			}
+			read_envelope(instrument.volume_envelope, offset + 129, offset + 225, offset + 227,
+						  offset + 233);
+			read_envelope(instrument.panning_envelope, offset + 177, offset + 226, offset + 230,
+						  offset + 234);
+			instrument.fadeout = read_u16(data, offset + 239);
+		}
+		offset += instrument_size;
+
+		// all sample headers come first, then the data for each one of them
+		std::vector<size_t> data_sizes;
+		instrument.samples.resize(sample_count);
+		for (auto &sample : instrument.samples) {
+			data_sizes.push_back(read_u32(data, offset));
+			sample.loop_start = (int)read_u32(data, offset + 4);
+			sample.loop_length = (int)read_u32(data, offset + 8);
+			sample.volume = std::min((int)read_u8(data, offset + 12), 64);
+			sample.finetune = (Sint8)read_u8(data, offset + 13);
+			sample.loop_type = read_u8(data, offset + 14);
+			sample.panning = read_u8(data, offset + 15);
+			sample.relative_note = (Sint8)read_u8(data, offset + 16);
+
+			offset += sample_header_size;
+		}
+
+		for (size_t i = 0; i < instrument.samples.size(); ++i) {
+			Sample &sample = instrument.samples[i];
+			bool is_16_bits = (sample.loop_type & 0x10) != 0;
+			size_t size = offset < data.size() ? std::min(data_sizes[i], data.size() - offset) : 0;
+
+			// samples are stored as the difference from the previous value
+			if (is_16_bits) {
+				sample.data.resize(size / 2);
+				Sint16 value = 0;
+				for (size_t s = 0; s < sample.data.size(); ++s) {
+					value = (Sint16)(value + (Sint16)read_u16(data, offset + s * 2));
+					sample.data[s] = (float)value / 32768.f;
+				}
+				sample.loop_start /= 2;
+				sample.loop_length /= 2;
+			} else {
+				sample.data.resize(size);
+				Sint8 value = 0;
+				for (size_t s = 0; s < sample.data.size(); ++s) {
+					value = (Sint8)(value + (Sint8)data[offset + s]);
+					sample.data[s] = (float)value / 128.f;
+				}
+			}
+			offset += data_sizes[i];
+
+			// 1 is forward, 2 (and the undefined 3) is ping-pong
+			sample.loop_type &= 3;
+			if (sample.loop_type == 3)
+				sample.loop_type = 2;
+
+			int length = (int)sample.data.size();
+			if (sample.loop_start >= length) {
+				sample.loop_type = 0;
+			} else {
+				sample.loop_length = std::min(sample.loop_length, length - sample.loop_start);
+			}
+			if (sample.loop_length <= 0)
+				sample.loop_type = 0;
+		}
+	}
+
+	mix_buffer.resize(mix_block_frames * 2);
+
+	// play the song once without mixing to find out where it ends (or loops)
+	Reset();
+	duration_frames = std::numeric_limits<Sint64>::max();
+
+	std::set<int> played_rows;
+	double frames = 0;
+	while (frames < (double)output_rate * max_duration_seconds) {
+		if (tick == 0 && !repeating_row) {
+			bool in_pattern_loop = std::any_of(channels.begin(), channels.end(),
+											   [](const Channel &c) { return c.loop_count > 0; });
+			if (!in_pattern_loop && !played_rows.insert((order << 8) | row).second)
+				break;
+		}
+
+		ProcessTick();
+		if (ended)
+			break;
+
+		frames += output_rate * 2.5 / bpm;
+	}
+	duration_frames = (Sint64)frames;
+
+	Reset();
+	return true;
+}
+
+void XmSource::Reset() {
+	speed = default_speed > 0 ? default_speed : 6;
+	bpm = default_bpm >= 32 ? default_bpm : 125;
+	tick = 0;
+	order = 0;
+	row = 0;
+	global_volume = 64;
+	global_volume_slide = 0;
+	pattern_delay = 0;
+	repeating_row = false;
+	jump_pending = false;
+	ended = false;
+	tick_frames_left = 0;
+	position_frames = 0;
+
+	channels.assign(channel_count, Channel{});
+	for (auto &channel : channels) {
+		channel.panning = 128;
+		channel.fadeout_volume = 65536;
+	}
+}
+
+int XmSource::Render(Sint16 *buffer, int frames) {
+	return (int)Advance(buffer, frames);
+}
+
+void XmSource::Seek(double seconds) {
+	Reset();
+
+	Sint64 target = std::clamp((Sint64)(seconds * output_rate), (Sint64)0, duration_frames);
+	Advance(nullptr, target);
+}
+
+double XmSource::GetPosition() const {
+	return (double)position_frames / output_rate;
+}
+
+double XmSource::GetDuration() const {
+	return (double)duration_frames / output_rate;
+}
+
+// Mixes 'frames' into 'buffer', or only moves forward without mixing when it is null.
+Sint64 XmSource::Advance(Sint16 *buffer, Sint64 frames) {
+	const float gain = 2.f / sqrtf((float)std::max(channel_count, 4));
+
+	Sint64 done = 0;
+	while (done < frames && !ended) {
+		if (position_frames >= duration_frames) {
+			ended = true;
+			break;
+		}
+
+		if (tick_frames_left < 1) {
+			ProcessTick();
+			tick_frames_left += output_rate * 2.5 / bpm;
+			continue;
+		}
+
+		Sint64 count = std::min({frames - done, (Sint64)tick_frames_left,
+								 duration_frames - position_frames});
+
+		if (buffer) {
+			count = std::min(count, (Sint64)mix_block_frames);
+
+			std::fill(mix_buffer.begin(), mix_buffer.begin() + count * 2, 0.f);
+			for (auto &channel : channels) {
+				MixChannel(channel, mix_buffer.data(), (int)count);
+			}
+
+			Sint16 *output = buffer + done * 2;
+			for (Sint64 i = 0; i < count * 2; ++i) {
+				output[i] = (Sint16)std::clamp(mix_buffer[i] * gain * 32767.f, -32768.f, 32767.f);
+			}
+		} else {
+			for (auto &channel : channels) {
+				SkipChannel(channel, count);
+			}
+		}
+
+		tick_frames_left -= (double)count;
+		position_frames += count;
+		done += count;
+	}
+
+	return done;
+}
+
+void XmSource::ProcessTick() {
+	for (auto &channel : channels) {
+		channel.vibrato_offset = 0;
+		channel.tremolo_offset = 0;
+	}
+
+	if (tick == 0 && !repeating_row) {
+		StartRow();
+		if (ended)
+			return;
+	} else {
+		for (auto &channel : channels) {
+			ApplyTickEffects(channel);
+		}
+	}
+
+	for (auto &channel : channels) {
+		UpdateChannel(channel);
+	}
+
+	if (++tick >= speed) {
+		tick = 0;
+		if (pattern_delay > 0) {
+			--pattern_delay;
+			repeating_row = true;
+		} else {
+			repeating_row = false;
+			NextRow();
+		}
+	}
+}
+
+void XmSource::StartRow() {
+	if (order >= song_length) {
+		ended = true;
+		return;
+	}
+
+	static const Note empty_note = {};
+	const Pattern *pattern = orders[order] < patterns.size() ? &patterns[orders[order]] : nullptr;
+
+	for (int i = 0; i < channel_count; ++i) {
+		const Note &note = pattern ? pattern->notes[(size_t)row * channel_count + i] : empty_note;
+		Channel &channel = channels[i];
+
+		channel.current = note;
+
+		bool is_delayed = note.effect == 0xE && (note.param >> 4) == 0xD && (note.param & 0xF);
+		if (!is_delayed)
+			TriggerNote(channel, note);
+
+		ApplyRowEffects(channel, note);
+	}
+}
+
+void XmSource::NextRow() {
+	if (jump_pending) {
+		jump_pending = false;
+		order = jump_order;
+		row = jump_row;
+	} else if (++row >= GetPatternRows(order)) {
+		row = 0;
+		++order;
+
+		if (order >= song_length && restart_position < song_length)
+			order = restart_position;
+	}
+
+	// breaking into a row the next pattern does not have starts it from the top
+	if (order < song_length && row >= GetPatternRows(order))
+		row = 0;
+}
+
+int XmSource::GetPatternRows(int pattern_order) const {
+	if (pattern_order >= song_length || orders[pattern_order] >= patterns.size())
+		return 64;
+
+	return patterns[orders[pattern_order]].rows;
+}
+
+void XmSource::TriggerNote(Channel &channel, const Note &note) {
+	bool is_tone_portamento = note.effect == 0x3 || note.effect == 0x5 || note.volume >= 0xF0;
+
+	if (note.instrument > 0) {
+		channel.instrument = note.instrument <= instruments.size()
+								 ? &instruments[note.instrument - 1]
+								 : nullptr;
+	}
+
+	if (note.note == 97) {
+		KeyOff(channel);
+		return;
+	}
+
+	if (note.note >= 1 && note.note <= 96 && channel.instrument) {
+		size_t sample_index = channel.instrument->sample_map[note.note - 1];
+		if (sample_index >= channel.instrument->samples.size() ||
+			channel.instrument->samples[sample_index].data.empty()) {
+			channel.active = false;
+			return;
+		}
+
+		const Sample *sample = &channel.instrument->samples[sample_index];
+		int period = GetNotePeriod(note.note - 1 + sample->relative_note, sample->finetune);
+
+		if (is_tone_portamento && channel.active) {
+			channel.target_period = period;
+		} else {
+			channel.sample = sample;
+			channel.period = period;
+			channel.target_period = period;
+			channel.position = 0;
+			channel.reverse = false;
+			channel.active = true;
+			channel.vibrato_position = 0;
+			channel.tremolo_position = 0;
+
+			if (note.effect == 0x9) {
+				if (note.param)
+					channel.sample_offset = note.param;
+
+				channel.position = channel.sample_offset * 256.0;
+				if (channel.position >= (double)sample->data.size())
+					channel.active = false;
+			}
+		}
+	}
+
+	if (note.instrument > 0 && channel.sample) {
+		channel.volume = channel.sample->volume;
+		channel.panning = channel.sample->panning;
+		channel.key_on = true;
+		channel.fadeout_volume = 65536;
+		channel.volume_envelope_tick = 0;
+		channel.panning_envelope_tick = 0;
+	}
+}
+
+void XmSource::ApplyRowEffects(Channel &channel, const Note &note) {
+	const int volume = note.volume;
+	if (volume >= 0x10 && volume <= 0x50) {
+		channel.volume = volume - 0x10;
+	} else {
+		const int value = volume & 0xF;
+		switch (volume >> 4) {
+			case 0x8:
+				channel.volume = std::max(channel.volume - value, 0);
+				break;
+			case 0x9:
+				channel.volume = std::min(channel.volume + value, 64);
+				break;
+			case 0xA:
+				if (value)
+					channel.vibrato_speed = value;
+				break;
+			case 0xB:
+				if (value)
+					channel.vibrato_depth = value;
+				break;
+			case 0xC:
+				channel.panning = value << 4;
+				break;
+			case 0xF:
+				if (value)
+					channel.porta_speed = value << 4;
+				break;
+			default:
+				break;
+		}
+	}
+
+	const int param = note.param;
+	const int x = param >> 4;
+	const int y = param & 0xF;
+	switch (note.effect) {
+		case 0x1:
+			if (param)
+				channel.porta_up = param;
+			break;
+		case 0x2:
+			if (param)
+				channel.porta_down = param;
+			break;
+		case 0x3:
+			if (param)
+				channel.porta_speed = param;
+			break;
+		case 0x4:
+			if (x)
+				channel.vibrato_speed = x;
+			if (y)
+				channel.vibrato_depth = y;
+			break;
+		case 0x5:
+		case 0x6:
+		case 0xA:
+			if (param)
+				channel.volume_slide = param;
+			break;
+		case 0x7:
+			if (x)
+				channel.tremolo_speed = x;
+			if (y)
+				channel.tremolo_depth = y;
+			break;
+		case 0x8:
+			channel.panning = param;
+			break;
+		case 0xB:
+			if (!jump_pending)
+				jump_row = 0;
+			jump_order = param;
+			jump_pending = true;
+			break;
+		case 0xC:
+			channel.volume = std::min(param, 64);
+			break;
+		case 0xD:
+			if (!jump_pending)
+				jump_order = order + 1;
+			jump_row = x * 10 + y;
+			jump_pending = true;
+			break;
+		case 0xE:
+			switch (x) {
+				case 0x1:
+					if (y)
+						channel.fine_porta_up = y;
+					channel.period = std::max(channel.period - channel.fine_porta_up * 4, 1);
+					break;
+				case 0x2:
+					if (y)
+						channel.fine_porta_down = y;
+					channel.period += channel.fine_porta_down * 4;
+					break;
+				case 0x6:
+					if (y == 0) {
+						channel.loop_row = row;
+					} else if (channel.loop_count == 0 || --channel.loop_count > 0) {
+						if (channel.loop_count == 0)
+							channel.loop_count = y;
+
+						jump_pending = true;
+						jump_order = order;
+						jump_row = channel.loop_row;
+					}
+					break;
+				case 0xA:
+					if (y)
+						channel.fine_volume_up = y;
+					channel.volume = std::min(channel.volume + channel.fine_volume_up, 64);
+					break;
+				case 0xB:
+					if (y)
+						channel.fine_volume_down = y;
+					channel.volume = std::max(channel.volume - channel.fine_volume_down, 0);
+					break;
+				case 0xC:
+					if (y == 0)
+						channel.volume = 0;
+					break;
+				case 0xE:
+					pattern_delay = y;
+					break;
+				default:
+					break;
+			}
+			break;
+		case 0xF:
+			if (param > 0 && param < 32)
+				speed = param;
+			else if (param >= 32)
+				bpm = param;
+			break;
+		case 0x10:	// G: global volume
+			global_volume = std::min(param, 64);
+			break;
+		case 0x11:	// H: global volume slide
+			if (param)
+				global_volume_slide = param;
+			break;
+		case 0x14:	// K: key off
+			if (param == 0)
+				KeyOff(channel);
+			break;
+		case 0x19:	// P: panning slide
+			if (param)
+				channel.panning_slide = param;
+			break;
+		case 0x21:	// X: extra fine portamento
+			if (x == 1)
+				channel.period = std::max(channel.period - y, 1);
+			else if (x == 2)
+				channel.period += y;
+			break;
+		default:
+			break;
+	}
+}
+
+void XmSource::ApplyTickEffects(Channel &channel) {
+	const Note &note = channel.current;
+
+	const int value = note.volume & 0xF;
+	switch (note.volume >> 4) {
+		case 0x6:
+			channel.volume = std::max(channel.volume - value, 0);
+			break;
+		case 0x7:
+			channel.volume = std::min(channel.volume + value, 64);
+			break;
+		case 0xB:
+			Vibrato(channel);
+			break;
+		case 0xD:
+			channel.panning = std::max(channel.panning - value, 0);
+			break;
+		case 0xE:
+			channel.panning = std::min(channel.panning + value, 255);
+			break;
+		case 0xF:
+			TonePortamento(channel);
+			break;
+		default:
+			break;
+	}
+
+	const int param = note.param;
+	const int x = param >> 4;
+	const int y = param & 0xF;
+	switch (note.effect) {
+		case 0x1:
+			channel.period = std::max(channel.period - channel.porta_up * 4, 1);
+			break;
+		case 0x2:
+			channel.period += channel.porta_down * 4;
+			break;
+		case 0x3:
+			TonePortamento(channel);
+			break;
+		case 0x4:
+			Vibrato(channel);
+			break;
+		case 0x5:
+			TonePortamento(channel);
+			VolumeSlide(channel);
+			break;
+		case 0x6:
+			Vibrato(channel);
+			VolumeSlide(channel);
+			break;
+		case 0x7:
+			Tremolo(channel);
+			break;
+		case 0xA:
+			VolumeSlide(channel);
+			break;
+		case 0xE:
+			if (x == 0x9 && y && tick % y == 0) {
+				channel.position = 0;
+				channel.reverse = false;
+			} else if (x == 0xC && tick == y) {
+				channel.volume = 0;
+			} else if (x == 0xD && tick == y) {
+				TriggerNote(channel, note);
+				if (note.volume >= 0x10 && note.volume <= 0x50)
+					channel.volume = note.volume - 0x10;
+			}
+			break;
+		case 0x11:
+			if (global_volume_slide >> 4)
+				global_volume = std::min(global_volume + (global_volume_slide >> 4), 64);
+			else
+				global_volume = std::max(global_volume - (global_volume_slide & 0xF), 0);
+			break;
+		case 0x14:
+			if (tick == param)
+				KeyOff(channel);
+			break;
+		case 0x19:
+			if (channel.panning_slide >> 4)
+				channel.panning = std::min(channel.panning + (channel.panning_slide >> 4), 255);
+			else
+				channel.panning = std::max(channel.panning - (channel.panning_slide & 0xF), 0);
+			break;
+		default:
+			break;
+	}
+}
+
+void XmSource::UpdateChannel(Channel &channel) {
+	if (!channel.active || !channel.sample)
+		return;
+
+	float volume = (float)std::clamp(channel.volume + channel.tremolo_offset, 0, 64) / 64.f;
+	int panning = channel.panning;
+
+	const Instrument *instrument = channel.instrument;
+	if (instrument && instrument->volume_envelope.enabled) {
+		volume *= (float)GetEnvelopeValue(instrument->volume_envelope,
+										  channel.volume_envelope_tick) /
+				  64.f;
+		AdvanceEnvelope(instrument->volume_envelope, channel.volume_envelope_tick,
+						channel.key_on);
+
+		if (!channel.key_on)
+			channel.fadeout_volume = std::max(channel.fadeout_volume - instrument->fadeout, 0);
+		volume *= (float)channel.fadeout_volume / 65536.f;
+	}
+	if (instrument && instrument->panning_envelope.enabled) {
+		int envelope = GetEnvelopeValue(instrument->panning_envelope,
+										channel.panning_envelope_tick);
+		panning += (envelope - 32) * (128 - abs(panning - 128)) / 32;
+		AdvanceEnvelope(instrument->panning_envelope, channel.panning_envelope_tick,
+						channel.key_on);
+	}
+	volume *= (float)global_volume / 64.f;
+	panning = std::clamp(panning, 0, 255);
+
+	channel.left_volume = volume * sqrtf((float)(255 - panning) / 255.f);
+	channel.right_volume = volume * sqrtf((float)panning / 255.f);
+
+	double frequency = GetFrequency(std::max(channel.period + channel.vibrato_offset, 1));
+	if (channel.current.effect == 0x0 && channel.current.param) {
+		int semitones = 0;
+		if (tick % 3 == 1)
+			semitones = channel.current.param >> 4;
+		else if (tick % 3 == 2)
+			semitones = channel.current.param & 0xF;
+
+		frequency *= pow(2.0, semitones / 12.0);
+	}
+
+	channel.step = frequency / output_rate;
+}
+
+void XmSource::KeyOff(Channel &channel) {
+	channel.key_on = false;
+
+	// without an envelope there is nothing to fade out
+	if (!channel.instrument || !channel.instrument->volume_envelope.enabled)
+		channel.volume = 0;
+}
+
+void XmSource::VolumeSlide(Channel &channel) {
+	if (channel.volume_slide >> 4)
+		channel.volume = std::min(channel.volume + (channel.volume_slide >> 4), 64);
+	else
+		channel.volume = std::max(channel.volume - (channel.volume_slide & 0xF), 0);
+}
+
+void XmSource::TonePortamento(Channel &channel) {
+	if (channel.period < channel.target_period)
+		channel.period = std::min(channel.period + channel.porta_speed * 4, channel.target_period);
+	else if (channel.period > channel.target_period)
+		channel.period = std::max(channel.period - channel.porta_speed * 4, channel.target_period);
+}
+
+void XmSource::Vibrato(Channel &channel) {
+	channel.vibrato_offset = (int)(sin(channel.vibrato_position * pi / 32.0) *
+								   channel.vibrato_depth * 8);
+	channel.vibrato_position = (channel.vibrato_position + channel.vibrato_speed) & 63;
+}
+
+void XmSource::Tremolo(Channel &channel) {
+	channel.tremolo_offset = (int)(sin(channel.tremolo_position * pi / 32.0) *
+								   channel.tremolo_depth * 4);
+	channel.tremolo_position = (channel.tremolo_position + channel.tremolo_speed) & 63;
+}
+
+int XmSource::GetEnvelopeValue(const Envelope &envelope, int envelope_tick) {
+	for (int i = 0; i < envelope.count - 1; ++i) {
+		const int *start = envelope.points[i];
+		const int *end = envelope.points[i + 1];
+		if (envelope_tick >= start[0] && envelope_tick < end[0]) {
+			return start[1] +
+				   (end[1] - start[1]) * (envelope_tick - start[0]) / (end[0] - start[0]);
+		}
+	}
+
+	return envelope.points[std::max(envelope.count - 1, 0)][1];
+}
+
+void XmSource::AdvanceEnvelope(const Envelope &envelope, int &envelope_tick, bool key_on) {
+	if (envelope.sustain_enabled && key_on &&
+		envelope_tick == envelope.points[envelope.sustain][0])
+		return;
+
+	++envelope_tick;
+	if (envelope.loop_enabled && envelope_tick >= envelope.points[envelope.loop_end][0])
+		envelope_tick = envelope.points[envelope.loop_start][0];
+}
+
+void XmSource::MixChannel(Channel &channel, float *buffer, int frames) {
+	if (!channel.active || !channel.sample)
+		return;
+
+	const Sample &sample = *channel.sample;
+	const float *data = sample.data.data();
+	const int length = (int)sample.data.size();
+	const bool is_looping = sample.loop_type != 0;
+	const double loop_start = sample.loop_start;
+	const double loop_end = sample.loop_start + sample.loop_length;
+
+	for (int i = 0; i < frames; ++i) {
+		int index = std::min((int)channel.position, length - 1);
+		int next = index + 1;
+		if (next >= (is_looping ? (int)loop_end : length))
+			next = sample.loop_type == 1 ? sample.loop_start : index;
+
+		float fraction = std::min((float)(channel.position - index), 1.f);
+		float value = data[index] + (data[next] - data[index]) * fraction;
+
+		buffer[i * 2] += value * channel.left_volume;
+		buffer[i * 2 + 1] += value * channel.right_volume;
+
+		if (channel.reverse) {
+			channel.position -= channel.step;
+			if (channel.position < loop_start) {
+				channel.position = std::min(2 * loop_start - channel.position, loop_end);
+				channel.reverse = false;
+			}
+		} else {
+			channel.position += channel.step;
+			if (!is_looping) {
+				if (channel.position >= length) {
+					channel.active = false;
+					return;
+				}
+			} else if (channel.position >= loop_end) {
+				if (sample.loop_type == 1) {
+					channel.position = loop_start +
+									   fmod(channel.position - loop_start, sample.loop_length);
+				} else {
+					channel.position = std::max(2 * loop_end - channel.position, loop_start);
+					channel.reverse = true;
+				}
+			}
+		}
+	}
+}
+
+void XmSource::SkipChannel(Channel &channel, Sint64 frames) {
+	if (!channel.active || !channel.sample)
+		return;
+
+	const Sample &sample = *channel.sample;
+	const double delta = channel.step * (double)frames;
+
+	if (sample.loop_type == 0) {
+		channel.position += delta;
+		if (channel.position >= (double)sample.data.size())
+			channel.active = false;
+		return;
+	}
+
+	const double loop_start = sample.loop_start;
+	const double loop_length = sample.loop_length;
+	const double loop_end = loop_start + loop_length;
+
+	if (sample.loop_type == 1) {
+		channel.position += delta;
+		if (channel.position >= loop_end)
+			channel.position = loop_start + fmod(channel.position - loop_start, loop_length);
+		return;
+	}
+
+	// ping-pong loops are unfolded into a forward pass followed by a backward one
+	double unfolded;
+	if (!channel.reverse) {
+		channel.position += delta;
+		if (channel.position < loop_end)
+			return;
+		unfolded = channel.position - loop_start;
+	} else {
+		unfolded = 2 * loop_length - (channel.position - loop_start) + delta;
+	}
+
+	unfolded = fmod(unfolded, 2 * loop_length);
+	if (unfolded < loop_length) {
+		channel.position = loop_start + unfolded;
+		channel.reverse = false;
+	} else {
+		channel.position = loop_end - (unfolded - loop_length);
+		channel.reverse = true;
+	}
+}
+
+int XmSource::GetNotePeriod(int note, int finetune) const {
+	if (linear_frequencies)
+		return 7680 - note * 64 - finetune / 2;
+
+	return (int)(1712.0 * pow(2.0, (48.0 - note - finetune / 128.0) / 12.0));
+}
+
+double XmSource::GetFrequency(int period) const {
+	if (linear_frequencies)
+		return 8363.0 * pow(2.0, (4608.0 - period) / 768.0);
+
+	return 8363.0 * 1712.0 / period;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "AudioSource.h"
+
+// Renders FastTracker 2 modules (.xm) in process: samples, volume/panning envelopes and the
+// usual effects. Songs that loop back on themselves stop once they reach an already played row.
+class XmSource : public AudioSource {
+   public:
+	explicit XmSource(int output_rate);
+
+	bool Open(const std::string &path);
+
+	int Render(Sint16 *buffer, int frames) override;
+	void Seek(double seconds) override;
+
+	[[nodiscard]] double GetPosition() const override;
+	[[nodiscard]] double GetDuration() const override;
+
+   private:
+	struct Sample {
+		std::vector<float> data;
+		int loop_start;
+		int loop_length;
+		int loop_type;
+		int volume;
+		int finetune;
+		int panning;
+		int relative_note;
+	};
+
+	struct Envelope {
+		int points[12][2];
+		int count;
+		int sustain;
+		int loop_start;
+		int loop_end;
+		bool enabled;
+		bool sustain_enabled;
+		bool loop_enabled;
+	};
+
+	struct Instrument {
+		Uint8 sample_map[96];
+		Envelope volume_envelope;
+		Envelope panning_envelope;
+		int fadeout;
+		std::vector<Sample> samples;
+	};
+
+	struct Note {
+		Uint8 note;
+		Uint8 instrument;
+		Uint8 volume;
+		Uint8 effect;
+		Uint8 param;
+	};
+
+	struct Pattern {
+		int rows;
+		std::vector<Note> notes;
+	};
+
+	struct Channel {
+		const Instrument *instrument;
+		const Sample *sample;
+		Note current;
+
+		bool active;
+		double position;
+		bool reverse;
+		double step;
+
+		int period;
+		int target_period;
+		int volume;
+		int panning;
+		float left_volume;
+		float right_volume;
+
+		bool key_on;
+		int fadeout_volume;
+		int volume_envelope_tick;
+		int panning_envelope_tick;
+
+		// effect memory
+		int porta_up;
+		int porta_down;
+		int porta_speed;
+		int fine_porta_up;
+		int fine_porta_down;
+		int volume_slide;
+		int fine_volume_up;
+		int fine_volume_down;
+		int panning_slide;
+		int sample_offset;
+		int vibrato_speed;
+		int vibrato_depth;
+		int vibrato_position;
+		int tremolo_speed;
+		int tremolo_depth;
+		int tremolo_position;
+		int loop_row;
+		int loop_count;
+
+		// per tick modifiers
+		int vibrato_offset;
+		int tremolo_offset;
+	};
+
+	int output_rate;
+
+	int channel_count;
+	int song_length;
+	int restart_position;
+	bool linear_frequencies;
+	int default_speed;
+	int default_bpm;
+	Uint8 orders[256];
+	std::vector<Pattern> patterns;
+	std::vector<Instrument> instruments;
+
+	std::vector<Channel> channels;
+	std::vector<float> mix_buffer;
+	int speed;
+	int bpm;
+	int tick;
+	int order;
+	int row;
+	int global_volume;
+	int global_volume_slide;
+	int pattern_delay;
+	bool repeating_row;
+	bool jump_pending;
+	int jump_order;
+	int jump_row;
+	bool ended;
+
+	double tick_frames_left;
+	Sint64 position_frames;
+	Sint64 duration_frames;
+
+	void Reset();
+	Sint64 Advance(Sint16 *buffer, Sint64 frames);
+
+	void ProcessTick();
+	void StartRow();
+	void NextRow();
+	void TriggerNote(Channel &channel, const Note &note);
+	void ApplyRowEffects(Channel &channel, const Note &note);
+	void ApplyTickEffects(Channel &channel);
+	void UpdateChannel(Channel &channel);
+	void KeyOff(Channel &channel);
+	[[nodiscard]] int GetPatternRows(int pattern_order) const;
+
+	static void VolumeSlide(Channel &channel);
+	static void TonePortamento(Channel &channel);
+	static void Vibrato(Channel &channel);
+	static void Tremolo(Channel &channel);
+	static int GetEnvelopeValue(const Envelope &envelope, int envelope_tick);
+	static void AdvanceEnvelope(const Envelope &envelope, int &envelope_tick, bool key_on);
+
+	void MixChannel(Channel &channel, float *buffer, int frames);
+	static void SkipChannel(Channel &channel, Sint64 frames);
+
+	[[nodiscard]] int GetNotePeriod(int note, int finetune) const;
+	[[nodiscard]] double GetFrequency(int period) const;
+};
@@ -0,0 +1,675 @@
+#include "YmSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "../ConsoleApp.h"
+
+static Uint16 read_le16(const std::vector<Uint8> &data, size_t offset) {
+	if (offset + 2 > data.size())
+		return 0;
+	return (Uint16)(data[offset] | (data[offset + 1] << 8));
+}
+
+static Uint32 read_le32(const std::vector<Uint8> &data, size_t offset) {
+	return (Uint32)read_le16(data, offset) | ((Uint32)read_le16(data, offset + 2) << 16);
+}
+
+static Uint16 read_be16(const std::vector<Uint8> &data, size_t offset) {
+	if (offset + 2 > data.size())
+		return 0;
+	return (Uint16)((data[offset] << 8) | data[offset + 1]);
+}
+
+static Uint32 read_be32(const std::vector<Uint8> &data, size_t offset) {
+	return ((Uint32)read_be16(data, offset) << 16) | (Uint32)read_be16(data, offset + 2);
+}
+
+// Decoder for the LHA '-lh4-' to '-lh7-' methods (static Huffman blocks over LZ77), which is how
+// most YM files are distributed.
+class LhaDecoder {
+   public:
+	LhaDecoder(const Uint8 *data, size_t size, int dictionary_bits)
+		: data(data),
+		  size(size),
+		  read_position(0),
+		  bit_buffer(0),
+		  sub_bit_buffer(0),
+		  bit_count(0),
+		  block_size(0),
+		  np(dictionary_bits + 1),
+		  pbit(dictionary_bits > 13 ? 5 : 4),
+		  c_len(),
+		  pt_len(),
+		  c_table(),
+		  pt_table(),
+		  left(),
+		  right(),
+		  is_valid(true) {
+		FillBuffer(16);
+	}
+
+	bool Decode(std::vector<Uint8> &output, size_t original_size) {
+		output.clear();
+		output.reserve(original_size);
+
+		while (output.size() < original_size) {
+			int c = DecodeC();
+			if (!is_valid)
+				return false;
+
+			if (c < 256) {
+				output.push_back((Uint8)c);
+				continue;
+			}
+
+			size_t length = c - 256 + threshold;
+			size_t distance = DecodeP() + 1;
+			if (!is_valid)
+				return false;
+
+			for (size_t i = 0; i < length && output.size() < original_size; ++i) {
+				// the dictionary starts filled with spaces
+				output.push_back(distance > output.size() ? ' '
+														   : output[output.size() - distance]);
+			}
+		}
+
+		return is_valid;
+	}
+
+   private:
+	static const int threshold = 3;
+	static const int nc = 255 + 256 + 2 - threshold;
+	static const int cbit = 9;
+	static const int nt = 16 + 3;
+	static const int tbit = 5;
+	static const int npt = nt;
+
+	const Uint8 *data;
+	size_t size;
+	size_t read_position;
+
+	Uint16 bit_buffer;
+	Uint8 sub_bit_buffer;
+	int bit_count;
+	int block_size;
+
+	int np;
+	int pbit;
+
+	Uint8 c_len[nc];
+	Uint8 pt_len[npt];
+	Uint16 c_table[4096];
+	Uint16 pt_table[256];
+	Uint16 left[2 * nc - 1];
+	Uint16 right[2 * nc - 1];
+
+	bool is_valid;
+
+	void FillBuffer(int n) {
+		bit_buffer = (Uint16)(bit_buffer << n);
+		while (n > bit_count) {
+			n -= bit_count;
+			bit_buffer |= (Uint16)(sub_bit_buffer << n);
+			sub_bit_buffer = read_position < size ? data[read_position++] : 0;
+			bit_count = 8;
+		}
+		bit_count -= n;
+		bit_buffer |= (Uint16)(sub_bit_buffer >> bit_count);
+	}
+
+	int GetBits(int n) {
+		if (n == 0)
+			return 0;
+
+		int x = bit_buffer >> (16 - n);
+		FillBuffer(n);
+		return x;
+	}
+
+	void MakeTable(int count, const Uint8 *bit_length, int table_bits, Uint16 *table) {
+		Uint32 counts[17] = {}, weight[17], start[18];
+
+		for (int i = 0; i < count; ++i) {
+			if (bit_length[i] > 16) {
+				is_valid = false;
+				return;
+			}
+			counts[bit_length[i]]++;
+		}
+
+		start[1] = 0;
+		for (int i = 1; i <= 16; ++i) {
+			start[i + 1] = start[i] + (counts[i] << (16 - i));
+		}
+		if (start[17] != 1u << 16) {
+			is_valid = false;
+			return;
+		}
+
+		int jut_bits = 16 - table_bits;
+		for (int i = 1; i <= table_bits; ++i) {
+			start[i] >>= jut_bits;
+			weight[i] = 1u << (table_bits - i);
+		}
+		for (int i = table_bits + 1; i <= 16; ++i) {
+			weight[i] = 1u << (16 - i);
+		}
+
+		Uint32 i = start[table_bits + 1] >> jut_bits;
+		Uint32 table_size = 1u << table_bits;
+		while (i < table_size) {
+			table[i++] = 0;
+		}
+
+		int available = count;
+		Uint32 mask = 1u << (15 - table_bits);
+		for (int ch = 0; ch < count; ++ch) {
+			int length = bit_length[ch];
+			if (length == 0)
+				continue;
+
+			Uint32 next_code = start[length] + weight[length];
+			if (length <= table_bits) {
+				if (next_code > table_size) {
+					is_valid = false;
+					return;
+				}
+				for (i = start[length]; i < next_code; ++i) {
+					table[i] = (Uint16)ch;
+				}
+			} else {
+				Uint32 k = start[length];
+				Uint16 *p = &table[k >> jut_bits];
+				for (int n = length - table_bits; n > 0; --n) {
+					if (*p == 0) {
+						if (available >= 2 * nc - 1) {
+							is_valid = false;
+							return;
+						}
+						right[available] = left[available] = 0;
+						*p = (Uint16)available++;
+					}
+					p = (k & mask) ? &right[*p] : &left[*p];
+					k <<= 1;
+				}
+				*p = (Uint16)ch;
+			}
+			start[length] = next_code;
+		}
+	}
+
+	void ReadPtLen(int count, int bits, int special) {
+		int n = GetBits(bits);
+		if (n == 0) {
+			// a single code for every symbol, which still has to be one of them
+			int c = GetBits(bits);
+			if (c >= count) {
+				is_valid = false;
+				return;
+			}
+			std::fill(pt_len, pt_len + count, 0);
+			std::fill(pt_table, pt_table + 256, (Uint16)c);
+			return;
+		}
+		if (n > count) {
+			is_valid = false;
+			return;
+		}
+
+		int i = 0;
+		while (i < n) {
+			int c = bit_buffer >> 13;
+			if (c == 7) {
+				Uint16 mask = 1u << 12;
+				while (mask & bit_buffer) {
+					mask >>= 1;
+					++c;
+				}
+			}
+			FillBuffer(c < 7 ? 3 : c - 3);
+			pt_len[i++] = (Uint8)c;
+
+			if (i == special) {
+				int zeros = GetBits(2);
+				while (--zeros >= 0 && i < count) {
+					pt_len[i++] = 0;
+				}
+			}
+		}
+		while (i < count) {
+			pt_len[i++] = 0;
+		}
+
+		MakeTable(count, pt_len, 8, pt_table);
+	}
+
+	void ReadCLen() {
+		int n = GetBits(cbit);
+		if (n == 0) {
+			int c = GetBits(cbit);
+			if (c >= nc) {
+				is_valid = false;
+				return;
+			}
+			std::fill(c_len, c_len + nc, 0);
+			std::fill(c_table, c_table + 4096, (Uint16)c);
+			return;
+		}
+		if (n > nc) {
+			is_valid = false;
+			return;
+		}
+
+		int i = 0;
+		while (i < n) {
+			int c = pt_table[bit_buffer >> 8];
+			if (c >= nt) {
+				Uint16 mask = 1u << 7;
+				do {
+					c = (bit_buffer & mask) ? right[c] : left[c];
+					mask >>= 1;
+				} while (c >= nt && mask);
+			}
+			FillBuffer(pt_len[std::min(c, npt - 1)]);
+
+			if (c <= 2) {
+				if (c == 0)
+					c = 1;
+				else if (c == 1)
+					c = GetBits(4) + 3;
+				else
+					c = GetBits(cbit) + 20;
+
+				while (--c >= 0 && i < nc) {
+					c_len[i++] = 0;
+				}
+			} else {
+				c_len[i++] = (Uint8)(c - 2);
+			}
+		}
+		while (i < nc) {
+			c_len[i++] = 0;
+		}
+
+		MakeTable(nc, c_len, 12, c_table);
+	}
+
+	int DecodeC() {
+		if (block_size == 0) {
+			block_size = GetBits(16);
+			ReadPtLen(nt, tbit, 3);
+			ReadCLen();
+			ReadPtLen(np, pbit, -1);
+			if (!is_valid)
+				return 0;
+		}
+		--block_size;
+
+		int j = c_table[bit_buffer >> 4];
+		if (j >= nc) {
+			Uint16 mask = 1u << 3;
+			do {
+				j = (bit_buffer & mask) ? right[j] : left[j];
+				mask >>= 1;
+			} while (j >= nc && mask);
+		}
+		FillBuffer(c_len[std::min(j, nc - 1)]);
+
+		return j;
+	}
+
+	int DecodeP() {
+		int j = pt_table[bit_buffer >> 8];
+		if (j >= np) {
+			Uint16 mask = 1u << 7;
+			do {
+				j = (bit_buffer & mask) ? right[j] : left[j];
+				mask >>= 1;
+			} while (j >= np && mask);
+		}
+		// 'j' is the bit count of the distance, past 'np' it would shift more than 16 bits
+		if (j >= np) {
+			is_valid = false;
+			return 0;
+		}
+		FillBuffer(pt_len[j]);
+
+		if (j != 0)
+			j = (1 << (j - 1)) + GetBits(j - 1);
+
+		return j;
+	}
+};
+
+static bool decompress_lha(const std::vector<Uint8> &archive, std::vector<Uint8> &output) {
+	if (archive.size() < 22)
+		return false;
+
+	int level = archive[20];
+	size_t data_start;
+	size_t compressed_size = read_le32(archive, 7);
+	size_t original_size = read_le32(archive, 11);
+
+	if (level == 2) {
+		data_start = read_le16(archive, 0);
+	} else {
+		data_start = (size_t)archive[0] + 2;
+
+		// level 1 headers are followed by extended headers counted as compressed data
+		if (level == 1) {
+			size_t next = read_le16(archive, data_start - 2);
+			while (next != 0 && data_start < archive.size()) {
+				compressed_size -= std::min(next, compressed_size);
+				data_start += next;
+				next = read_le16(archive, data_start - 2);
+			}
+		}
+	}
+
+	if (data_start >= archive.size())
+		return false;
+
+	compressed_size = std::min(compressed_size, archive.size() - data_start);
+
+	std::string method((const char *)&archive[2], 5);
+	if (method == "-lh0-") {
+		output.assign(archive.begin() + (long)data_start,
+					  archive.begin() + (long)(data_start + compressed_size));
+		return true;
+	}
+
+	int dictionary_bits;
+	if (method == "-lh4-")
+		dictionary_bits = 12;
+	else if (method == "-lh5-")
+		dictionary_bits = 13;
+	else if (method == "-lh6-")
+		dictionary_bits = 15;
+	else if (method == "-lh7-")
+		dictionary_bits = 16;
+	else
+		return false;
+
+	LhaDecoder decoder(&archive[data_start], compressed_size, dictionary_bits);
+	return decoder.Decode(output, original_size);
+}
+
+// 'level' is 0 (silent) to 15 (loudest), about 3 dB apart
+static float get_volume(int level) {
+	return level == 0 ? 0.f : powf(2.f, (float)(level - 15) / 2.f);
+}
+
+YmSource::YmSource(int output_rate)
+	: output_rate(output_rate),
+	  frame_count(0),
+	  frame_rate(50),
+	  clock(2000000),
+	  frame(0),
+	  frame_frames_left(0),
+	  position_frames(0),
+	  registers(),
+	  tone_phases(),
+	  noise_phase(0),
+	  noise_shift(1),
+	  envelope_phase(0),
+	  envelope_shape(0),
+	  envelope_step(0),
+	  envelope_attack(false),
+	  envelope_holding(true),
+	  envelope_hold_value(0),
+	  dc_input(),
+	  dc_output() {
+}
+
+bool YmSource::Open(const std::string &path) {
+	std::ifstream filestream(path, std::ios::binary);
+	if (!filestream.is_open()) {
+		console.AddLog("[error] Could not open '%s'.", path.c_str());
+		return false;
+	}
+	std::vector<Uint8> data((std::istreambuf_iterator<char>(filestream)),
+							std::istreambuf_iterator<char>());
+	filestream.close();
+
+	if (data.size() > 7 && memcmp(&data[2], "-lh", 3) == 0) {
+		std::vector<Uint8> decompressed;
+		if (!decompress_lha(data, decompressed)) {
+			console.AddLog("[error] Could not decompress '%s'.", path.c_str());
+			return false;
+		}
+		return Load(decompressed, path);
+	}
+
+	return Load(data, path);
+}
+
+bool YmSource::Load(const std::vector<Uint8> &data, const std::string &path) {
+	if (data.size() < 4) {
+		console.AddLog("[error] '%s' is not a YM file.", path.c_str());
+		return false;
+	}
+
+	std::string id((const char *)data.data(), 4);
+	size_t register_offset;
+	int registers_per_frame;
+	bool is_interleaved = true;
+
+	if (id == "YM2!" || id == "YM3!" || id == "YM3b") {
+		registers_per_frame = 14;
+		register_offset = 4;
+		size_t register_size = data.size() - 4 - (id == "YM3b" ? 4 : 0);
+		frame_count = (int)(register_size / registers_per_frame);
+	} else if (id == "YM5!" || id == "YM6!") {
+		if (data.size() < 34 || memcmp(&data[4], "LeOnArD!", 8) != 0) {
+			console.AddLog("[error] '%s' is not a valid YM file.", path.c_str());
+			return false;
+		}
+
+		registers_per_frame = 16;
+		frame_count = (int)read_be32(data, 12);
+		is_interleaved = (read_be32(data, 16) & 1) != 0;
+		int digidrum_count = read_be16(data, 20);
+		clock = read_be32(data, 22);
+		frame_rate = read_be16(data, 26);
+
+		register_offset = 34 + read_be16(data, 32);
+		for (int i = 0; i < digidrum_count; ++i) {
+			register_offset += 4 + read_be32(data, register_offset);
+		}
+		// song name, author and comment
+		for (int i = 0; i < 3; ++i) {
+			while (register_offset < data.size() && data[register_offset] != 0) {
+				++register_offset;
+			}
+			++register_offset;
+		}
+	} else {
+		console.AddLog("[error] Preview is not supported for '%s' YM files.", id.c_str());
+		return false;
+	}
+
+	if (frame_count <= 0 || frame_rate <= 0 || clock <= 0 ||
+		register_offset + (size_t)frame_count * registers_per_frame > data.size()) {
+		console.AddLog("[error] '%s' is not a valid YM file.", path.c_str());
+		return false;
+	}
+
+	frames.assign((size_t)frame_count * 16, 0);
+	for (int f = 0; f < frame_count; ++f) {
+		for (int r = 0; r < registers_per_frame; ++r) {
+			size_t index = is_interleaved ? (size_t)r * frame_count + f
+										  : (size_t)f * registers_per_frame + r;
+			frames[(size_t)f * 16 + r] = data[register_offset + index];
+		}
+	}
+
+	Seek(0);
+	return true;
+}
+
+void YmSource::ResetChip() {
+	memset(registers, 0, sizeof(registers));
+	// everything muted until the first frame is written
+	registers[7] = 0x3F;
+
+	std::fill(tone_phases, tone_phases + 3, 0.0);
+	noise_phase = 0;
+	noise_shift = 1;
+	envelope_phase = 0;
+	envelope_shape = 0;
+	envelope_step = 0;
+	envelope_attack = false;
+	envelope_holding = true;
+	envelope_hold_value = 0;
+	std::fill(dc_input, dc_input + 2, 0.f);
+	std::fill(dc_output, dc_output + 2, 0.f);
+}
+
+void YmSource::WriteFrame(int frame_index) {
+	const Uint8 *values = &frames[(size_t)frame_index * 16];
+
+	memcpy(registers, values, 13);
+
+	// writing the shape restarts the envelope, 0xFF means it was not written on this frame
+	if (values[13] != 0xFF) {
+		envelope_shape = values[13] & 0xF;
+		envelope_step = 0;
+		envelope_phase = 0;
+		envelope_attack = (envelope_shape & 4) != 0;
+		envelope_holding = false;
+	}
+}
+
+int YmSource::GetEnvelopeValue() const {
+	if (envelope_holding)
+		return envelope_hold_value;
+
+	return envelope_attack ? envelope_step : 15 - envelope_step;
+}
+
+void YmSource::StepEnvelope() {
+	if (envelope_holding)
+		return;
+
+	if (++envelope_step <= 15)
+		return;
+
+	const bool is_continue = (envelope_shape & 8) != 0;
+	const bool is_attack = (envelope_shape & 4) != 0;
+	const bool is_alternate = (envelope_shape & 2) != 0;
+	const bool is_hold = (envelope_shape & 1) != 0;
+
+	if (!is_continue) {
+		envelope_holding = true;
+		envelope_hold_value = 0;
+	} else if (is_hold) {
+		envelope_holding = true;
+		envelope_hold_value = is_attack != is_alternate ? 15 : 0;
+	} else {
+		envelope_step = 0;
+		if (is_alternate)
+			envelope_attack = !envelope_attack;
+	}
+}
+
+void YmSource::MixFrames(Sint16 *buffer, int count) {
+	double tone_steps[3];
+	for (int i = 0; i < 3; ++i) {
+		int period = std::max(registers[i * 2] | ((registers[i * 2 + 1] & 0xF) << 8), 1);
+		tone_steps[i] = clock / (16.0 * period) / output_rate;
+	}
+	const double noise_step = clock / (16.0 * std::max(registers[6] & 0x1F, 1)) / output_rate;
+	const int envelope_period = std::max(registers[11] | (registers[12] << 8), 1);
+	const double envelope_step_rate = clock / (16.0 * envelope_period) / output_rate;
+
+	for (int i = 0; i < count; ++i) {
+		noise_phase += noise_step;
+		while (noise_phase >= 1.0) {
+			noise_phase -= 1.0;
+			Uint32 bit = (noise_shift ^ (noise_shift >> 3)) & 1;
+			noise_shift = (noise_shift >> 1) | (bit << 16);
+		}
+
+		envelope_phase += envelope_step_rate;
+		while (envelope_phase >= 1.0 && !envelope_holding) {
+			envelope_phase -= 1.0;
+			StepEnvelope();
+		}
+
+		float levels[3];
+		for (int c = 0; c < 3; ++c) {
+			tone_phases[c] += tone_steps[c];
+			tone_phases[c] -= floor(tone_phases[c]);
+
+			// tones above what can be heard are used as a flat level (sample playback)
+			bool tone = tone_steps[c] > 0.5 || tone_phases[c] < 0.5;
+			bool noise = (noise_shift & 1) != 0;
+			bool tone_enabled = !(registers[7] & (1 << c));
+			bool noise_enabled = !(registers[7] & (1 << (c + 3)));
+
+			bool output = (tone || !tone_enabled) && (noise || !noise_enabled);
+			int volume = registers[8 + c] & 0x10 ? GetEnvelopeValue() : registers[8 + c] & 0xF;
+
+			levels[c] = output ? get_volume(volume) : 0.f;
+		}
+
+		// 'ABC' stereo, as on most Atari ST and Amstrad players
+		float mixed[2] = {
+			(levels[0] + levels[1] * .5f) / 1.5f,
+			(levels[2] + levels[1] * .5f) / 1.5f,
+		};
+
+		for (int s = 0; s < 2; ++s) {
+			// the chip output is always positive, remove the offset
+			dc_output[s] = mixed[s] - dc_input[s] + .995f * dc_output[s];
+			dc_input[s] = mixed[s];
+
+			buffer[i * 2 + s] = (Sint16)std::clamp(dc_output[s] * .8f * 32767.f, -32768.f,
+													32767.f);
+		}
+	}
+}
+
+int YmSource::Render(Sint16 *buffer, int frames_to_render) {
+	int done = 0;
+	while (done < frames_to_render) {
+		if (frame_frames_left < 1) {
+			if (frame >= frame_count)
+				break;
+
+			WriteFrame(frame++);
+			frame_frames_left += (double)output_rate / frame_rate;
+			continue;
+		}
+
+		int count = std::min(frames_to_render - done, (int)frame_frames_left);
+		MixFrames(buffer + done * 2, count);
+
+		frame_frames_left -= count;
+		position_frames += count;
+		done += count;
+	}
+
+	return done;
+}
+
+void YmSource::Seek(double seconds) {
+	ResetChip();
+
+	frame = std::clamp((int)(seconds * frame_rate), 0, frame_count);
+	frame_frames_left = 0;
+	position_frames = (Sint64)frame * output_rate / frame_rate;
+}
+
+double YmSource::GetPosition() const {
+	return (double)position_frames / output_rate;
+}
+
+double YmSource::GetDuration() const {
+	return (double)frame_count / frame_rate;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "AudioSource.h"
+
+// Plays YM register dumps (YM2! to YM6!, LHA compressed or not) through a small YM2149
+// emulation. Digidrums and the YM6 special effects are not emulated.
+class YmSource : public AudioSource {
+   public:
+	explicit YmSource(int output_rate);
+
+	bool Open(const std::string &path);
+
+	int Render(Sint16 *buffer, int frames) override;
+	void Seek(double seconds) override;
+
+	[[nodiscard]] double GetPosition() const override;
+	[[nodiscard]] double GetDuration() const override;
+
+   private:
+	int output_rate;
+
+	// 16 registers per frame
+	std::vector<Uint8> frames;
+	int frame_count;
+	int frame_rate;
+	double clock;
+
+	int frame;
+	double frame_frames_left;
+	Sint64 position_frames;
+
+	Uint8 registers[16];
+	double tone_phases[3];
+	double noise_phase;
+	Uint32 noise_shift;
+	double envelope_phase;
+	int envelope_shape;
+	int envelope_step;
+	bool envelope_attack;
+	bool envelope_holding;
+	int envelope_hold_value;
+	float dc_input[2];
+	float dc_output[2];
+
+	bool Load(const std::vector<Uint8> &data, const std::string &path);
+	void ResetChip();
+	void WriteFrame(int frame_index);
+	void MixFrames(Sint16 *buffer, int count);
+	[[nodiscard]] int GetEnvelopeValue() const;
+	void StepEnvelope();
+};
@@ -0,0 +1,240 @@
+#include "generated.h"
+
+#include <filesystem>
+#include <sstream>
+
+const char *asset_cache_gen_c =
+	R"(#include "game.gen.h"
+
+#include <stdlib.h>
+
+#define ASSET_CACHE_BUDGET %d
+#define ASSET_CACHE_POOL %d
+#define ASSET_CACHE_WAV64 %d
+
+typedef struct {
+	void *data;
+	// bytes behind 'data', the block is kept after an eviction to be reused
+	uint32_t capacity;
+	uint32_t last_use;
+	uint16_t refs;
+	bool loaded;
+	bool global;
+} AssetCacheSlot;
+
+static AssetCacheSlot asset_cache_slots[ASSET_COUNT];
+static uint32_t asset_cache_clock;
+static uint32_t asset_cache_used;
+%s
+#ifndef NDEBUG
+AssetCacheStats asset_cache_stats;
+#endif
+
+static uint32_t asset_cache_get_bytes(AssetId id) {
+#if ASSET_CACHE_WAV64
+	// only the handle, the samples are streamed from the rom into the mixer buffers
+	if (asset_cache_wav64_paths[id])
+		return (sizeof(wav64_t) + 7) & ~7;
+#endif
+	return (asset_table[id].size + 7) & ~7;
+}
+
+// drops what the slot holds besides its bytes
+static void asset_cache_unload(AssetCacheSlot *slot) {
+#if ASSET_CACHE_WAV64
+	// wav64 keeps its file open to stream from it
+	if (asset_cache_wav64_paths[slot - asset_cache_slots])
+		wav64_close(slot->data);
+#endif
+	slot->loaded = false;
+}
+
+static void asset_cache_evict(AssetCacheSlot *slot) {
+	asset_cache_unload(slot);
+	asset_cache_used -= slot->capacity;
+#if !ASSET_CACHE_POOL
+	free(slot->data);
+	slot->data = NULL;
+	slot->capacity = 0;
+#endif
+#ifndef NDEBUG
+	asset_cache_stats.evictions++;
+#endif
+}
+
+// evicts the least recently used assets nobody holds until 'bytes' fit in the budget
+static void asset_cache_make_room(uint32_t bytes) {
+	while (asset_cache_used + bytes > ASSET_CACHE_BUDGET) {
+		AssetCacheSlot *oldest = NULL;
+		for (int i = 0; i < ASSET_COUNT; i++) {
+			AssetCacheSlot *slot = &asset_cache_slots[i];
+			if (slot->loaded && slot->refs == 0 &&
+				(!oldest || slot->last_use < oldest->last_use))
+				oldest = slot;
+		}
+		// everything left is in use, go over the budget
+		if (!oldest)
+			return;
+
+		asset_cache_evict(oldest);
+	}
+}
+
+static void asset_cache_alloc(AssetCacheSlot *slot, uint32_t bytes) {
+	if (slot->data && slot->capacity >= bytes)
+		return;
+
+#if ASSET_CACHE_POOL
+	// the pools only free on scene changes, so reuse the smallest evicted block that fits
+	AssetCacheSlot *best = NULL;
+	for (int i = 0; i < ASSET_COUNT; i++) {
+		AssetCacheSlot *other = &asset_cache_slots[i];
+		if (other->loaded || !other->data || other->global != slot->global ||
+			other->capacity < bytes)
+			continue;
+		if (!best || other->capacity < best->capacity)
+			best = other;
+	}
+	if (best) {
+		slot->data = best->data;
+		slot->capacity = best->capacity;
+		best->data = NULL;
+		best->capacity = 0;
+		return;
+	}
+
+	slot->data =
+		mem_zone_alloc(slot->global ? &global_memory_pool : &scene_memory_pool, bytes);
+#else
+	slot->data = malloc(bytes);
+#endif
+	slot->capacity = bytes;
+}
+
+static void *asset_cache_get(AssetId id, bool global) {
+	AssetCacheSlot *slot = &asset_cache_slots[id];
+	slot->last_use = ++asset_cache_clock;
+
+#if ASSET_CACHE_POOL
+	// a scene copy would not survive the next scene, move it to the global pool
+	if (slot->loaded && global && !slot->global) {
+		assertf(slot->refs == 0, "asset %%d is held by the scene, it can't become global", id);
+		asset_cache_evict(slot);
+	}
+#endif
+
+	if (slot->loaded) {
+		slot->refs++;
+#ifndef NDEBUG
+		asset_cache_stats.hits++;
+#endif
+		return slot->data;
+	}
+
+	uint32_t bytes = asset_cache_get_bytes(id);
+	assertf(asset_table[id].size, "asset %%d is missing from the filesystem", id);
+
+	asset_cache_make_room(bytes);
+#if ASSET_CACHE_POOL
+	if (global && !slot->global) {
+		slot->data = NULL;
+		slot->capacity = 0;
+	}
+	if (!slot->data)
+		slot->global = global;
+#endif
+	asset_cache_alloc(slot, bytes);
+	assertf(slot->data, "no memory left to cache asset %%d", id);
+
+#if ASSET_CACHE_WAV64
+	if (asset_cache_wav64_paths[id])
+		wav64_open(slot->data, asset_cache_wav64_paths[id]);
+	else
+#endif
+		asset_read(id, slot->data);
+
+	slot->loaded = true;
+	slot->refs = 1;
+	asset_cache_used += slot->capacity;
+#ifndef NDEBUG
+	asset_cache_stats.misses++;
+	if (asset_cache_used > asset_cache_stats.peak_bytes)
+		asset_cache_stats.peak_bytes = asset_cache_used;
+#endif
+	return slot->data;
+}
+
+void *asset_cache_acquire(AssetId id) {
+	return asset_cache_get(id, false);
+}
+
+void *asset_cache_acquire_global(AssetId id) {
+	return asset_cache_get(id, true);
+}
+
+void asset_cache_release(AssetId id) {
+	assertf(asset_cache_slots[id].refs, "asset %%d released more times than acquired", id);
+	asset_cache_slots[id].refs--;
+}
+
+uint32_t asset_cache_bytes_used(void) {
+	return asset_cache_used;
+}
+
+void asset_cache_scene_reset(void) {
+#if ASSET_CACHE_POOL
+	for (int i = 0; i < ASSET_COUNT; i++) {
+		AssetCacheSlot *slot = &asset_cache_slots[i];
+		if (!slot->data || slot->global)
+			continue;
+
+		assertf(slot->refs == 0, "asset %%d is still held when the scene changes", i);
+		if (slot->loaded) {
+			asset_cache_unload(slot);
+			asset_cache_used -= slot->capacity;
+		}
+		slot->data = NULL;
+		slot->capacity = 0;
+		slot->refs = 0;
+	}
+#endif
+}
+)";
+
+bool is_asset_cache_enabled(const Project &project) {
+	return project.project_settings.modules.asset_cache &&
+		   !get_asset_dfs_paths(project).empty();
+}
+
+void generate_asset_cache_gen_c(const Project &project) {
+	std::string cache_path = project.project_settings.project_directory + "/src/asset_cache.gen.c";
+	if (!is_asset_cache_enabled(project)) {
+		std::filesystem::remove(cache_path);
+		return;
+	}
+
+	const ProjectSettings &settings = project.project_settings;
+	bool use_pool = settings.modules.memory_pool;
+	// 'wav64_open' needs the mixer, other sounds are cached as their raw bytes
+	bool use_wav64 = settings.modules.audio_mixer;
+
+	std::stringstream wav64_paths;
+	if (use_wav64) {
+		wav64_paths << std::endl
+					<< "// sounds are cached opened, ready for 'mixer_ch_play'" << std::endl
+					<< "static const char *const asset_cache_wav64_paths[ASSET_COUNT] = {"
+					<< std::endl;
+		for (auto &path : get_asset_dfs_paths(project)) {
+			if (path.ends_with(".wav64"))
+				wav64_paths << "\t\"" << path << "\"," << std::endl;
+			else
+				wav64_paths << "\tNULL," << std::endl;
+		}
+		wav64_paths << "};" << std::endl;
+	}
+
+	FILE *filestream = fopen(cache_path.c_str(), "w");
+	fprintf(filestream, asset_cache_gen_c, settings.asset_cache_size * 1024, use_pool ? 1 : 0,
+			use_wav64 ? 1 : 0, wav64_paths.str().c_str());
+	fclose(filestream);
+}
@@ -0,0 +1,138 @@
+#include "generated.h"
+
+#include <filesystem>
+#include <sstream>
+
+const char *asset_stream_gen_c =
+	R"(#include "game.gen.h"
+
+#define ASSET_STREAM_QUEUE_SIZE 16
+#define ASSET_STREAM_CHUNK %d
+
+typedef struct {
+	AssetId id;
+	uint8_t *buffer;
+	bool keep;
+	AssetStreamCallback callback;
+	void *user_data;
+} AssetStreamRequest;
+
+static AssetStreamRequest asset_stream_queue[ASSET_STREAM_QUEUE_SIZE];
+static int asset_stream_first;
+static int asset_stream_count;
+// bytes of the first request already read, and the size of the chunk in flight
+static uint32_t asset_stream_done;
+static uint32_t asset_stream_chunk;
+%s
+bool asset_stream_read(AssetId id, void *buffer, bool keep, AssetStreamCallback callback,
+					   void *user_data) {
+	assertf(((uintptr_t)buffer & 7) == 0, "asset %%d: stream buffers must be 8 bytes aligned", id);
+	if (asset_stream_count == ASSET_STREAM_QUEUE_SIZE)
+		return false;
+
+	int last = (asset_stream_first + asset_stream_count) %% ASSET_STREAM_QUEUE_SIZE;
+	asset_stream_queue[last] = (AssetStreamRequest){id, buffer, keep, callback, user_data};
+	asset_stream_count++;
+	return true;
+}
+
+int asset_stream_pending(void) {
+	return asset_stream_count;
+}
+
+void asset_stream_tick(void) {
+	// one chunk is started per frame, the PI moves it while the game runs
+	while (asset_stream_count > 0 && !dma_busy()) {
+		AssetStreamRequest *request = &asset_stream_queue[asset_stream_first];
+		asset_stream_done += asset_stream_chunk;
+		asset_stream_chunk = 0;
+
+		// the PI moves an even number of bytes
+		uint32_t length = (asset_table[request->id].size + 1) & ~1;
+		if (asset_stream_done < length) {
+			uint32_t rom_address = asset_get_rom_address(request->id) + asset_stream_done;
+			assertf((rom_address & 1) == 0, "asset %%d is not 2 bytes aligned on the rom",
+					request->id);
+
+			asset_stream_chunk = length - asset_stream_done;
+			if (asset_stream_chunk > ASSET_STREAM_CHUNK)
+				asset_stream_chunk = ASSET_STREAM_CHUNK;
+
+			data_cache_hit_writeback_invalidate(request->buffer + asset_stream_done,
+												asset_stream_chunk);
+			dma_read_raw_async(request->buffer + asset_stream_done, rom_address,
+							   asset_stream_chunk);
+			break;
+		}
+
+		AssetStreamRequest done = *request;
+		asset_stream_first = (asset_stream_first + 1) %% ASSET_STREAM_QUEUE_SIZE;
+		asset_stream_count--;
+		asset_stream_done = 0;
+
+		if (done.callback)
+			done.callback(done.id, done.buffer, done.user_data);
+	}
+%s}
+
+void asset_stream_scene_change(void) {
+	// the chunk in flight may be writing to the scene pool
+	while (dma_busy())
+		;
+
+	int kept = 0;
+	for (int i = 0; i < asset_stream_count; i++) {
+		AssetStreamRequest *request =
+			&asset_stream_queue[(asset_stream_first + i) %% ASSET_STREAM_QUEUE_SIZE];
+		if (!request->keep) {
+			if (i == 0) {
+				asset_stream_done = 0;
+				asset_stream_chunk = 0;
+			}
+			continue;
+		}
+
+		asset_stream_queue[(asset_stream_first + kept) %% ASSET_STREAM_QUEUE_SIZE] = *request;
+		kept++;
+	}
+	asset_stream_count = kept;
+}
+)";
+
+const char *asset_stream_scene_variables = R"(
+static short asset_stream_next_scene = -1;
+
+void asset_stream_change_scene(short next_scene) {
+	asset_stream_next_scene = next_scene;
+}
+)";
+
+const char *asset_stream_scene_tick = R"(
+	if (asset_stream_next_scene >= 0 && asset_stream_count == 0) {
+		scene_manager_change_scene(scene_manager, asset_stream_next_scene);
+		asset_stream_next_scene = -1;
+	}
+)";
+
+bool is_asset_stream_enabled(const Project &project) {
+	return project.project_settings.modules.asset_stream &&
+		   !get_asset_dfs_paths(project).empty();
+}
+
+void generate_asset_stream_gen_c(const Project &project) {
+	std::string stream_path =
+		project.project_settings.project_directory + "/src/asset_stream.gen.c";
+	if (!is_asset_stream_enabled(project)) {
+		std::filesystem::remove(stream_path);
+		return;
+	}
+
+	const ProjectSettings &settings = project.project_settings;
+	bool use_scene_manager = settings.modules.scene_manager;
+
+	FILE *filestream = fopen(stream_path.c_str(), "w");
+	fprintf(filestream, asset_stream_gen_c, settings.asset_stream_chunk_size * 1024,
+			use_scene_manager ? asset_stream_scene_variables : "",
+			use_scene_manager ? asset_stream_scene_tick : "");
+	fclose(filestream);
+}
@@ -0,0 +1,162 @@
+#include "generated.h"
+
+#include <filesystem>
+#include <map>
+#include <sstream>
+
+#include "../ConsoleApp.h"
+#include "../DfsFile.h"
+#include "../SpriteAtlas.h"
+
+const char *asset_table_gen_c =
+	R"(#include "game.gen.h"
+
+const AssetEntry asset_table[ASSET_COUNT] = {
+%s};
+
+// rom address of the filesystem, found once from the first asset that was built
+static uint32_t asset_rom_base;
+
+uint32_t asset_get_rom_address(AssetId id) {
+	if (!asset_rom_base) {
+		uint32_t rom_addr = dfs_rom_addr("%s");
+		assertf(rom_addr, "'%s' is not on the filesystem, rebuild the assets");
+		asset_rom_base = rom_addr - %u;
+	}
+
+	return asset_rom_base + asset_table[id].dfs_offset;
+}
+
+uint32_t asset_size(AssetId id) {
+	return asset_table[id].size;
+}
+
+void asset_read(AssetId id, void *buffer) {
+	// the PI moves an even number of bytes
+	uint32_t length = (asset_table[id].size + 1) & ~1;
+
+	data_cache_hit_writeback_invalidate(buffer, length);
+	dma_read(buffer, asset_get_rom_address(id), length);
+}
+
+void *asset_load(AssetId id) {
+	void *buffer = malloc((asset_table[id].size + 7) & ~7);
+	asset_read(id, buffer);
+	return buffer;
+}
+)";
+
+std::vector<std::string> get_asset_dfs_paths(const Project &project) {
+	std::vector<std::string> paths;
+	if (!project.project_settings.modules.dfs)
+		return paths;
+
+	for (auto &image : project.images) {
+		if (image->atlas_group.empty())
+			paths.push_back(image->dfs_folder + image->name + ".sprite");
+	}
+	for (auto &atlas : pack_sprite_atlases(project.images)) {
+		paths.push_back("/atlases/" + atlas.name + ".sprite");
+	}
+	for (auto &sound : project.sounds) {
+		paths.push_back(sound->dfs_folder + sound->name + sound->GetLibdragonExtension());
+	}
+	for (auto &file : project.general_files) {
+		if (file->copy_to_filesystem)
+			paths.push_back(file->dfs_folder + file->GetFilename());
+	}
+	for (auto &font : project.fonts) {
+		paths.push_back(font->dfs_folder + font->name + ".font");
+	}
+
+	return paths;
+}
+
+std::string get_asset_id(const std::string &dfs_path) {
+	return "ASSET_" + get_atlas_identifier(dfs_path.substr(1));
+}
+
+AssetTableSnapshot get_asset_table_snapshot(const Project &project) {
+	AssetTableSnapshot snapshot;
+	snapshot.project_directory = project.project_settings.project_directory;
+	snapshot.rom_name = project.project_settings.rom_name;
+	snapshot.dfs_paths = get_asset_dfs_paths(project);
+
+	// preloads go on 'scene_memory_pool', which can't grow
+	const ProjectSettings &settings = project.project_settings;
+	snapshot.scene_mem_alloc_size = settings.scene_mem_alloc_size;
+	if (settings.modules.scene_manager && settings.modules.memory_pool) {
+		for (auto &scene : project.scenes) {
+			if (!scene.preload_assets.empty())
+				snapshot.scene_preloads.emplace_back(scene.name, scene.preload_assets);
+		}
+	}
+
+	return snapshot;
+}
+
+bool generate_asset_table_gen_c(const AssetTableSnapshot &snapshot) {
+	std::string table_path = snapshot.project_directory + "/src/asset_table.gen.c";
+
+	const std::vector<std::string> &paths = snapshot.dfs_paths;
+	if (paths.empty()) {
+		std::filesystem::remove(table_path);
+		return true;
+	}
+
+	std::string dfs_path = snapshot.project_directory + "/build/" + snapshot.rom_name + ".dfs";
+	std::map<std::string, DfsFileEntry> dfs_entries;
+	if (!read_dfs_entries(dfs_path, dfs_entries)) {
+		console.AddLog("[error] Could not read the filesystem at '%s'.", dfs_path.c_str());
+		return false;
+	}
+
+	// the base address is found at runtime from a file that is on the filesystem
+	const std::string *base_path = nullptr;
+	uint32_t base_offset = 0;
+
+	std::stringstream table;
+	for (auto &path : paths) {
+		auto entry = dfs_entries.find(path);
+		if (entry != dfs_entries.end() && !base_path) {
+			base_path = &path;
+			base_offset = entry->second.offset;
+		}
+
+		if (entry == dfs_entries.end()) {
+			console.AddLog("[error] '%s' is not on the filesystem, '%s' will be empty.",
+						   path.c_str(), get_asset_id(path).c_str());
+			table << "\t{0, 0}, // " << path << " (missing)" << std::endl;
+		} else {
+			table << "\t{" << entry->second.offset << ", " << entry->second.size << "}, // "
+				  << path << std::endl;
+		}
+	}
+
+	// nothing was built, the assert on the game tells it
+	if (!base_path)
+		base_path = &paths[0];
+
+	FILE *filestream = fopen(table_path.c_str(), "w");
+	fprintf(filestream, asset_table_gen_c, table.str().c_str(), base_path->c_str(),
+			base_path->c_str(), (unsigned)base_offset);
+	fclose(filestream);
+
+	uintmax_t pool_bytes = (uintmax_t)snapshot.scene_mem_alloc_size * 1024;
+	for (auto &[scene_name, preload_paths] : snapshot.scene_preloads) {
+		uintmax_t preload_bytes = 0;
+		for (auto &path : preload_paths) {
+			auto entry = dfs_entries.find(path);
+			if (entry != dfs_entries.end())
+				preload_bytes += (entry->second.size + 7) & ~7;
+		}
+		if (preload_bytes > pool_bytes) {
+			console.AddLog("# Scene '%s' preloads %.1f KB, more than the %d KB of the scene memory "
+						   "pool.",
+						   scene_name.c_str(), (float)preload_bytes / 1024.f,
+						   snapshot.scene_mem_alloc_size);
+		}
+	}
+
+	return true;
+}
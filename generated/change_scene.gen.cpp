@@ -8,7 +8,7 @@ const char *change_scene_gen_c = R"(#include "change_scene.s.h"
 %s
 
 void change_scene(short curr_scene, short next_scene) {
-	switch (next_scene) {
+%s	switch (next_scene) {
 %s
 		default:
 			abort();
@@ -31,7 +31,18 @@ void generate_change_scene_gen_c(std::string &filepath, const Project &project)
 		content << "\t\t} break;" << std::endl;
 	}
 
+	std::string scene_reset;
+	// cached assets on the scene pool are gone once the scene manager resets it
+	if (is_asset_cache_enabled(project) && project.project_settings.modules.memory_pool)
+		scene_reset += "\tasset_cache_scene_reset();\n";
+	// and so are the buffers of the reads still streaming
+	if (is_asset_stream_enabled(project))
+		scene_reset += "\tasset_stream_scene_change();\n";
+	if (!scene_reset.empty())
+		scene_reset += "\n";
+
 	FILE *filestream = fopen(filepath.c_str(), "w");
-	fprintf(filestream, change_scene_gen_c, header_content.str().c_str(), content.str().c_str());
+	fprintf(filestream, change_scene_gen_c, header_content.str().c_str(), scene_reset.c_str(),
+			content.str().c_str());
 	fclose(filestream);
 }
\ No newline at end of file
@@ -1,12 +1,33 @@
 #include "generated.h"
 
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
 #include <sstream>
 
+#include "../SpriteAtlas.h"
+
 const char *game_gen_h =
-	R"(#include <libdragon.h>
+	R"(#pragma once
+
+#include <libdragon.h>
 %s
 %s)";
 
+const char *atlas_gen_c =
+	R"(#include "game.gen.h"
+
+const char *const atlas_paths[ATLAS_COUNT] = {
+%s};
+
+const AtlasSprite atlas_sprites[ATLAS_SPRITE_COUNT] = {
+%s};
+)";
+
+const char *sprite_trim_gen_c =
+	R"(#include "game.gen.h"
+%s)";
+
 void generate_game_gen_h(const Project &project) {
 	std::stringstream includes;
 	std::stringstream variables;
@@ -16,6 +37,26 @@ void generate_game_gen_h(const Project &project) {
 
 		variables << "extern MemZone global_memory_pool;" << std::endl
 				  << "extern MemZone scene_memory_pool;" << std::endl;
+
+		if (project.project_settings.frame_mem_alloc_size > 0) {
+			variables << std::endl
+					  << "// reset at the start of every frame, for temporary allocations"
+					  << std::endl
+					  << "extern MemZone frame_memory_pool;" << std::endl
+					  << "#ifndef NDEBUG" << std::endl
+					  << "extern size_t frame_memory_used;" << std::endl
+					  << "// most bytes a single frame took with 'frame_alloc'" << std::endl
+					  << "extern size_t frame_memory_peak;" << std::endl
+					  << "#endif" << std::endl
+					  << std::endl
+					  << "static inline void *frame_alloc(size_t size) {" << std::endl
+					  << "#ifndef NDEBUG" << std::endl
+					  << "\tframe_memory_used += size;" << std::endl
+					  << "#endif" << std::endl
+					  << "\treturn mem_zone_alloc(&frame_memory_pool, size);" << std::endl
+					  << "}" << std::endl
+					  << std::endl;
+		}
 	}
 	if (project.project_settings.modules.scene_manager) {
 		includes << "#include <scene_manager.h>" << std::endl;
@@ -30,6 +71,254 @@ void generate_game_gen_h(const Project &project) {
 	if (project.project_settings.modules.rtc) {
 		variables << "extern bool rtc_initialized;" << std::endl;
 	}
+	if (project.project_settings.modules.timer && project.project_settings.timestep.fixed) {
+		variables << std::endl
+				  << "// 'tick' runs at this rate, use 'FIXED_STEP_DT' as the time of a tick"
+				  << std::endl
+				  << "#define FIXED_STEP_HZ " << project.project_settings.timestep.logic_hz
+				  << std::endl
+				  << "#define FIXED_STEP_DT (1.0f / FIXED_STEP_HZ)" << std::endl
+				  << "#define FIXED_STEP_TICKS (TICKS_PER_SECOND / FIXED_STEP_HZ)" << std::endl
+				  << "// how far 'display' is between the last tick and the next one (0 to 1),"
+				  << std::endl
+				  << "// to interpolate movement between ticks" << std::endl
+				  << "extern float fixed_step_alpha;" << std::endl;
+	}
+	if (is_profiler_enabled(project.project_settings)) {
+		variables << std::endl
+				  << "// where the frame time goes, averaged and sent to the editor once a second"
+				  << std::endl
+				  << "typedef enum {" << std::endl
+				  << "\tPROFILE_TICK," << std::endl
+				  << "\tPROFILE_DISPLAY," << std::endl
+				  << "\tPROFILE_GLOBAL_TICK," << std::endl
+				  << "\tPROFILE_GLOBAL_DISPLAY," << std::endl
+				  << "\tPROFILE_SCENE_TICK," << std::endl
+				  << "\tPROFILE_SCENE_DISPLAY," << std::endl
+				  << "\tPROFILE_COUNT" << std::endl
+				  << "} ProfileSlot;" << std::endl
+				  << std::endl
+				  << "// id of the scene being profiled, -1 before the first one" << std::endl
+				  << "extern short profile_scene;" << std::endl
+				  << "// adds the time since 'start' (from 'TICKS_READ') to 'slot'" << std::endl
+				  << "void profile_add(ProfileSlot slot, uint32_t start);" << std::endl
+				  << "void profile_frame_end(void);" << std::endl;
+	}
+
+	std::string atlas_c_path = project.project_settings.project_directory + "/src/atlas.gen.c";
+	std::vector<SpriteAtlas> atlases = pack_sprite_atlases(project.images);
+	if (atlases.empty()) {
+		std::filesystem::remove(atlas_c_path);
+	} else {
+		std::stringstream atlas_ids;
+		std::stringstream sprite_ids;
+		std::stringstream atlas_paths;
+		std::stringstream atlas_sprites;
+		for (size_t i = 0; i < atlases.size(); ++i) {
+			std::string atlas_id = "ATLAS_" + get_atlas_identifier(atlases[i].name);
+			atlas_ids << "\t" << atlas_id << "," << std::endl;
+			atlas_paths << "\t\"/atlases/" << atlases[i].name << ".sprite\"," << std::endl;
+
+			for (auto &sprite : atlases[i].sprites) {
+				const LibdragonImage *image = sprite.image;
+				sprite_ids << "\tSPRITE_" << get_atlas_identifier(image->name) << "," << std::endl;
+				atlas_sprites << "\t{" << atlas_id << ", " << sprite.x << ", " << sprite.y << ", "
+							  << image->width << ", " << image->height << ", " << image->h_slices
+							  << ", " << image->v_slices << "}," << std::endl;
+			}
+		}
+
+		variables << std::endl
+				  << "// sub-rect of an atlas sheet, see 'atlas_paths'" << std::endl
+				  << "typedef struct {" << std::endl
+				  << "\tuint8_t atlas;" << std::endl
+				  << "\tuint16_t x, y;" << std::endl
+				  << "\tuint16_t width, height;" << std::endl
+				  << "\tuint8_t h_slices, v_slices;" << std::endl
+				  << "} AtlasSprite;" << std::endl
+				  << std::endl
+				  << "typedef enum {" << std::endl
+				  << atlas_ids.str() << "\tATLAS_COUNT," << std::endl
+				  << "} AtlasId;" << std::endl
+				  << std::endl
+				  << "typedef enum {" << std::endl
+				  << sprite_ids.str() << "\tATLAS_SPRITE_COUNT," << std::endl
+				  << "} AtlasSpriteId;" << std::endl
+				  << std::endl
+				  << "extern const char *const atlas_paths[ATLAS_COUNT];" << std::endl
+				  << "extern const AtlasSprite atlas_sprites[ATLAS_SPRITE_COUNT];" << std::endl;
+
+		FILE *atlas_filestream = fopen(atlas_c_path.c_str(), "w");
+		fprintf(atlas_filestream, atlas_gen_c, atlas_paths.str().c_str(),
+				atlas_sprites.str().c_str());
+		fclose(atlas_filestream);
+	}
+
+	std::vector<std::string> asset_paths = get_asset_dfs_paths(project);
+	if (!asset_paths.empty()) {
+		variables << std::endl << "typedef enum {" << std::endl;
+		for (auto &path : asset_paths) {
+			variables << "\t" << get_asset_id(path) << ", // " << path << std::endl;
+		}
+		variables << "\tASSET_COUNT," << std::endl
+				  << "} AssetId;" << std::endl
+				  << std::endl
+				  << "// where each asset is on the filesystem, see 'asset_table.gen.c'"
+				  << std::endl
+				  << "typedef struct {" << std::endl
+				  << "\tuint32_t dfs_offset;" << std::endl
+				  << "\tuint32_t size;" << std::endl
+				  << "} AssetEntry;" << std::endl
+				  << std::endl
+				  << "extern const AssetEntry asset_table[ASSET_COUNT];" << std::endl
+				  << std::endl
+				  << "uint32_t asset_size(AssetId id);" << std::endl
+				  << "uint32_t asset_get_rom_address(AssetId id);" << std::endl
+				  << "// DMAs the whole asset into 'buffer' (8 bytes aligned, with room for"
+				  << std::endl
+				  << "// 'asset_size' rounded up to even)" << std::endl
+				  << "void asset_read(AssetId id, void *buffer);" << std::endl
+				  << "// same as 'asset_read' into a new buffer, release it with 'free'"
+				  << std::endl
+				  << "void *asset_load(AssetId id);" << std::endl;
+	}
+	if (!asset_paths.empty() && project.project_settings.modules.scene_manager) {
+		variables << std::endl
+				  << "// assets preloaded by the current scene, NULL for the others" << std::endl
+				  << "extern void *scene_assets[ASSET_COUNT];" << std::endl
+				  << std::endl
+				  << "void scene_preload(AssetId *ids, int count);" << std::endl
+				  << "void scene_preload_release(const AssetId *ids, int count);" << std::endl;
+	}
+	if (is_sprite_batch_enabled(project.project_settings)) {
+		variables << std::endl
+				  << "// Queues 'frame' of 'sprite' to be drawn with the RDP right before"
+				  << std::endl
+				  << "// 'display_show'. Draws are sorted by 'layer' (back to front) and then"
+				  << std::endl
+				  << "// by texture, so each frame is loaded on TMEM once. Whole frames are"
+				  << std::endl
+				  << "// loaded, so they must fit in TMEM (4 KB, not an atlas sheet)." << std::endl
+				  << "void sprite_batch_draw(sprite_t *sprite, int frame, int x, int y, "
+				  << "int layer);" << std::endl
+				  << "void sprite_batch_flush(display_context_t disp);" << std::endl
+				  << "#ifndef NDEBUG" << std::endl
+				  << "// texture loads of the last flush" << std::endl
+				  << "extern int sprite_batch_texture_loads;" << std::endl
+				  << "#endif" << std::endl;
+	}
+	if (is_asset_stream_enabled(project)) {
+		variables << std::endl
+				  << "// runs from 'tick' once the whole asset is on 'buffer'" << std::endl
+				  << "typedef void (*AssetStreamCallback)(AssetId id, void *buffer, "
+				  << "void *user_data);" << std::endl
+				  << std::endl
+				  << "// Queues a read of the asset into 'buffer' (same as 'asset_read'), moved"
+				  << std::endl
+				  << "// a chunk per frame so nothing stalls. False when the queue is full."
+				  << std::endl
+				  << "// Queued reads are dropped on scene changes, unless 'keep' is set for"
+				  << std::endl
+				  << "// buffers that outlive the scene." << std::endl
+				  << "bool asset_stream_read(AssetId id, void *buffer, bool keep, "
+				  << "AssetStreamCallback callback," << std::endl
+				  << "\t\t\t\t\t   void *user_data);" << std::endl
+				  << "int asset_stream_pending(void);" << std::endl
+				  << "void asset_stream_tick(void);" << std::endl
+				  << "void asset_stream_scene_change(void);" << std::endl;
+		if (project.project_settings.modules.scene_manager) {
+			variables << "// changes the scene once every queued read is done, so a loading "
+					  << "scene keeps drawing" << std::endl
+					  << "void asset_stream_change_scene(short next_scene);" << std::endl;
+		}
+	}
+	if (is_asset_cache_enabled(project)) {
+		variables << std::endl
+				  << "// shared copies of the assets, loaded once and kept until the budget needs"
+				  << std::endl
+				  << "// room. Every 'asset_cache_acquire' needs its 'asset_cache_release'."
+				  << std::endl;
+		if (project.project_settings.modules.audio_mixer) {
+			variables << "// wav64 sounds are opened handles that stream from the rom, only the"
+					  << std::endl
+					  << "// handle counts on the budget." << std::endl;
+		}
+		if (project.project_settings.modules.memory_pool) {
+			variables << "// Assets live on 'scene_memory_pool' and are dropped on scene changes,"
+					  << std::endl
+					  << "// unless acquired with 'asset_cache_acquire_global'." << std::endl;
+		}
+		variables << "void *asset_cache_acquire(AssetId id);" << std::endl
+				  << "void *asset_cache_acquire_global(AssetId id);" << std::endl
+				  << "void asset_cache_release(AssetId id);" << std::endl
+				  << "uint32_t asset_cache_bytes_used(void);" << std::endl
+				  << "void asset_cache_scene_reset(void);" << std::endl
+				  << std::endl
+				  << "static inline sprite_t *asset_cache_sprite(AssetId id) {" << std::endl
+				  << "\treturn (sprite_t *)asset_cache_acquire(id);" << std::endl
+				  << "}" << std::endl;
+		if (project.project_settings.modules.audio_mixer) {
+			variables << "static inline wav64_t *asset_cache_wav64(AssetId id) {" << std::endl
+					  << "\treturn (wav64_t *)asset_cache_acquire(id);" << std::endl
+					  << "}" << std::endl;
+		}
+		variables << std::endl
+				  << "#ifndef NDEBUG" << std::endl
+				  << "typedef struct {" << std::endl
+				  << "\tuint32_t hits;" << std::endl
+				  << "\tuint32_t misses;" << std::endl
+				  << "\tuint32_t evictions;" << std::endl
+				  << "\tuint32_t peak_bytes;" << std::endl
+				  << "} AssetCacheStats;" << std::endl
+				  << std::endl
+				  << "extern AssetCacheStats asset_cache_stats;" << std::endl
+				  << "#endif" << std::endl;
+	}
+
+	std::string trim_c_path =
+		project.project_settings.project_directory + "/src/sprite_trim.gen.c";
+	std::stringstream trim_externs;
+	std::stringstream trim_tables;
+	for (auto &image : project.images) {
+		// atlas sprites are packed whole
+		if (!image->trim || !image->atlas_group.empty())
+			continue;
+
+		std::string identifier = get_atlas_identifier(image->name);
+		std::transform(identifier.begin(), identifier.end(), identifier.begin(),
+					   [](unsigned char c) { return (char)std::tolower(c); });
+
+		SpriteTrim trim = image->LoadTrim(project.project_settings.project_directory);
+		std::string declaration = "const SpriteFrameTrim sprite_" + identifier + "_trim[" +
+								  std::to_string(trim.frames.size()) + "]";
+		trim_externs << "extern " << declaration << ";" << std::endl;
+
+		trim_tables << std::endl << declaration << " = {" << std::endl;
+		for (auto &frame : trim.frames) {
+			trim_tables << "\t{" << frame.x << ", " << frame.y << ", " << frame.width << ", "
+						<< frame.height << "}," << std::endl;
+		}
+		trim_tables << "};" << std::endl;
+	}
+	if (trim_externs.str().empty()) {
+		std::filesystem::remove(trim_c_path);
+	} else {
+		variables << std::endl
+				  << "// opaque part of each frame of a trimmed sprite. Frames are stored cropped,"
+				  << std::endl
+				  << "// so draw frame 'i' at (x, y) from where the untrimmed frame would be."
+				  << std::endl
+				  << "typedef struct {" << std::endl
+				  << "\tuint16_t x, y;" << std::endl
+				  << "\tuint16_t width, height;" << std::endl
+				  << "} SpriteFrameTrim;" << std::endl
+				  << std::endl
+				  << trim_externs.str();
+
+		FILE *trim_filestream = fopen(trim_c_path.c_str(), "w");
+		fprintf(trim_filestream, sprite_trim_gen_c, trim_tables.str().c_str());
+		fclose(trim_filestream);
+	}
 
 	FILE *filestream = fopen(
 		(project.project_settings.project_directory + "/src/game.gen.h").c_str(), "w");
@@ -2,6 +2,8 @@
 
 #include <cstdio>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "../settings/Project.h"
 #include "../settings/ProjectSettings.h"
@@ -10,7 +12,47 @@ extern const char *script_blank_gen_h;
 extern const char *script_blank_gen_c;
 
 void generate_makefile_gen(const Project &project);
-void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings);
+void generate_setup_gen_c(std::string &setup_path, const Project &project);
 void generate_change_scene_gen_c(std::string &filepath, const Project &project);
 void generate_scene_gen_files(const Project &project);
-void generate_game_gen_h(const Project &project);
\ No newline at end of file
+void generate_game_gen_h(const Project &project);
+
+// every file on the filesystem that gets an 'AssetId', in the order of the enum
+std::vector<std::string> get_asset_dfs_paths(const Project &project);
+std::string get_asset_id(const std::string &dfs_path);
+
+// What the asset table is built from, copied on the main thread when the build is queued. The
+// table is written from the command thread after 'mkdfs', while the project can still be edited.
+struct AssetTableSnapshot {
+	std::string project_directory;
+	std::string rom_name;
+	// same order as the 'AssetId' enum written to 'game.gen.h' by the same build
+	std::vector<std::string> dfs_paths;
+
+	// scene name and preloaded paths, checked against the scene memory pool when it is used
+	std::vector<std::pair<std::string, std::vector<std::string>>> scene_preloads;
+	int scene_mem_alloc_size;
+};
+AssetTableSnapshot get_asset_table_snapshot(const Project &project);
+// needs the '.dfs' already built, to know where each asset is
+bool generate_asset_table_gen_c(const AssetTableSnapshot &snapshot);
+
+// the 'asset_cache' module, only when there are assets to cache
+bool is_asset_cache_enabled(const Project &project);
+void generate_asset_cache_gen_c(const Project &project);
+// the 'asset_stream' module, same as the cache
+bool is_asset_stream_enabled(const Project &project);
+void generate_asset_stream_gen_c(const Project &project);
+// the 'sprite_batch' module, needs the display, the rdp and a 16 bit framebuffer
+bool is_sprite_batch_enabled(const ProjectSettings &settings);
+void generate_sprite_batch_gen_c(const Project &project);
+// the 'profiler' module, reports through the debug output so it needs the isviewer or usb
+bool is_profiler_enabled(const ProjectSettings &settings);
+// 'call' wrapped with the timing of 'slot', or just the call when not profiling
+std::string get_profiled_call(const std::string &call, const std::string &slot,
+							  const ProjectSettings &settings);
+void generate_profiler_gen_c(const Project &project);
+
+// the pools of every scene, merged by name (with the largest capacity)
+std::vector<ScenePool> get_object_pools(const Project &project);
+void generate_object_pool_gen_files(const Project &project, const std::vector<ScenePool> &pools);
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "generated.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <sstream>
+
+#include "../ConsoleApp.h"
+
+const char *object_pool_gen_h = R"(#pragma once
+
+#include "../game.gen.h"
+%s
+// Fixed number of items of 'item_size', allocated and freed in O(1) through a stack of the
+// free slots. Declared on the scene settings, created and released with the scene.
+typedef struct {
+	uint8_t *items;
+	uint16_t *free_slots;
+	uint32_t item_size;
+	uint16_t capacity;
+	uint16_t free_count;
+#ifndef NDEBUG
+	bool *in_use;
+	// most items used at once
+	uint16_t peak;
+#endif
+} ObjectPool;
+
+void object_pool_init(ObjectPool *pool, uint32_t item_size, uint16_t capacity);
+void object_pool_release(ObjectPool *pool);
+// NULL once every item is in use
+void *object_pool_alloc(ObjectPool *pool);
+void object_pool_free(ObjectPool *pool, void *item);
+
+static inline uint16_t object_pool_used(const ObjectPool *pool) {
+	return pool->capacity - pool->free_count;
+}
+%s)";
+
+const char *object_pool_gen_c = R"(#include "pools.gen.h"
+
+#include <string.h>
+%s
+static void *object_pool_allocate(size_t size) {
+%s}
+
+void object_pool_init(ObjectPool *pool, uint32_t item_size, uint16_t capacity) {
+	// 8 bytes apart, so any struct stays aligned
+	pool->item_size = (item_size + 7) & ~7;
+	pool->capacity = capacity;
+	pool->items = object_pool_allocate(pool->item_size * capacity);
+	pool->free_slots = object_pool_allocate(sizeof(uint16_t) * capacity);
+	assertf(pool->items && pool->free_slots, "no memory left for a pool of %%d items", capacity);
+
+	// the first slot is handed out first
+	for (int i = 0; i < capacity; i++)
+		pool->free_slots[i] = capacity - 1 - i;
+	pool->free_count = capacity;
+
+#ifndef NDEBUG
+	pool->in_use = object_pool_allocate(sizeof(bool) * capacity);
+	memset(pool->in_use, 0, sizeof(bool) * capacity);
+	pool->peak = 0;
+#endif
+}
+
+void object_pool_release(ObjectPool *pool) {
+%s	memset(pool, 0, sizeof(ObjectPool));
+}
+
+void *object_pool_alloc(ObjectPool *pool) {
+	assertf(pool->free_count, "pool of %%d items overflowed", pool->capacity);
+	if (!pool->free_count)
+		return NULL;
+
+	uint16_t slot = pool->free_slots[--pool->free_count];
+#ifndef NDEBUG
+	pool->in_use[slot] = true;
+	if (object_pool_used(pool) > pool->peak)
+		pool->peak = object_pool_used(pool);
+#endif
+	return pool->items + slot * pool->item_size;
+}
+
+void object_pool_free(ObjectPool *pool, void *item) {
+	uint16_t slot = ((uint8_t *)item - pool->items) / pool->item_size;
+#ifndef NDEBUG
+	assertf((uint8_t *)item >= pool->items && slot < pool->capacity && pool->in_use[slot],
+			"item not from this pool or already freed");
+	pool->in_use[slot] = false;
+#endif
+	pool->free_slots[pool->free_count++] = slot;
+}
+)";
+
+static bool is_c_identifier(const std::string &name) {
+	if (name.empty() || std::isdigit((unsigned char)name[0]))
+		return false;
+
+	for (char c : name) {
+		if (!std::isalnum((unsigned char)c) && c != '_')
+			return false;
+	}
+	return true;
+}
+
+std::vector<ScenePool> get_object_pools(const Project &project) {
+	std::vector<ScenePool> pools;
+	for (auto &scene : project.scenes) {
+		for (auto &scene_pool : scene.pools) {
+			if (!is_c_identifier(scene_pool.name) || scene_pool.type.empty()) {
+				console.AddLog("[error] Pool '%s' on scene '%s' needs a C name and a type.",
+							   scene_pool.name.c_str(), scene.name.c_str());
+				continue;
+			}
+
+			auto pool = std::find_if(pools.begin(), pools.end(), [&scene_pool](auto &other) {
+				return other.name == scene_pool.name;
+			});
+			if (pool == pools.end()) {
+				pools.push_back(scene_pool);
+			} else if (pool->type != scene_pool.type) {
+				console.AddLog("[error] Pool '%s' is of '%s', but scene '%s' declares it of '%s'.",
+							   pool->name.c_str(), pool->type.c_str(), scene.name.c_str(),
+							   scene_pool.type.c_str());
+			} else {
+				pool->capacity = std::max(pool->capacity, scene_pool.capacity);
+			}
+		}
+	}
+	return pools;
+}
+
+void generate_object_pool_gen_files(const Project &project, const std::vector<ScenePool> &pools) {
+	std::string pools_path = project.project_settings.project_directory + "/src/scenes/pools.gen";
+	if (pools.empty()) {
+		std::filesystem::remove(pools_path + ".h");
+		std::filesystem::remove(pools_path + ".c");
+		return;
+	}
+
+	std::stringstream includes;
+	std::stringstream declarations;
+	std::stringstream definitions;
+	std::vector<std::string> included_scripts;
+	for (auto &pool : pools) {
+		if (!pool.script_name.empty() &&
+			std::find(included_scripts.begin(), included_scripts.end(), pool.script_name) ==
+				included_scripts.end()) {
+			includes << "#include \"../scripts/" << pool.script_name << ".script.h\"" << std::endl;
+			included_scripts.push_back(pool.script_name);
+		}
+
+		declarations << std::endl
+					 << "// '" << pool.name << "', up to " << pool.capacity << " '" << pool.type
+					 << "'" << std::endl
+					 << "extern ObjectPool " << pool.name << "_pool;" << std::endl
+					 << std::endl
+					 << "static inline " << pool.type << " *" << pool.name << "_alloc(void) {"
+					 << std::endl
+					 << "\treturn (" << pool.type << " *)object_pool_alloc(&" << pool.name
+					 << "_pool);" << std::endl
+					 << "}" << std::endl
+					 << std::endl
+					 << "static inline void " << pool.name << "_free(" << pool.type
+					 << " *item) {" << std::endl
+					 << "\tobject_pool_free(&" << pool.name << "_pool, item);" << std::endl
+					 << "}" << std::endl;
+
+		definitions << "ObjectPool " << pool.name << "_pool;" << std::endl;
+	}
+
+	std::stringstream allocate;
+	std::stringstream release;
+	if (project.project_settings.modules.memory_pool) {
+		allocate << "\treturn mem_zone_alloc(&scene_memory_pool, size);" << std::endl;
+		release << "\t// freed with the rest of 'scene_memory_pool' when the scene changes"
+				<< std::endl;
+	} else {
+		allocate << "\treturn malloc(size);" << std::endl;
+		release << "\tfree(pool->items);" << std::endl
+				<< "\tfree(pool->free_slots);" << std::endl
+				<< "#ifndef NDEBUG" << std::endl
+				<< "\tfree(pool->in_use);" << std::endl
+				<< "#endif" << std::endl;
+	}
+
+	FILE *filestream = fopen((pools_path + ".h").c_str(), "w");
+	fprintf(filestream, object_pool_gen_h, includes.str().c_str(), declarations.str().c_str());
+	fclose(filestream);
+
+	filestream = fopen((pools_path + ".c").c_str(), "w");
+	fprintf(filestream, object_pool_gen_c, definitions.str().c_str(), allocate.str().c_str(),
+			release.str().c_str());
+	fclose(filestream);
+}
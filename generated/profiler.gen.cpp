@@ -0,0 +1,77 @@
+#include "generated.h"
+
+#include <filesystem>
+
+const char *profiler_gen_c = R"(#include "game.gen.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+short profile_scene = -1;
+
+static const char *const profile_names[PROFILE_COUNT] = {
+	"tick", "display", "global_tick", "global_display", "scene_tick", "scene_display",
+};
+static uint32_t profile_ticks[PROFILE_COUNT];
+static uint32_t profile_frames;
+static uint32_t profile_report_start;
+
+void profile_add(ProfileSlot slot, uint32_t start) {
+	profile_ticks[slot] += TICKS_READ() - start;
+}
+
+void profile_frame_end(void) {
+	if (!profile_report_start) {
+		// the first frame also timed the boot, left out of the averages
+		for (int i = 0; i < PROFILE_COUNT; i++)
+			profile_ticks[i] = 0;
+		profile_report_start = TICKS_READ();
+		return;
+	}
+
+	profile_frames++;
+	uint32_t elapsed = TICKS_READ() - profile_report_start;
+	if (elapsed < TICKS_PER_SECOND)
+		return;
+
+	// microseconds per frame, parsed by the editor from the emulator output
+	uint32_t fps = (uint64_t)profile_frames * 100 * TICKS_PER_SECOND / elapsed;
+	fprintf(stderr, "@profile scene=%d fps=%" PRIu32 ".%02" PRIu32, profile_scene, fps / 100,
+			fps % 100);
+	for (int i = 0; i < PROFILE_COUNT; i++) {
+		uint64_t micros = (uint64_t)profile_ticks[i] * 1000000 / TICKS_PER_SECOND;
+		fprintf(stderr, " %s=%" PRIu32, profile_names[i], (uint32_t)(micros / profile_frames));
+		profile_ticks[i] = 0;
+	}
+	fprintf(stderr, "\n");
+
+	profile_frames = 0;
+	profile_report_start = TICKS_READ();
+}
+)";
+
+bool is_profiler_enabled(const ProjectSettings &settings) {
+	return settings.modules.profiler &&
+		   (settings.modules.debug_is_viewer || settings.modules.debug_usb);
+}
+
+std::string get_profiled_call(const std::string &call, const std::string &slot,
+							  const ProjectSettings &settings) {
+	if (!is_profiler_enabled(settings))
+		return "\t" + call + "\n";
+
+	return "\t{\n\t\tuint32_t profile_start = TICKS_READ();\n\t\t" + call + "\n\t\tprofile_add(" +
+		   slot + ", profile_start);\n\t}\n";
+}
+
+void generate_profiler_gen_c(const Project &project) {
+	std::string profiler_path = project.project_settings.project_directory + "/src/profiler.gen.c";
+	if (!is_profiler_enabled(project.project_settings)) {
+		std::filesystem::remove(profiler_path);
+		return;
+	}
+
+	FILE *filestream = fopen(profiler_path.c_str(), "w");
+	fprintf(filestream, "%s", profiler_gen_c);
+	fclose(filestream);
+}
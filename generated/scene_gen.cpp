@@ -1,5 +1,9 @@
 #include "generated.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+
 const char *scene_gen_h = R"(#pragma once
 
 #include <libdragon.h>
@@ -25,8 +29,7 @@ short scene_%d_tick() {
 }
 
 void scene_%d_display(display_context_t disp) {
-	graphics_fill_screen(disp, %u);
-	graphics_set_color(0xfffff, 0);
+%s	graphics_set_color(0xfffff, 0);
 
 	%s
 }
@@ -35,12 +38,73 @@ void scene_%d_destroy() {
 	%s
 })";
 
+const char *scene_preload_gen_c = R"(#include "../game.gen.h"
+
+void *scene_assets[ASSET_COUNT];
+
+void scene_preload(AssetId *ids, int count) {
+	// in filesystem order, so the PI keeps moving forward on the rom
+	for (int i = 1; i < count; i++) {
+		AssetId id = ids[i];
+		int j = i - 1;
+		for (; j >= 0 && asset_table[ids[j]].dfs_offset > asset_table[id].dfs_offset; j--)
+			ids[j + 1] = ids[j];
+		ids[j + 1] = id;
+	}
+
+	for (int i = 0; i < count; i++) {
+%s	}
+}
+
+void scene_preload_release(const AssetId *ids, int count) {
+	for (int i = 0; i < count; i++) {
+%s		scene_assets[ids[i]] = NULL;
+	}
+}
+)";
+
 #include "../Libdragon.h"
 
+static void generate_scene_preload_gen_c(const Project &project) {
+	std::string preload_path = project.project_settings.project_directory +
+							   "/src/scenes/scene_preload.gen.c";
+	if (get_asset_dfs_paths(project).empty()) {
+		std::filesystem::remove(preload_path);
+		return;
+	}
+
+	std::stringstream load;
+	std::stringstream release;
+	if (is_asset_cache_enabled(project)) {
+		load << "\t\tscene_assets[ids[i]] = asset_cache_acquire(ids[i]);" << std::endl;
+		release << "\t\tasset_cache_release(ids[i]);" << std::endl;
+	} else if (project.project_settings.modules.memory_pool) {
+		load << "\t\tscene_assets[ids[i]] =" << std::endl
+			 << "\t\t\tmem_zone_alloc(&scene_memory_pool, (asset_size(ids[i]) + 7) & ~7);"
+			 << std::endl
+			 << "\t\tasset_read(ids[i], scene_assets[ids[i]]);" << std::endl;
+		release << "\t\t// freed all at once when the scene manager resets 'scene_memory_pool'"
+				<< std::endl;
+	} else {
+		load << "\t\tscene_assets[ids[i]] = asset_load(ids[i]);" << std::endl;
+		release << "\t\tfree(scene_assets[ids[i]]);" << std::endl;
+	}
+
+	FILE *filestream = fopen(preload_path.c_str(), "w");
+	fprintf(filestream, scene_preload_gen_c, load.str().c_str(), release.str().c_str());
+	fclose(filestream);
+}
+
 void generate_scene_gen_files(const Project &project) {
 	if (!project.project_settings.modules.scene_manager)
 		return;
 
+	generate_scene_preload_gen_c(project);
+	std::vector<std::string> asset_paths = get_asset_dfs_paths(project);
+
+	std::vector<ScenePool> pools = get_object_pools(project);
+	generate_object_pool_gen_files(project, pools);
+
 	for (auto &scene : project.scenes) {
 		std::string header_name = project.project_settings.project_directory +
 								  "/src/scenes/scene_" + std::to_string(scene.id) + ".gen.h";
@@ -66,13 +130,88 @@ void generate_scene_gen_files(const Project &project) {
 			destroy_method_impl = "script_" + scene.script_name + "_destroy();";
 		}
 
+		// assets removed from the project are skipped
+		std::stringstream preload_ids;
+		int preload_count = 0;
+		for (auto &path : scene.preload_assets) {
+			if (std::find(asset_paths.begin(), asset_paths.end(), path) != asset_paths.end()) {
+				preload_ids << "\t" << get_asset_id(path) << "," << std::endl;
+				++preload_count;
+			}
+		}
+		if (preload_count > 0) {
+			std::string preload_name = "scene_" + std::to_string(scene.id) + "_preload";
+			std::string preload_args = "(" + preload_name + ", " +
+									   std::to_string(preload_count) + ");";
+
+			includes = "#include \"../game.gen.h\"\n" + includes + "\n\nstatic AssetId " +
+					   preload_name + "[" + std::to_string(preload_count) + "] = {\n" +
+					   preload_ids.str() + "};";
+			create_method_impl = "scene_preload" + preload_args + "\n\t" + create_method_impl;
+			destroy_method_impl += "\n\tscene_preload_release" + preload_args;
+		}
+
+		// created before the script and released after it, from the merged declaration
+		std::stringstream pools_create;
+		std::stringstream pools_release;
+		for (auto &scene_pool : scene.pools) {
+			auto pool = std::find_if(pools.begin(), pools.end(), [&scene_pool](auto &other) {
+				return other.name == scene_pool.name && other.type == scene_pool.type;
+			});
+			if (pool == pools.end())
+				continue;
+
+			pools_create << "object_pool_init(&" << pool->name << "_pool, sizeof(" << pool->type
+						 << "), " << scene_pool.capacity << ");\n\t";
+			pools_release << "\n\tobject_pool_release(&" << pool->name << "_pool);";
+		}
+		if (!pools_create.str().empty()) {
+			includes = "#include \"pools.gen.h\"\n" + includes;
+			create_method_impl = pools_create.str() + create_method_impl;
+			destroy_method_impl += pools_release.str();
+		}
+
 		unsigned int fill_color = Libdragon::GetColor3(&scene.fill_color[0],
 													   project.project_settings.display.bit_depth);
 
+		std::stringstream clear_screen_impl;
+		if (scene.clear_screen && project.project_settings.modules.rdp) {
+			// the RDP fills the framebuffer much faster than the CPU loop of 'graphics_fill_screen'
+			clear_screen_impl << "\trdp_attach_display(disp);" << std::endl
+							  << "\trdp_set_default_clipping();" << std::endl
+							  << "\trdp_enable_primitive_fill();" << std::endl
+							  << "\trdp_set_primitive_color(" << fill_color << ");" << std::endl
+							  << "\trdp_draw_filled_rectangle(0, 0, display_get_width(), "
+							  << "display_get_height());" << std::endl
+							  << "\trdp_detach_display();" << std::endl;
+		} else if (scene.clear_screen) {
+			clear_screen_impl << "\tgraphics_fill_screen(disp, " << fill_color << ");" << std::endl;
+		}
+
+		// the scene functions timed on their own, 'profile_scene' tags the reports
+		if (is_profiler_enabled(project.project_settings)) {
+			if (preload_count == 0)
+				includes = "#include \"../game.gen.h\"\n" + includes;
+			create_method_impl =
+				"profile_scene = " + std::to_string(scene.id) + ";\n\t" + create_method_impl;
+			if (!scene.script_name.empty()) {
+				tick_method_impl =
+					"uint32_t profile_start = TICKS_READ();\n\tshort result = script_" +
+					scene.script_name + "_tick();\n\tprofile_add(PROFILE_SCENE_TICK, " +
+					"profile_start);\n\tif (result >= 0) return result;";
+			}
+			std::string clear_screen_text = clear_screen_impl.str();
+			clear_screen_impl.str("");
+			clear_screen_impl << "\tuint32_t profile_start = TICKS_READ();" << std::endl
+							  << clear_screen_text;
+			display_method_impl += "\n\tprofile_add(PROFILE_SCENE_DISPLAY, profile_start);";
+		}
+
 		filestream = fopen(c_name.c_str(), "w");
 		fprintf(filestream, scene_gen_c, scene.id, includes.c_str(), scene.id,
 				create_method_impl.c_str(), scene.id, tick_method_impl.c_str(), scene.id, scene.id,
-				fill_color, display_method_impl.c_str(), scene.id, destroy_method_impl.c_str());
+				clear_screen_impl.str().c_str(), display_method_impl.c_str(), scene.id,
+				destroy_method_impl.c_str());
 		fclose(filestream);
 	}
 }
\ No newline at end of file
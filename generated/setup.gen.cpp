@@ -14,18 +14,47 @@ void setup() {
 %s
 %s}
 
-void tick() {
 %s
-%s}
-
 void display() {
 %s})";
 
-void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
+const char *fixed_step_tick_gen_c = R"(// the game logic, run once per elapsed step
+static void fixed_step() {
+%s
+%s}
+
+void tick() {
+%s
+	long long now = timer_ticks();
+	if (!fixed_step_last_ticks)
+		fixed_step_last_ticks = now - FIXED_STEP_TICKS;
+	fixed_step_accumulator += now - fixed_step_last_ticks;
+	fixed_step_last_ticks = now;
+
+	int steps = 0;
+	while (fixed_step_accumulator >= FIXED_STEP_TICKS && steps < %d) {
+		fixed_step();
+		fixed_step_accumulator -= FIXED_STEP_TICKS;
+		steps++;
+	}
+	// too far behind to catch up, drop the time left instead of slowing down further
+	if (fixed_step_accumulator >= FIXED_STEP_TICKS)
+		fixed_step_accumulator %%= FIXED_STEP_TICKS;
+
+	fixed_step_alpha = (float)fixed_step_accumulator / FIXED_STEP_TICKS;
+%s%s}
+)";
+
+void generate_setup_gen_c(std::string &setup_path, const Project &project) {
+	const ProjectSettings &settings = project.project_settings;
+
 	std::stringstream setup_body;
 	std::stringstream setup_end_body;
 	std::stringstream tick_body;
 	std::stringstream tick_end_body;
+	// once per frame even with a fixed timestep
+	std::stringstream frame_body;
+	std::stringstream frame_end_body;
 	std::stringstream display_body;
 	std::stringstream includes;
 	std::stringstream variables;
@@ -38,8 +67,11 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 
 		display_body << "\tstatic display_context_t disp = 0;" << std::endl
 					 << "\twhile (!(disp = display_lock()))" << std::endl
-					 << "\t\t;" << std::endl
-					 << std::endl;
+					 << "\t\t;" << std::endl;
+		// from here, the wait for a free buffer is not part of the frame time
+		if (is_profiler_enabled(settings))
+			display_body << "\tuint32_t profile_display_start = TICKS_READ();" << std::endl;
+		display_body << std::endl;
 	}
 	if (settings.modules.memory_pool) {
 		variables << "MemZone global_memory_pool;" << std::endl
@@ -49,6 +81,25 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 					   << settings.global_mem_alloc_size * 1024 << ");" << std::endl
 					   << "\tmem_zone_init(&scene_memory_pool, "
 					   << settings.scene_mem_alloc_size * 1024 << ");" << std::endl;
+
+		if (settings.frame_mem_alloc_size > 0) {
+			variables << "MemZone frame_memory_pool;" << std::endl
+					  << "#ifndef NDEBUG" << std::endl
+					  << "size_t frame_memory_used;" << std::endl
+					  << "size_t frame_memory_peak;" << std::endl
+					  << "#endif" << std::endl;
+
+			setup_end_body << "\tmem_zone_init(&frame_memory_pool, "
+						   << settings.frame_mem_alloc_size * 1024 << ");" << std::endl;
+
+			// first thing of the frame, allocations stay valid until the next 'display' ends
+			frame_body << "#ifndef NDEBUG" << std::endl
+					   << "\tif (frame_memory_used > frame_memory_peak)" << std::endl
+					   << "\t\tframe_memory_peak = frame_memory_used;" << std::endl
+					   << "\tframe_memory_used = 0;" << std::endl
+					   << "#endif" << std::endl
+					   << "\tmem_zone_free_all(&frame_memory_pool);" << std::endl;
+		}
 	}
 	if (settings.modules.scene_manager) {
 		variables << "SceneManager *scene_manager;" << std::endl;
@@ -74,6 +125,10 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 	if (settings.modules.dfs) {
 		setup_body << "\tdfs_init(DFS_DEFAULT_LOCATION);" << std::endl;
 	}
+	if (is_asset_stream_enabled(project)) {
+		// before the scripts, so the completed reads are ready on their tick
+		frame_body << "\tasset_stream_tick();" << std::endl;
+	}
 	if (settings.modules.rdp) {
 		setup_body << "\trdp_init();" << std::endl;
 	}
@@ -102,11 +157,11 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 	if (settings.modules.audio_mixer) {
 		setup_body << "\tmixer_init(" << settings.audio_mixer.channels << ");" << std::endl;
 
-		tick_end_body << "\tif (audio_can_write()) {" << std::endl
-					  << "\t\tshort *buf = audio_write_begin();" << std::endl
-					  << "\t\tmixer_poll(buf, audio_get_buffer_length());" << std::endl
-					  << "\t\taudio_write_end();" << std::endl
-					  << "\t}" << std::endl;
+		frame_end_body << "\tif (audio_can_write()) {" << std::endl
+					   << "\t\tshort *buf = audio_write_begin();" << std::endl
+					   << "\t\tmixer_poll(buf, audio_get_buffer_length());" << std::endl
+					   << "\t\taudio_write_end();" << std::endl
+					   << "\t}" << std::endl;
 	}
 	if (settings.modules.debug_is_viewer) {
 		setup_body << "\tdebug_init_isviewer();" << std::endl;
@@ -119,11 +174,13 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 	if (!settings.global_script_name.empty()) {
 		setup_end_body << "\tscript_" << settings.global_script_name << "_create();" << std::endl;
 
-		tick_body << "\tscript_" << settings.global_script_name << "_tick();" << std::endl;
+		tick_body << get_profiled_call("script_" + settings.global_script_name + "_tick();",
+									   "PROFILE_GLOBAL_TICK", settings);
 
 		if (settings.modules.display) {
-			display_body << "\tscript_" << settings.global_script_name << "_display(disp);"
-						 << std::endl;
+			display_body << get_profiled_call(
+				"script_" + settings.global_script_name + "_display(disp);",
+				"PROFILE_GLOBAL_DISPLAY", settings);
 		}
 
 		includes << "#include \"scripts/" << settings.global_script_name << ".script.h\""
@@ -131,6 +188,12 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 	}
 
 	if (settings.modules.display) {
+		// everything the scripts queued, drawn on top of the frame
+		if (is_sprite_batch_enabled(settings))
+			display_body << "\tsprite_batch_flush(disp);" << std::endl;
+
+		if (is_profiler_enabled(settings))
+			display_body << "\tprofile_add(PROFILE_DISPLAY, profile_display_start);" << std::endl;
 		display_body << "\tdisplay_show(disp);" << std::endl;
 	}
 
@@ -162,9 +225,58 @@ void generate_setup_gen_c(std::string &setup_path, ProjectSettings &settings) {
 				   << menu_background_color << ");" << std::endl;
 	}
 
+	if (is_profiler_enabled(settings)) {
+		std::string frame_text = frame_body.str();
+		frame_body.str("");
+		frame_body << "\tuint32_t profile_tick_start = TICKS_READ();" << std::endl << frame_text;
+
+		// sends the averages once a second
+		frame_end_body << "\tprofile_add(PROFILE_TICK, profile_tick_start);" << std::endl
+					   << "\tprofile_frame_end();" << std::endl;
+	}
+
+	std::string tick_functions;
+	if (settings.modules.timer && settings.timestep.fixed) {
+		const TimestepSettings &timestep = settings.timestep;
+		variables << "float fixed_step_alpha;" << std::endl
+				  << "static long long fixed_step_last_ticks;" << std::endl
+				  << "static long long fixed_step_accumulator;" << std::endl;
+
+		std::stringstream skip_display;
+		if (timestep.frame_skip && settings.modules.display) {
+			variables << "static bool fixed_step_skip_display;" << std::endl;
+
+			// a late frame ran more than one step, drawing it would make the next one late too
+			skip_display << std::endl
+						 << "\tfixed_step_skip_display = steps > 1 && !fixed_step_skip_display;"
+						 << std::endl;
+
+			std::string display_text = display_body.str();
+			display_body.str("");
+			display_body << "\tif (fixed_step_skip_display)" << std::endl
+						 << "\t\treturn;" << std::endl
+						 << std::endl
+						 << display_text;
+		}
+
+		int size = snprintf(nullptr, 0, fixed_step_tick_gen_c, tick_body.str().c_str(),
+							tick_end_body.str().c_str(), frame_body.str().c_str(),
+							timestep.max_catch_up_steps, skip_display.str().c_str(),
+							frame_end_body.str().c_str());
+		tick_functions.resize(size + 1);
+		snprintf(tick_functions.data(), size + 1, fixed_step_tick_gen_c,
+				 tick_body.str().c_str(), tick_end_body.str().c_str(),
+				 frame_body.str().c_str(), timestep.max_catch_up_steps,
+				 skip_display.str().c_str(), frame_end_body.str().c_str());
+		tick_functions.resize(size);
+	} else {
+		tick_functions = "void tick() {\n" + frame_body.str() + tick_body.str() + "\n" +
+						 tick_end_body.str() + frame_end_body.str() + "}\n";
+	}
+
 	FILE *filestream = fopen(setup_path.c_str(), "w");
 	fprintf(filestream, setup_gen_c, includes.str().c_str(), variables.str().c_str(),
-			setup_body.str().c_str(), setup_end_body.str().c_str(), tick_body.str().c_str(),
-			tick_end_body.str().c_str(), display_body.str().c_str());
+			setup_body.str().c_str(), setup_end_body.str().c_str(), tick_functions.c_str(),
+			display_body.str().c_str());
 	fclose(filestream);
 }
\ No newline at end of file
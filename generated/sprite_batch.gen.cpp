@@ -0,0 +1,112 @@
+#include "generated.h"
+
+#include <filesystem>
+
+const char *sprite_batch_gen_c =
+	R"(#include "game.gen.h"
+
+#include <stdlib.h>
+
+#define SPRITE_BATCH_SIZE %d
+// bytes of TMEM a loaded frame can take
+#define SPRITE_BATCH_TMEM_SIZE 4096
+
+typedef struct {
+	sprite_t *sprite;
+	int16_t x, y;
+	uint16_t frame;
+	uint8_t layer;
+	// queue position, keeps the draw order inside a texture as 'qsort' is not stable
+	uint16_t order;
+} SpriteBatchDraw;
+
+static SpriteBatchDraw sprite_batch[SPRITE_BATCH_SIZE];
+static int sprite_batch_count;
+
+#ifndef NDEBUG
+int sprite_batch_texture_loads;
+#endif
+
+void sprite_batch_draw(sprite_t *sprite, int frame, int x, int y, int layer) {
+	assertf(sprite_batch_count < SPRITE_BATCH_SIZE, "the sprite batch is full, %%d draws at most",
+			SPRITE_BATCH_SIZE);
+	if (sprite_batch_count == SPRITE_BATCH_SIZE)
+		return;
+	// the whole frame is loaded at once, rows padded to 8 bytes, so big sheets (like the atlases)
+	// can't be batched
+	assertf(((sprite->width / sprite->hslices * sprite->bitdepth + 7) & ~7) *
+					(sprite->height / sprite->vslices) <=
+				SPRITE_BATCH_TMEM_SIZE,
+			"a frame of %%dx%%d does not fit in TMEM", sprite->width / sprite->hslices,
+			sprite->height / sprite->vslices);
+
+	sprite_batch[sprite_batch_count] =
+		(SpriteBatchDraw){sprite, x, y, frame, layer, sprite_batch_count};
+	sprite_batch_count++;
+}
+
+static int sprite_batch_compare(const void *a, const void *b) {
+	const SpriteBatchDraw *left = a;
+	const SpriteBatchDraw *right = b;
+	if (left->layer != right->layer)
+		return left->layer - right->layer;
+	if (left->sprite != right->sprite)
+		return left->sprite < right->sprite ? -1 : 1;
+	if (left->frame != right->frame)
+		return left->frame - right->frame;
+	return left->order - right->order;
+}
+
+void sprite_batch_flush(display_context_t disp) {
+#ifndef NDEBUG
+	sprite_batch_texture_loads = 0;
+#endif
+	if (!sprite_batch_count)
+		return;
+
+	qsort(sprite_batch, sprite_batch_count, sizeof(SpriteBatchDraw), sprite_batch_compare);
+
+	rdp_attach_display(disp);
+	rdp_set_default_clipping();
+	rdp_enable_texture_copy();
+
+	sprite_t *loaded_sprite = NULL;
+	int loaded_frame = -1;
+	for (int i = 0; i < sprite_batch_count; i++) {
+		SpriteBatchDraw *draw = &sprite_batch[i];
+		// a single load for every run of draws of the same frame
+		if (draw->sprite != loaded_sprite || draw->frame != loaded_frame) {
+			rdp_sync(SYNC_PIPE);
+			rdp_load_texture_stride(0, 0, MIRROR_DISABLED, draw->sprite, draw->frame);
+			loaded_sprite = draw->sprite;
+			loaded_frame = draw->frame;
+#ifndef NDEBUG
+			sprite_batch_texture_loads++;
+#endif
+		}
+		rdp_draw_sprite(0, draw->x, draw->y, MIRROR_DISABLED);
+	}
+
+	rdp_detach_display();
+	sprite_batch_count = 0;
+}
+)";
+
+bool is_sprite_batch_enabled(const ProjectSettings &settings) {
+	// the flush draws in copy mode, which the RDP only supports on 16 bit framebuffers
+	return settings.modules.sprite_batch && settings.modules.display && settings.modules.rdp &&
+		   settings.display.bit_depth == DEPTH_16_BPP;
+}
+
+void generate_sprite_batch_gen_c(const Project &project) {
+	std::string batch_path =
+		project.project_settings.project_directory + "/src/sprite_batch.gen.c";
+	if (!is_sprite_batch_enabled(project.project_settings)) {
+		std::filesystem::remove(batch_path);
+		return;
+	}
+
+	FILE *filestream = fopen(batch_path.c_str(), "w");
+	fprintf(filestream, sprite_batch_gen_c, project.project_settings.sprite_batch_size);
+	fclose(filestream);
+}
@@ -1,5 +1,7 @@
 #include "imgui_custom.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <string>
 
 #include "../App.h"
@@ -69,3 +71,59 @@ void separator_light() {
 	ImGui::Separator();
 	ImGui::PopStyleColor();
 }
+
+void render_slices_overlay(int h_slices, int v_slices) {
+	if (h_slices < 1 || v_slices < 1)
+		return;
+
+	const ImU32 grid_color = IM_COL32(0, 255, 0, 255);
+	const ImU32 selection_color = IM_COL32(255, 255, 0, 255);
+	const ImU32 text_color = IM_COL32(255, 255, 255, 220);
+	const ImU32 text_shadow_color = IM_COL32(0, 0, 0, 220);
+
+	ImDrawList *draw_list = ImGui::GetWindowDrawList();
+	ImVec2 min = ImGui::GetItemRectMin();
+	ImVec2 max = ImGui::GetItemRectMax();
+
+	float slice_width = (max.x - min.x) / (float)h_slices;
+	float slice_height = (max.y - min.y) / (float)v_slices;
+
+	for (int h = 1; h < h_slices; ++h) {
+		float x = min.x + slice_width * (float)h;
+		draw_list->AddLine(ImVec2(x, min.y), ImVec2(x, max.y), grid_color);
+	}
+	for (int v = 1; v < v_slices; ++v) {
+		float y = min.y + slice_height * (float)v;
+		draw_list->AddLine(ImVec2(min.x, y), ImVec2(max.x, y), grid_color);
+	}
+	draw_list->AddRect(min, max, grid_color);
+
+	// frames are numbered left to right, top to bottom, same as on the console
+	const float font_size = ImGui::GetFontSize();
+	if (slice_height >= font_size + 2.f) {
+		char frame_text[16];
+		for (int v = 0; v < v_slices; ++v) {
+			for (int h = 0; h < h_slices; ++h) {
+				snprintf(frame_text, sizeof(frame_text), "%d", v * h_slices + h);
+				if (ImGui::CalcTextSize(frame_text).x + 4.f > slice_width)
+					continue;
+
+				ImVec2 position(min.x + slice_width * (float)h + 2.f,
+								min.y + slice_height * (float)v + 1.f);
+				draw_list->AddText(ImVec2(position.x + 1.f, position.y + 1.f), text_shadow_color,
+								   frame_text);
+				draw_list->AddText(position, text_color, frame_text);
+			}
+		}
+	}
+
+	if (ImGui::IsMouseHoveringRect(min, max)) {
+		ImVec2 mouse = ImGui::GetMousePos();
+		int h = std::min((int)((mouse.x - min.x) / slice_width), h_slices - 1);
+		int v = std::min((int)((mouse.y - min.y) / slice_height), v_slices - 1);
+
+		ImVec2 slice_min(min.x + slice_width * (float)h, min.y + slice_height * (float)v);
+		draw_list->AddRect(slice_min, ImVec2(slice_min.x + slice_width, slice_min.y + slice_height),
+						   selection_color, 0.f, 0, 2.f);
+	}
+}
@@ -12,4 +12,10 @@ bool link_button(const char *label, const char *url = nullptr);
  */
 bool input_text_dfs_folder(char* buf, int buf_size);
 
-void separator_light();
\ No newline at end of file
+void separator_light();
+
+/**
+ * Draws the slice grid of a sprite over the last item (usually the sprite image), with the frame
+ * number on each slice when it fits. The slice under the mouse is framed.
+ */
+void render_slices_overlay(int h_slices, int v_slices);
\ No newline at end of file
@@ -16,6 +16,11 @@ ConsoleApp console;
 
 App *g_app;
 
+// keep drawing for a while after anything happens so hover delays and animations can settle
+const Uint32 active_time = 1000;
+// while idle, wake up from time to time to pick up asset changes
+const int idle_wait_time = 250;
+
 std::string GetExeDirectory() {
 #ifdef _WIN32
 	wchar_t szPath[MAX_PATH];
@@ -43,9 +48,21 @@ int main(int argv, char **args) {
 
 	AppGui::ChangeTheme(app, app.engine_settings.GetTheme());
 
+	Uint32 last_activity = SDL_GetTicks();
 	while (app.is_running) {
+		// Commands wake the loop up when they log or finish, so a long one (like the emulator)
+		// doesn't keep it busy. A capture needs every frame until it ends, it is only saved from
+		// 'EndFrame'.
+		bool is_idle = SDL_GetTicks() - last_activity > active_time &&
+					   app.audio_preview.GetState() != SS_PLAYING && !app.stats.IsCapturing();
+
+		bool woke_up = false;
+
 		SDL_Event event;
-		while (SDL_PollEvent(&event)) {
+		bool has_event = Sdl::NextEvent(&event, is_idle ? idle_wait_time : 0);
+		while (has_event) {
+			woke_up = true;
+
 			Sdl::ProcessEvent(&event);
 
 			switch (event.type) {
@@ -69,20 +86,41 @@ int main(int argv, char **args) {
 				default:
 					break;
 			}
+
+			has_event = SDL_PollEvent(&event);
 		}
 
 		if (!app.is_running)
 			break;
 
+		app.asset_watcher.Update(&app);
+		app.textures.Update(app);
+
+		if (woke_up)
+			last_activity = SDL_GetTicks();
+		else if (is_idle)
+			continue;
+
+		app.stats.BeginFrame();
+
 		Sdl::NewFrame();
 
 		AppGui::Update(app);
 
+		app.stats.EndSection(STATS_UPDATE);
+
 		Sdl::RenderStart(app.renderer);
 
 		// render SDL stuff here
 
 		Sdl::RenderEnd(app.renderer);
+
+		app.stats.EndSection(STATS_RENDER);
+
+		Sdl::Present(app.renderer);
+
+		app.stats.EndSection(STATS_PRESENT);
+		app.stats.EndFrame();
 	}
 
 	app.project.Close(&app);
@@ -1,4 +1,9 @@
 #include "AudioSettings.h"
 
-AudioSettings::AudioSettings() : frequency(44100), buffers(4) {
+AudioSettings::AudioSettings()
+	: frequency(44100),
+	  buffers(4),
+	  resample_sounds(false),
+	  mono_sounds(false),
+	  sound_bit_depth(16) {
 }
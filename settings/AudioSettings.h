@@ -5,5 +5,10 @@ class AudioSettings {
 	int frequency;
 	int buffers;
 
+	// defaults applied to wave sounds before 'audioconv64', sounds can override them
+	bool resample_sounds;
+	bool mono_sounds;
+	int sound_bit_depth;
+
 	AudioSettings();
 };
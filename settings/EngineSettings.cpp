@@ -19,6 +19,7 @@ EngineSettings::EngineSettings()
 	  libdragon_exe_location(),
 	  libdragon_use_bundled(true),
 	  theme(THEME_DARK),
+	  texture_budget(256),
 	  engine_settings_folder(),
 	  engine_settings_filepath() {
 #ifdef WIN32
@@ -46,6 +47,7 @@ void EngineSettings::SaveToDisk() {
 				{"libdragon_exe_location", libdragon_exe_location},
 				{"libdragon_use_bundled", libdragon_use_bundled},
 				{"theme", theme},
+				{"texture_budget", texture_budget},
 			},
 		},
 	};
@@ -99,6 +101,8 @@ void EngineSettings::LoadFromDisk(const App *app, const std::string &path) {
 
 	if (!json["engine"]["libdragon_use_bundled"].is_null())
 		libdragon_use_bundled = json["engine"]["libdragon_use_bundled"];
+	if (!json["engine"]["texture_budget"].is_null())
+		texture_budget = json["engine"]["texture_budget"];
 
 	if (last_opened_project.empty()) {
 		last_opened_project = ".";
@@ -135,6 +139,12 @@ void EngineSettings::SetTheme(Theme theme_id) {
 	SaveToDisk();
 }
 
+void EngineSettings::SetTextureBudget(int budget_mb) {
+	texture_budget = budget_mb;
+
+	SaveToDisk();
+}
+
 void EngineSettings::SetLibdragonExeLocation(const App *app, bool use_bundled, std::string path) {
 	libdragon_exe_location = std::move(path);
 	libdragon_use_bundled = use_bundled;
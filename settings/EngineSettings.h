@@ -43,6 +43,12 @@ class EngineSettings {
 		return libdragon_exe_location;
 	};
 
+	// memory used by full resolution sprite and font previews, in MB
+	void SetTextureBudget(int budget_mb);
+	[[nodiscard]] int GetTextureBudget() const {
+		return texture_budget;
+	};
+
 	[[nodiscard]] std::string GetEngineSettingsFilepath() const {
 		return engine_settings_filepath;
 	};
@@ -68,6 +74,7 @@ class EngineSettings {
 	std::string libdragon_exe_location;
 	bool libdragon_use_bundled;
 	Theme theme;
+	int texture_budget;
 
 	std::string engine_settings_folder;
 	std::string engine_settings_filepath;
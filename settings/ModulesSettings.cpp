@@ -13,6 +13,10 @@ ModulesSettings::ModulesSettings()
 	  scene_manager(true),
 	  memory_pool(true),
 	  menu(false),
+	  asset_cache(false),
+	  asset_stream(false),
+	  sprite_batch(false),
+	  profiler(false),
 	  debug_is_viewer(true),
 	  debug_usb(false) {
 }
@@ -16,6 +16,11 @@ class ModulesSettings {
 	bool memory_pool;
 	bool menu;
 
+	bool asset_cache;
+	bool asset_stream;
+	bool sprite_batch;
+	bool profiler;
+
 	bool debug_is_viewer;
 	bool debug_usb;
 
@@ -21,7 +21,19 @@ void Project::SaveToDisk(const std::string &project_directory) {
 		json["id"] = scene.id;
 		json["name"] = scene.name;
 		json["fill_color"] = scene.fill_color;
+		json["clear_screen"] = scene.clear_screen;
 		json["script_name"] = scene.script_name;
+		json["preload_assets"] = scene.preload_assets;
+
+		json["pools"] = nlohmann::json::array();
+		for (auto &pool : scene.pools) {
+			nlohmann::json pool_json;
+			pool_json["name"] = pool.name;
+			pool_json["type"] = pool.type;
+			pool_json["script_name"] = pool.script_name;
+			pool_json["capacity"] = pool.capacity;
+			json["pools"].push_back(pool_json);
+		}
 
 		std::ofstream file(project_directory + "/.ngine/scenes/" + std::to_string(scene.id) +
 						   ".scene.json");
@@ -56,6 +68,21 @@ void Project::LoadFromDisk(const std::string &project_directory) {
 				scene.fill_color[0] = json["fill_color"][0];
 				scene.fill_color[1] = json["fill_color"][1];
 				scene.fill_color[2] = json["fill_color"][2];
+				if (!json["clear_screen"].is_null())
+					scene.clear_screen = json["clear_screen"];
+
+				if (!json["preload_assets"].is_null())
+					json["preload_assets"].get_to(scene.preload_assets);
+				if (!json["pools"].is_null()) {
+					for (auto &pool_json : json["pools"]) {
+						ScenePool pool;
+						pool.name = pool_json["name"];
+						pool.type = pool_json["type"];
+						pool.script_name = pool_json["script_name"];
+						pool.capacity = pool_json["capacity"];
+						scene.pools.push_back(pool);
+					}
+				}
 
 				scenes.push_back(scene);
 			}
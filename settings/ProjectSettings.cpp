@@ -16,6 +16,10 @@ ProjectSettings::ProjectSettings(App *app)
 	  initial_scene_id(0),
 	  global_mem_alloc_size(1024),
 	  scene_mem_alloc_size(1024 * 2),
+	  frame_mem_alloc_size(64),
+	  asset_cache_size(512),
+	  asset_stream_chunk_size(32),
+	  sprite_batch_size(256),
 	  libdragon_branch("trunk"),
 	  ngine_version_major(app->engine_version.major),
 	  ngine_version_minor(app->engine_version.minor),
@@ -46,6 +50,8 @@ bool ProjectSettings::LoadFromFile(App *app, const std::string &folder) {
 
 	global_mem_alloc_size = json["project"]["global_mem_alloc_size"];
 	scene_mem_alloc_size = json["project"]["scene_mem_alloc_size"];
+	if (!json["project"]["frame_mem_alloc_size"].is_null())
+		frame_mem_alloc_size = json["project"]["frame_mem_alloc_size"];
 	initial_scene_id = json["project"]["initial_screen_id"];
 
 	audio.buffers = json["audio"]["buffers"];
@@ -81,6 +87,27 @@ bool ProjectSettings::LoadFromFile(App *app, const std::string &folder) {
 
 	if (!json["modules"]["rtc"].is_null())
 		modules.rtc = json["modules"]["rtc"];
+	if (!json["modules"]["asset_cache"].is_null())
+		modules.asset_cache = json["modules"]["asset_cache"];
+	if (!json["project"]["asset_cache_size"].is_null())
+		asset_cache_size = json["project"]["asset_cache_size"];
+	if (!json["modules"]["asset_stream"].is_null())
+		modules.asset_stream = json["modules"]["asset_stream"];
+	if (!json["project"]["asset_stream_chunk_size"].is_null())
+		asset_stream_chunk_size = json["project"]["asset_stream_chunk_size"];
+	if (!json["modules"]["sprite_batch"].is_null())
+		modules.sprite_batch = json["modules"]["sprite_batch"];
+	if (!json["project"]["sprite_batch_size"].is_null())
+		sprite_batch_size = json["project"]["sprite_batch_size"];
+	if (!json["modules"]["profiler"].is_null())
+		modules.profiler = json["modules"]["profiler"];
+
+	if (!json["audio"]["resample_sounds"].is_null())
+		audio.resample_sounds = json["audio"]["resample_sounds"];
+	if (!json["audio"]["mono_sounds"].is_null())
+		audio.mono_sounds = json["audio"]["mono_sounds"];
+	if (!json["audio"]["sound_bit_depth"].is_null())
+		audio.sound_bit_depth = json["audio"]["sound_bit_depth"];
 
 	if (!json["menu"]["text_selected_color"].is_null())
 		json["menu"]["text_selected_color"].get_to(menu.text_selected_color);
@@ -95,6 +122,15 @@ bool ProjectSettings::LoadFromFile(App *app, const std::string &folder) {
 	if (!json["menu"]["menu_background_color"].is_null())
 		json["menu"]["menu_background_color"].get_to(menu.menu_background_color);
 
+	if (!json["timestep"]["fixed"].is_null())
+		timestep.fixed = json["timestep"]["fixed"];
+	if (!json["timestep"]["logic_hz"].is_null())
+		timestep.logic_hz = json["timestep"]["logic_hz"];
+	if (!json["timestep"]["max_catch_up_steps"].is_null())
+		timestep.max_catch_up_steps = json["timestep"]["max_catch_up_steps"];
+	if (!json["timestep"]["frame_skip"].is_null())
+		timestep.frame_skip = json["timestep"]["frame_skip"];
+
 	if (!json["project"]["ngine"]["version"]["major"].is_null())
 		ngine_version_major = json["project"]["ngine"]["version"]["major"];
 	if (!json["project"]["ngine"]["version"]["minor"].is_null())
@@ -129,6 +165,10 @@ void ProjectSettings::SaveToDisk() {
 	json["project"]["region_free"] = region_free;
 	json["project"]["global_mem_alloc_size"] = global_mem_alloc_size;
 	json["project"]["scene_mem_alloc_size"] = scene_mem_alloc_size;
+	json["project"]["frame_mem_alloc_size"] = frame_mem_alloc_size;
+	json["project"]["asset_cache_size"] = asset_cache_size;
+	json["project"]["asset_stream_chunk_size"] = asset_stream_chunk_size;
+	json["project"]["sprite_batch_size"] = sprite_batch_size;
 	json["project"]["initial_screen_id"] = initial_scene_id;
 	json["project"]["global_script_name"] = global_script_name;
 	json["project"]["ngine"]["version"]["major"] = ngine_version_major;
@@ -138,9 +178,17 @@ void ProjectSettings::SaveToDisk() {
 
 	json["audio"]["buffers"] = audio.buffers;
 	json["audio"]["frequency"] = audio.frequency;
+	json["audio"]["resample_sounds"] = audio.resample_sounds;
+	json["audio"]["mono_sounds"] = audio.mono_sounds;
+	json["audio"]["sound_bit_depth"] = audio.sound_bit_depth;
 
 	json["audio_mixer"]["channels"] = audio_mixer.channels;
 
+	json["timestep"]["fixed"] = timestep.fixed;
+	json["timestep"]["logic_hz"] = timestep.logic_hz;
+	json["timestep"]["max_catch_up_steps"] = timestep.max_catch_up_steps;
+	json["timestep"]["frame_skip"] = timestep.frame_skip;
+
 	json["display"]["resolution"] = display.GetResolution();
 	json["display"]["bit_depth"] = display.GetBitDepth();
 	json["display"]["buffers"] = display.buffers;
@@ -149,6 +197,9 @@ void ProjectSettings::SaveToDisk() {
 
 	json["modules"]["audio"] = modules.audio;
 	json["modules"]["audio_mixer"] = modules.audio_mixer;
+	json["modules"]["asset_cache"] = modules.asset_cache;
+	json["modules"]["asset_stream"] = modules.asset_stream;
+	json["modules"]["sprite_batch"] = modules.sprite_batch;
 	json["modules"]["console"] = modules.console;
 	json["modules"]["controller"] = modules.controller;
 	json["modules"]["debug_usb"] = modules.debug_usb;
@@ -157,6 +208,7 @@ void ProjectSettings::SaveToDisk() {
 	json["modules"]["display"] = modules.display;
 	json["modules"]["memory_pool"] = modules.memory_pool;
 	json["modules"]["menu"] = modules.menu;
+	json["modules"]["profiler"] = modules.profiler;
 	json["modules"]["rdp"] = modules.rdp;
 	json["modules"]["rtc"] = modules.rtc;
 	json["modules"]["scene_manager"] = modules.scene_manager;
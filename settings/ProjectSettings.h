@@ -7,6 +7,7 @@
 #include "DisplaySettings.h"
 #include "MenuSettings.h"
 #include "ModulesSettings.h"
+#include "TimestepSettings.h"
 
 class App;
 
@@ -27,12 +28,18 @@ class ProjectSettings {
 
 	int global_mem_alloc_size;
 	int scene_mem_alloc_size;
+	// reset every frame, 0 leaves it out
+	int frame_mem_alloc_size;
+	int asset_cache_size;
+	int asset_stream_chunk_size;
+	int sprite_batch_size;
 
 	AudioSettings audio;
 	AudioMixerSettings audio_mixer;
 	DisplaySettings display;
 	ModulesSettings modules;
 	MenuSettings menu;
+	TimestepSettings timestep;
 
 	std::string libdragon_branch;
 
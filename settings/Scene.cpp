@@ -1,6 +1,6 @@
 #include "Scene.h"
 
-Scene::Scene() : id (0), fill_color() {
+Scene::Scene() : id (0), fill_color(), clear_screen(true) {
 	fill_color[0] = 0;
 	fill_color[1] = 0;
 	fill_color[2] = 0;
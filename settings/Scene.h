@@ -1,6 +1,16 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+// Fixed-size pool of a struct declared on a script header, see 'object_pool.gen.cpp'. Pools with
+// the same name on different scenes are the same pool, as only one scene is alive at a time.
+struct ScenePool {
+	std::string name;
+	std::string type;
+	std::string script_name;
+	int capacity;
+};
 
 class Scene {
    public:
@@ -10,6 +20,13 @@ class Scene {
 	std::string script_name;
 
 	float fill_color[3];
+	// scenes that draw over the whole screen can skip clearing it
+	bool clear_screen;
+
+	// filesystem paths of the assets loaded on 'scene_N_create', see 'get_asset_dfs_paths'
+	std::vector<std::string> preload_assets;
+
+	std::vector<ScenePool> pools;
 
 	Scene();
 };
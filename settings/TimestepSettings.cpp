@@ -0,0 +1,5 @@
+#include "TimestepSettings.h"
+
+TimestepSettings::TimestepSettings()
+	: fixed(false), logic_hz(60), max_catch_up_steps(4), frame_skip(false) {
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+class TimestepSettings {
+   public:
+	// runs the game logic at 'logic_hz' no matter how long drawing takes, needs the timer
+	bool fixed;
+	int logic_hz;
+	// logic steps allowed in a single frame to catch up, the time left after that is dropped
+	int max_catch_up_steps;
+	// skips 'display' on frames that are behind (never two in a row)
+	bool frame_skip;
+
+	TimestepSettings();
+};
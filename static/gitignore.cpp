@@ -7,6 +7,8 @@ const char *gitignore =
 
 build/
 build.log
+rom_size_report.json
+code_size_report.json
 
 *.v64
 *.z64